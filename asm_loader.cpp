@@ -1,4 +1,5 @@
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <map>
 #include <sstream>
@@ -20,6 +21,14 @@ void parsePOP(const std::vector<std::string>&, Memory&, u16&);
 void parsePOPW(const std::vector<std::string>&, Memory&, u16&);
 void parseBitShifts(const std::vector<std::string>&, Memory&, u16&, bool, bool);
 
+// MOD bytes of the jmp/jcc family
+static const std::map<std::string, u8> JMP_MODS = {
+    {"jmp", 0}, {"jz", 1}, {"jnz", 2}, {"jc", 3}, {"jnc", 4},
+    {"jl", 5}, {"jle", 6}, {"jg", 7}, {"jge", 8}, // signed, after cmp/scmp
+    {"jb", 9}, {"jbe", 10}, {"ja", 11}, {"jae", 12}, // unsigned, after cmp
+    {"js", 13}, {"jns", 14}, {"jo", 15}, {"jno", 16}
+};
+
 // returns true if a string is valid
 bool isStringValid(const std::string& str) {
     // check for quotes
@@ -141,7 +150,7 @@ void loadInstructionArgs(const std::string& line, std::vector<std::string>& args
 }
 
 // responsible for taking a .tpu file and loading it into memory for main
-void loadFileToMemory(const std::string& path, Memory& memory) {
+void loadFileToMemory(const std::string& path, Memory& memory, label_map_t* pLabelMapOut) {
     // open file
     std::ifstream inHandle(path);
 
@@ -221,6 +230,9 @@ void loadFileToMemory(const std::string& path, Memory& memory) {
 
         // close file
         inHandle.close();
+
+        // pass along labels if requested
+        if (pLabelMapOut != nullptr) pLabelMapOut->swap(labelMap);
     } catch (std::invalid_argument& e) {
         // close inHandle
         inHandle.close();
@@ -228,6 +240,33 @@ void loadFileToMemory(const std::string& path, Memory& memory) {
     }
 }
 
+// inverts a label map to look up label names by address (keeps the first label at each address)
+void loadSymbolMap(const label_map_t& labelMap, symbol_map_t& symbolMap) {
+    for (auto& labelPair : labelMap)
+        symbolMap.insert({labelPair.second.value, labelPair.first});
+}
+
+// filters a symbol map down to function entry labels (ignores data, jump, and function-end labels)
+void loadFunctionSymbolMap(const symbol_map_t& symbolMap, symbol_map_t& funcMap) {
+    for (auto& symbolPair : symbolMap) {
+        const std::string& name = symbolPair.second;
+        const bool isFuncEnd = name.back() == FUNC_END_LABEL_SUFFIX &&
+            (name.find(FUNC_LABEL_PREFIX) == 0 || name == std::string(RESERVED_LABEL_MAIN) + FUNC_END_LABEL_SUFFIX);
+        if (symbolPair.first >= TEXT_LOWER_ADDR && !isFuncEnd && name.find(JMP_LABEL_PREFIX) != 0)
+            funcMap.insert(symbolPair);
+    }
+}
+
+// returns the name of the closest symbol at or before the address, or the hex address if there is none
+std::string getContainingSymbol(const symbol_map_t& symbolMap, u16 addr) {
+    auto it = symbolMap.upper_bound(addr);
+    if (it != symbolMap.begin()) return (--it)->second;
+
+    std::stringstream sstream;
+    sstream << "0x" << std::hex << std::setw(4) << std::setfill('0') << addr;
+    return sstream.str();
+}
+
 // process an individual line from .data section and load it into memory
 void processLineToData(std::string& line, Memory& memory, u16& dataIndex, label_map_t& labelMap) {
     // normalize formatting
@@ -326,10 +365,10 @@ void processLineToText(std::string& line, Memory& memory, u16& instIndex, label_
     } else if (kwd == "ret") {
         checkArgs(args, 0); // check for extra args
         memory[instIndex++] = OPCode::RET;
-    } else if (kwd == "jmp" || kwd == "jz" || kwd == "jnz" || kwd == "jc" || kwd == "jnc") {
+    } else if (JMP_MODS.count(kwd)) {
         checkArgs(args, 1); // check for extra args
         memory[instIndex++] = OPCode::JMP;
-        memory[instIndex++] = kwd == "jmp" ? 0 : kwd == "jz" ? 1 : kwd == "jnz" ? 2 : kwd == "jc" ? 3 : 4; // MOD byte
+        memory[instIndex++] = JMP_MODS.at(kwd); // MOD byte
 
         // get address of label from map
         if (labelMap.count(args[0]) == 0) {
@@ -25,8 +25,20 @@ class Label {
 
 typedef std::map<std::string, Label> label_map_t;
 
-// responsible for taking a .tpu file and loading it into memory for main
-void loadFileToMemory(const std::string&, Memory&);
+// symbol table for naming addresses (address, label name)
+typedef std::map<u16, std::string> symbol_map_t;
+
+// responsible for taking a .tpu file and loading it into memory for main (optionally outputs the label map)
+void loadFileToMemory(const std::string&, Memory&, label_map_t* pLabelMapOut=nullptr);
+
+// inverts a label map to look up label names by address (keeps the first label at each address)
+void loadSymbolMap(const label_map_t&, symbol_map_t&);
+
+// filters a symbol map down to function entry labels (ignores data, jump, and function-end labels)
+void loadFunctionSymbolMap(const symbol_map_t&, symbol_map_t&);
+
+// returns the name of the closest symbol at or before the address, or the hex address if there is none
+std::string getContainingSymbol(const symbol_map_t&, u16 addr);
 
 // process an individual line from .text section and load it into memory
 void processLineToText(std::string&, Memory&, u16&, label_map_t&, std::vector<std::pair<std::string, u16>>&);
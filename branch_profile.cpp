@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+
+#include "branch_profile.hpp"
+#include "memory.hpp"
+
+bool __isBranchProfiling = false;
+
+// indexed by site address, so recording a branch is a single array access
+static branch_site_t* pSites = nullptr;
+
+void startBranchProfiler() {
+    if (__isBranchProfiling) return;
+
+    pSites = new branch_site_t[MAX_MEMORY];
+    __isBranchProfiling = true;
+}
+
+void recordBranch(u16 siteAddr, u16 destAddr, u8 mod, bool isTaken) {
+    branch_site_t& site = pSites[siteAddr];
+    site.destAddr = destAddr;
+    site.mod = mod;
+
+    if (isTaken) {
+        site.taken++;
+        if (site.predictor < 2) site.mispredicts++;
+        if (site.predictor < 3) site.predictor++;
+    } else {
+        site.notTaken++;
+        if (site.predictor >= 2) site.mispredicts++;
+        if (site.predictor > 0) site.predictor--;
+    }
+}
+
+static const char* getJMPMnemonic(u8 mod) {
+    switch (mod) {
+        case 0: return "jmp";
+        case 1: return "jz";
+        case 2: return "jnz";
+        case 3: return "jc";
+        case 4: return "jnc";
+        case 5: return "jl";
+        case 6: return "jle";
+        case 7: return "jg";
+        case 8: return "jge";
+        case 9: return "jb";
+        case 10: return "jbe";
+        case 11: return "ja";
+        case 12: return "jae";
+        case 13: return "js";
+        case 14: return "jns";
+        case 15: return "jo";
+        case 16: return "jno";
+        default: return "j?";
+    }
+}
+
+void writeBranchProfile(const std::string& outPath, const symbol_map_t& symbolMap) {
+    if (!__isBranchProfiling) return;
+    __isBranchProfiling = false;
+
+    std::ofstream outHandle(outPath);
+    if (!outHandle.is_open()) {
+        killBranchProfiler();
+        throw std::runtime_error("Failed to open branch profile output file: " + outPath);
+    }
+
+    symbol_map_t funcMap;
+    loadFunctionSymbolMap(symbolMap, funcMap);
+
+    // collect executed sites
+    std::vector<u16> sites;
+    for (u32 addr = 0; addr < MAX_MEMORY; addr++)
+        if (pSites[addr].taken + pSites[addr].notTaken > 0)
+            sites.push_back(addr);
+
+    // most mispredicted first
+    std::vector<u16> byMispredicts(sites);
+    std::stable_sort(byMispredicts.begin(), byMispredicts.end(), [](u16 a, u16 b) { return pSites[a].mispredicts > pSites[b].mispredicts; });
+
+    outHandle << std::hex << std::setfill('0');
+    outHandle << "# branch <site> <dest> <mnemonic> <taken> <not_taken> <mispredicts> <function>\n";
+    for (u16 addr : byMispredicts) {
+        const branch_site_t& site = pSites[addr];
+        outHandle << "branch 0x" << std::setw(4) << addr << " 0x" << std::setw(4) << site.destAddr << ' ' << getJMPMnemonic(site.mod)
+                  << std::dec << ' ' << site.taken << ' ' << site.notTaken << ' ' << site.mispredicts << ' '
+                  << getContainingSymbol(funcMap, addr) << std::hex << '\n';
+    }
+
+    // a backwards jump that was taken is a loop latch; any branch in [header, latch] that leaves past the latch is an exit
+    outHandle << "# loop <header> <latch> <back_edges> <exits> <avg_back_edges_per_exit> <function>\n";
+    for (u16 latch : sites) {
+        const branch_site_t& site = pSites[latch];
+        if (site.destAddr > latch || site.taken == 0) continue;
+
+        u64 exits = site.mod == 0 ? 0 : site.notTaken;
+        for (u16 addr : sites)
+            if (addr >= site.destAddr && addr < latch && pSites[addr].destAddr > latch)
+                exits += pSites[addr].taken;
+
+        outHandle << "loop 0x" << std::setw(4) << site.destAddr << " 0x" << std::setw(4) << latch << std::dec << ' ' << site.taken << ' ' << exits << ' '
+                  << std::fixed << std::setprecision(2) << (exits == 0 ? (double)site.taken : (double)site.taken / exits) << ' '
+                  << getContainingSymbol(funcMap, latch) << std::hex << '\n';
+    }
+
+    outHandle.close();
+
+    killBranchProfiler();
+}
+
+void killBranchProfiler() {
+    __isBranchProfiling = false;
+
+    delete[] pSites;
+    pSites = nullptr;
+}
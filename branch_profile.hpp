@@ -0,0 +1,42 @@
+#ifndef __BRANCH_PROFILE_HPP
+#define __BRANCH_PROFILE_HPP
+
+#include <string>
+
+#include "util/globals.hpp"
+#include "asm_loader.hpp"
+
+/**
+ * Per-site branch profiling for JMP instructions.
+ *
+ * Each JMP site (the address of its opcode) keeps taken/not-taken counts plus the number of times a
+ * 2-bit saturating counter predictor would have mispredicted it. The report is a plain text format
+ * (one whitespace-separated record per line, '#' comments) so TCC can read it back for block layout.
+ */
+
+typedef struct branch_site_t {
+    u32 taken = 0;
+    u32 notTaken = 0;
+    u32 mispredicts = 0;
+    u16 destAddr = 0;
+    u8 mod = 0;
+    u8 predictor = 1; // 2-bit saturating counter (0-1 predict not taken, 2-3 predict taken)
+} branch_site_t;
+
+// used to start branch profiling (counters are freed once the profile is written)
+void startBranchProfiler();
+
+// true if branch outcomes are currently being recorded
+extern bool __isBranchProfiling;
+inline bool isBranchProfiling() { return __isBranchProfiling; }
+
+// record the outcome of the JMP at siteAddr
+void recordBranch(u16 siteAddr, u16 destAddr, u8 mod, bool isTaken);
+
+// writes the branch & loop records to outPath and stops profiling
+void writeBranchProfile(const std::string& outPath, const symbol_map_t& symbolMap);
+
+// stops profiling & frees the counters without writing them (safe to call on any exit path, and more than once)
+void killBranchProfiler();
+
+#endif
@@ -0,0 +1,174 @@
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "cycle_table.hpp"
+#include "tpu.hpp"
+
+// returns the opcode for a mnemonic (or hex/decimal opcode), or -1 if unknown
+static int getOPCodeFromString(const std::string& str) {
+    if (str == "NOP") return OPCode::NOP;
+    else if (str == "HLT") return OPCode::HLT;
+    else if (str == "SYSCALL") return OPCode::SYSCALL;
+    else if (str == "CALL") return OPCode::CALL;
+    else if (str == "RET") return OPCode::RET;
+    else if (str == "JMP") return OPCode::JMP;
+    else if (str == "MOV") return OPCode::MOV;
+    else if (str == "MOVW") return OPCode::MOVW;
+    else if (str == "PUSH") return OPCode::PUSH;
+    else if (str == "POP") return OPCode::POP;
+    else if (str == "POPW") return OPCode::POPW;
+    else if (str == "ADD") return OPCode::ADD;
+    else if (str == "SUB") return OPCode::SUB;
+    else if (str == "MUL") return OPCode::MUL;
+    else if (str == "DIV") return OPCode::DIV;
+    else if (str == "CMP") return OPCode::CMP;
+    else if (str == "BUF") return OPCode::BUF;
+    else if (str == "AND") return OPCode::AND;
+    else if (str == "OR") return OPCode::OR;
+    else if (str == "XOR") return OPCode::XOR;
+    else if (str == "NOT") return OPCode::NOT;
+    else if (str == "SHL") return OPCode::SHL;
+    else if (str == "SHR") return OPCode::SHR;
+
+    try {
+        size_t end;
+        unsigned long code = std::stoul(str, &end, 0);
+        return (end == str.size() && code <= 0xFF) ? (int)code : -1;
+    } catch (std::logic_error&) {
+        return -1;
+    }
+}
+
+// parses an unsigned value of a profile entry, throwing the error if it's larger than max (before it's narrowed)
+static unsigned long parseProfileValue(const std::string& str, const unsigned long max, const std::string& err) {
+    const unsigned long value = std::stoul(str, nullptr, 0);
+    if (value > max) throw std::invalid_argument(err);
+    return value;
+}
+
+void CycleTable::loadDefaults() {
+    // unknown opcodes are invalid anyways, so they're left as a single cycle
+    for (u16 op = 0; op < 256; op++)
+        for (u16 mod = 0; mod < CYCLE_TABLE_MODS; mod++)
+            costs[op][mod] = 1;
+
+    // sets the cost of both the unsigned & signed variants of a MOD
+    #define SET_COST(op, mod, cycles) { setCost(OPCode::op, mod, cycles); setCost(OPCode::op, (mod) | 8, cycles); }
+
+    SET_COST(NOP, 0, 3)
+    SET_COST(HLT, 0, 2)
+    for (u16 code = 0; code < CYCLE_TABLE_MODS; code++)
+        setCost(OPCode::SYSCALL, code, 51); // INT
+    SET_COST(CALL, 0, 19)
+    SET_COST(RET, 0, 16)
+
+    SET_COST(JMP, 0, 15) // unconditional
+    for (u16 mod = 1; mod < CYCLE_TABLE_MODS; mod++)
+        setCost(OPCode::JMP, mod, 4); // Jcc (not taken)
+
+    SET_COST(MOV, 0, 16)  // @addr, imm8
+    SET_COST(MOV, 1, 15)  // @addr, reg
+    SET_COST(MOV, 2, 4)   // reg, imm8
+    SET_COST(MOV, 3, 14)  // reg, @addr
+    SET_COST(MOV, 4, 2)   // reg, reg
+    SET_COST(MOV, 5, 18)  // [offset], reg
+    SET_COST(MOV, 6, 17)  // reg, [offset]
+    SET_COST(MOVW, 0, 4)  // reg, imm16
+    SET_COST(MOVW, 1, 2)  // reg, reg
+
+    SET_COST(PUSH, 0, 11) // reg
+    SET_COST(PUSH, 1, 11) // reg16
+    SET_COST(PUSH, 2, 10) // imm8
+    SET_COST(PUSH, 3, 10) // imm16
+    SET_COST(PUSH, 4, 22) // @addr
+    SET_COST(PUSH, 5, 25) // [offset]
+    SET_COST(POP, 0, 8)   // reg
+    SET_COST(POP, 1, 4)   // discard (SP adjust only)
+    SET_COST(POPW, 0, 8)
+    SET_COST(POPW, 1, 4)
+
+    // ALU ops (reg, imm / reg, reg)
+    SET_COST(ADD, 0, 4) SET_COST(ADD, 1, 4) SET_COST(ADD, 2, 3) SET_COST(ADD, 3, 3)
+    SET_COST(SUB, 0, 4) SET_COST(SUB, 1, 4) SET_COST(SUB, 2, 3) SET_COST(SUB, 3, 3)
+    SET_COST(CMP, 0, 4) SET_COST(CMP, 1, 4) SET_COST(CMP, 2, 3) SET_COST(CMP, 3, 3)
+    SET_COST(AND, 0, 4) SET_COST(AND, 1, 4) SET_COST(AND, 2, 3) SET_COST(AND, 3, 3)
+    SET_COST(OR,  0, 4) SET_COST(OR,  1, 4) SET_COST(OR,  2, 3) SET_COST(OR,  3, 3)
+    SET_COST(XOR, 0, 4) SET_COST(XOR, 1, 4) SET_COST(XOR, 2, 3) SET_COST(XOR, 3, 3)
+    SET_COST(BUF, 0, 3) SET_COST(BUF, 1, 3) SET_COST(BUF, 2, 4) SET_COST(BUF, 3, 4) // TEST
+    SET_COST(NOT, 0, 3) SET_COST(NOT, 1, 3)
+    SET_COST(SHL, 0, 8) SET_COST(SHL, 1, 8) SET_COST(SHL, 2, 8) SET_COST(SHL, 3, 8)
+    SET_COST(SHR, 0, 8) SET_COST(SHR, 1, 8) SET_COST(SHR, 2, 8) SET_COST(SHR, 3, 8)
+
+    // MUL/IMUL & DIV/IDIV (worst case of the 8086 ranges)
+    setCost(OPCode::MUL, 0, 77);  setCost(OPCode::MUL, 2, 77);  setCost(OPCode::MUL, 1, 133); setCost(OPCode::MUL, 3, 133);
+    setCost(OPCode::MUL, 8, 98);  setCost(OPCode::MUL, 10, 98); setCost(OPCode::MUL, 9, 154); setCost(OPCode::MUL, 11, 154);
+    setCost(OPCode::DIV, 0, 90);  setCost(OPCode::DIV, 2, 90);  setCost(OPCode::DIV, 1, 162); setCost(OPCode::DIV, 3, 162);
+    setCost(OPCode::DIV, 8, 112); setCost(OPCode::DIV, 10, 112); setCost(OPCode::DIV, 9, 184); setCost(OPCode::DIV, 11, 184);
+
+    #undef SET_COST
+
+    branchTakenCycles = 12; // Jcc taken is 16 cycles
+    ioByteCycles = 17;      // roughly a repeated MOVSB
+}
+
+void CycleTable::loadProfile(const std::string& path) {
+    std::ifstream inHandle(path);
+    if (!inHandle.is_open())
+        throw std::invalid_argument("Failed to open cycle profile: " + path);
+
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(inHandle, line)) {
+        ++lineNumber;
+
+        // strip comments
+        size_t commentIndex = line.find('#');
+        if (commentIndex != std::string::npos) line.erase(commentIndex);
+
+        std::stringstream sstream(line);
+        std::vector<std::string> args;
+        std::string arg;
+        while (sstream >> arg) args.push_back(arg);
+        if (args.size() == 0) continue;
+
+        const std::string errPrefix = "Invalid cycle profile entry (" + path + ":" + std::to_string(lineNumber) + "): ";
+        try {
+            if (args.size() == 2 && args[0] == "taken") {
+                branchTakenCycles = parseProfileValue(args[1], UINT16_MAX, errPrefix + line);
+            } else if (args.size() == 2 && args[0] == "io_byte") {
+                ioByteCycles = parseProfileValue(args[1], UINT16_MAX, errPrefix + line);
+            } else if (args.size() == 3) {
+                const u16 cycles = parseProfileValue(args[2], UINT16_MAX, errPrefix + line);
+
+                // grab opcode range
+                int opStart = 0, opEnd = 255;
+                if (args[0] != "*") {
+                    opStart = opEnd = getOPCodeFromString(args[0]);
+                    if (opStart == -1) throw std::invalid_argument(errPrefix + line);
+                }
+
+                // grab MOD range
+                u16 modStart = 0, modEnd = CYCLE_TABLE_MODS-1;
+                if (args[1] != "*") {
+                    modStart = modEnd = parseProfileValue(args[1], CYCLE_TABLE_MODS-1, errPrefix + line);
+                }
+
+                for (int op = opStart; op <= opEnd; op++)
+                    for (u16 mod = modStart; mod <= modEnd; mod++)
+                        setCost(op, mod, cycles);
+            } else {
+                throw std::invalid_argument(errPrefix + line);
+            }
+        } catch (std::out_of_range&) {
+            throw std::invalid_argument(errPrefix + line);
+        } catch (std::invalid_argument& e) {
+            // rethrow with line info if thrown by stoul
+            if (std::string(e.what()).find(errPrefix) == 0) throw e;
+            throw std::invalid_argument(errPrefix + line);
+        }
+    }
+
+    inHandle.close();
+}
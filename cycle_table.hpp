@@ -0,0 +1,39 @@
+#ifndef __CYCLE_TABLE_HPP
+#define __CYCLE_TABLE_HPP
+
+#include <string>
+
+#include "util/globals.hpp"
+
+// the number of MOD byte variants per opcode (the lower 5 bits, which includes the signed-op bit)
+#define CYCLE_TABLE_MODS 32
+
+/**
+ * The clock cycle cost of every instruction, indexed by opcode and MOD byte.
+ *
+ * The defaults are modeled on 8086 timings (ex. "@addr" operands are charged as a direct address
+ * EA of 6 cycles and "[reg+offset]" operands as a base + displacement EA of 9 cycles). Instructions
+ * without a MOD byte use MOD 0, except for syscalls which are indexed by their syscall code.
+ *
+ * Profiles can override any entry from a file, one entry per line ('#' starts a comment):
+ *  <mnemonic|opcode|*> <mod|*> <cycles>    sets the cost of an instruction (ex. "MUL 3 133", "* * 1")
+ *  taken <cycles>                          extra cycles when a conditional jump is taken
+ *  io_byte <cycles>                        extra cycles per byte read/written by the I/O syscalls
+ */
+class CycleTable {
+    public:
+        CycleTable() { this->loadDefaults(); };
+
+        void loadDefaults();
+        void loadProfile(const std::string& path); // throws std::invalid_argument on malformed profiles
+
+        u16 getCost(u8 opcode, u16 mod) const { return costs[opcode][mod % CYCLE_TABLE_MODS]; };
+        void setCost(u8 opcode, u16 mod, u16 cycles) { costs[opcode][mod % CYCLE_TABLE_MODS] = cycles; };
+
+        u16 branchTakenCycles;  // added when a conditional jump is taken
+        u16 ioByteCycles;       // added per byte transferred by STDOUT/STDERR/STDIN
+    private:
+        u16 costs[256][CYCLE_TABLE_MODS];
+};
+
+#endif
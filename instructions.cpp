@@ -9,6 +9,8 @@
 #include "tpu.hpp"
 #include "memory.hpp"
 #include "kernel/kernel.hpp"
+#include "tracer.hpp"
+#include "branch_profile.hpp"
 
 constexpr bool getParity(u32 n) {
     bool parity = false;
@@ -44,6 +46,7 @@ namespace instructions {
             case Syscall::STDERR: {
                 u16 charPtr = tpu.readRegister16(Register::BX).getValue(); // get address for string start
                 u16 length = tpu.readRegister16(Register::CX).getValue(); // get the length of string
+                if (isTracing()) traceRecord(TRACE_SYSCALL, tpu.getCycles(), charPtr, length, 0, syscallCode);
 
                 // load source index from BX and destination index from BX + length
                 tpu.moveToRegister(Register::SI, charPtr);
@@ -56,15 +59,16 @@ namespace instructions {
                     } else {
                         std::cerr << (char)memory[tpu.readRegister16(Register::SI)++].getValue() << std::flush;
                     }
-                    
-                    // sleep between writes
-                    tpu.sleep();
+
+                    // charge the cost of each byte written
+                    tpu.addCycles(tpu.getCycleTable().ioByteCycles);
                 }
                 break;
             }
             case Syscall::STDIN: {
                 u16 charPtr = tpu.readRegister16(Register::BX).getValue(); // get address for string start
                 u8 length = tpu.readRegister16(Register::CX).getValue(); // get the length of string
+                if (isTracing()) traceRecord(TRACE_SYSCALL, tpu.getCycles(), charPtr, length, 0, syscallCode);
 
                 // load source index from BX and destination index from BX + length
                 tpu.moveToRegister(Register::SI, charPtr);
@@ -85,9 +89,9 @@ namespace instructions {
                             memory[tpu.readRegister16(Register::SI)++] = getch();
                         #endif
                     }
-                    
-                    // sleep between reads
-                    tpu.sleep();
+
+                    // charge the cost of each byte read
+                    tpu.addCycles(length * tpu.getCycleTable().ioByteCycles);
                 }
 
                 #if !defined(WIN32) && !defined(_WIN32) && !defined(__WIN32) || defined(__CYGWIN__)
@@ -99,6 +103,7 @@ namespace instructions {
                 // get exit status
                 u16 exitStatus = tpu.readRegister16(Register::BX).getValue();
                 tpu.setExitCode(exitStatus);
+                if (isTracing()) traceRecord(TRACE_SYSCALL, tpu.getCycles(), exitStatus, 0, 0, syscallCode);
                 break;
             }
             case Syscall::MALLOC: {
@@ -108,6 +113,11 @@ namespace instructions {
                 // invoke malloc
                 u16 addr = heapAlloc(size);
                 tpu.moveToRegister(Register::DX, addr); // put address into DX
+
+                if (isTracing()) {
+                    traceRecord(TRACE_SYSCALL, tpu.getCycles(), size, addr, 0, syscallCode);
+                    traceRecord(TRACE_COUNTER_HEAP, tpu.getCycles(), getHeapUsage());
+                }
                 break;
             }
             case Syscall::REALLOC: {
@@ -118,11 +128,29 @@ namespace instructions {
                 // invoke realloc
                 u16 resAddr = heapRealloc(addr, size);
                 tpu.moveToRegister(Register::DX, resAddr); // put address into DX
+
+                if (isTracing()) {
+                    traceRecord(TRACE_SYSCALL, tpu.getCycles(), addr, size, resAddr, syscallCode);
+                    traceRecord(TRACE_COUNTER_HEAP, tpu.getCycles(), getHeapUsage());
+                }
                 break;
             }
             case Syscall::FREE: {
                 // grab address from BX & free
-                heapFree( tpu.readRegister16(Register::BX).getValue() );
+                u16 addr = tpu.readRegister16(Register::BX).getValue();
+                heapFree(addr);
+
+                if (isTracing()) {
+                    traceRecord(TRACE_SYSCALL, tpu.getCycles(), addr, 0, 0, syscallCode);
+                    traceRecord(TRACE_COUNTER_HEAP, tpu.getCycles(), getHeapUsage());
+                }
+                break;
+            }
+            case Syscall::CLOCK: {
+                // load the lower 32 bits of the elapsed clock cycles into DX:AX
+                const u32 cycles = tpu.getCycles() & 0xFFFFFFFF;
+                tpu.moveToRegister(Register::AX, cycles & 0xFFFF);
+                tpu.moveToRegister(Register::DX, cycles >> 16);
                 break;
             }
             default: {
@@ -149,9 +177,7 @@ namespace instructions {
 
         // jump to destination address
         tpu.moveToRegister(Register::IP, destAddr);
-
-        // sleep after storing IP
-        tpu.sleep();
+        if (isTracing()) traceRecord(TRACE_CALL, tpu.getCycles(), destAddr, prevIP);
     }
 
     void processRET(TPU& tpu, Memory& memory) {
@@ -166,45 +192,86 @@ namespace instructions {
 
         // jump to destination address
         tpu.moveToRegister(Register::IP, destAddr);
-
-        // sleep after storing IP
-        tpu.sleep();
+        if (isTracing()) traceRecord(TRACE_RET, tpu.getCycles(), destAddr);
     }
 
     void processJMP(TPU& tpu, Memory& memory) {
+        // the address of the JMP opcode, used to identify the branch site
+        const u16 siteAddr = tpu.readRegister16(Register::IP).getValue() - 1;
+
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u16 destAddr = tpu.readWord(memory).getValue();
-        switch (mod.getValue() & 0b111) {
+        bool isTaken;
+        switch (mod.getValue()) {
             case 0: { // Moves the instruction pointer to the specified label.
-                tpu.moveToRegister(Register::IP, destAddr);
+                isTaken = true;
                 break;
             }
             case 1: { // Moves the instruction pointer to the specified label, if the zero flag (ZF) is set.
-                if (tpu.getFlag(ZERO)) {
-                    tpu.moveToRegister(Register::IP, destAddr);
-                }
+                isTaken = tpu.getFlag(ZERO);
                 break;
             }
             case 2: { // Moves the instruction pointer to the specified label, if the zero flag (ZF) is cleared.
-                if (!tpu.getFlag(ZERO)) {
-                    tpu.moveToRegister(Register::IP, destAddr);
-                }
+                isTaken = !tpu.getFlag(ZERO);
                 break;
             }
             case 3: { // Moves the instruction pointer to the specified label, if the carry flag (CF) is set.
-                if (tpu.getFlag(CARRY)) {
-                    tpu.moveToRegister(Register::IP, destAddr);
-                }
+                isTaken = tpu.getFlag(CARRY);
                 break;
             }
             case 4: { // Moves the instruction pointer to the specified label, if the carry flag (CF) is cleared.
-                if (!tpu.getFlag(CARRY)) {
-                    tpu.moveToRegister(Register::IP, destAddr);
-                }
+                isTaken = !tpu.getFlag(CARRY);
+                break;
+            }
+            case 5: { // jl: signed less (SF != OF).
+                isTaken = tpu.getFlag(SIGN) != tpu.getFlag(OVERFLOW);
+                break;
+            }
+            case 6: { // jle: signed less or equal (ZF or SF != OF).
+                isTaken = tpu.getFlag(ZERO) || tpu.getFlag(SIGN) != tpu.getFlag(OVERFLOW);
+                break;
+            }
+            case 7: { // jg: signed greater (!ZF and SF == OF).
+                isTaken = !tpu.getFlag(ZERO) && tpu.getFlag(SIGN) == tpu.getFlag(OVERFLOW);
+                break;
+            }
+            case 8: { // jge: signed greater or equal (SF == OF).
+                isTaken = tpu.getFlag(SIGN) == tpu.getFlag(OVERFLOW);
+                break;
+            }
+            case 9: { // jb: unsigned below (CF).
+                isTaken = tpu.getFlag(CARRY);
+                break;
+            }
+            case 10: { // jbe: unsigned below or equal (CF or ZF).
+                isTaken = tpu.getFlag(CARRY) || tpu.getFlag(ZERO);
+                break;
+            }
+            case 11: { // ja: unsigned above (!CF and !ZF).
+                isTaken = !tpu.getFlag(CARRY) && !tpu.getFlag(ZERO);
+                break;
+            }
+            case 12: { // jae: unsigned above or equal (!CF).
+                isTaken = !tpu.getFlag(CARRY);
+                break;
+            }
+            case 13: { // js: sign flag (SF) set.
+                isTaken = tpu.getFlag(SIGN);
+                break;
+            }
+            case 14: { // jns: sign flag (SF) cleared.
+                isTaken = !tpu.getFlag(SIGN);
+                break;
+            }
+            case 15: { // jo: overflow flag (OF) set.
+                isTaken = tpu.getFlag(OVERFLOW);
+                break;
+            }
+            case 16: { // jno: overflow flag (OF) cleared.
+                isTaken = !tpu.getFlag(OVERFLOW);
                 break;
             }
             default: {
@@ -212,12 +279,22 @@ namespace instructions {
                 break;
             }
         }
+
+        if (isBranchProfiling()) recordBranch(siteAddr, destAddr, mod.getValue(), isTaken);
+        if (isTaken) tpu.moveToRegister(Register::IP, destAddr);
+
+        // TCC compiles calls in tail position to jumps, which replace the caller's span in the trace
+        if (isTracing() && mod.getValue() == 0 && isTailCallTarget(destAddr))
+            traceRecord(TRACE_TAIL_CALL, tpu.getCycles(), destAddr);
+
+        // conditional jumps are charged extra when taken (the base cost is the not-taken cost)
+        if (isTaken && mod.getValue() != 0)
+            tpu.addCycles(tpu.getCycleTable().branchTakenCycles);
     }
 
     void processMOV(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         switch (mod.getValue() & 0b111) {
@@ -285,7 +362,6 @@ namespace instructions {
     void processMOVW(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         switch (mod.getValue() & 0b111) {
@@ -315,7 +391,6 @@ namespace instructions {
     void processPUSH(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u16 pushedValue;
@@ -410,7 +485,6 @@ namespace instructions {
     void processPOP(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u16 oldAddr = tpu.readRegister16(Register::SP).getValue();
@@ -435,7 +509,6 @@ namespace instructions {
     void processPOPW(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u16 oldAddr = tpu.readRegister16(Register::SP).getValue();
@@ -464,7 +537,6 @@ namespace instructions {
     void processADD(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u8 opA = tpu.readByte(memory).getValue();
@@ -503,11 +575,13 @@ namespace instructions {
 
                 // store result & update flags
                 tpu.moveToRegister( dest, sum8 );
-                tpu.setFlag(CARRY, isCarry); // same as overflow
+                tpu.setFlag(CARRY, isCarry);
                 tpu.setFlag(PARITY, getParity(sum8));
                 tpu.setFlag(ZERO, sum8 == 0);
                 tpu.setFlag(SIGN, sum8 & 0x80);
-                tpu.setFlag(OVERFLOW, isCarry);
+
+                // overflow is set when both operands have the same sign and the sum's differs, for add and sadd alike
+                tpu.setFlag(OVERFLOW, ((uA ^ sum8) & (uB ^ sum8) & 0x80) != 0);
                 break;
             }
             case 1:   // Adds 16-bit register and imm16 and stores in first operand.
@@ -540,11 +614,13 @@ namespace instructions {
 
                 // store result & update flags
                 tpu.moveToRegister( dest, sum16 );
-                tpu.setFlag(CARRY, isCarry); // same as overflow
+                tpu.setFlag(CARRY, isCarry);
                 tpu.setFlag(PARITY, getParity(sum16));
                 tpu.setFlag(ZERO, sum16 == 0);
                 tpu.setFlag(SIGN, sum16 & 0x8000);
-                tpu.setFlag(OVERFLOW, isCarry);
+
+                // overflow is set when both operands have the same sign and the sum's differs, for add and sadd alike
+                tpu.setFlag(OVERFLOW, ((uA ^ sum16) & (uB ^ sum16) & 0x8000) != 0);
                 break;
             }
             default: {
@@ -557,7 +633,6 @@ namespace instructions {
     void processSUB(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u8 opA = tpu.readByte(memory).getValue();
@@ -595,11 +670,13 @@ namespace instructions {
 
                 // store result & update flags
                 tpu.moveToRegister( dest, diff8 );
-                tpu.setFlag(CARRY, isBorrow); // same as overflow
+                tpu.setFlag(CARRY, isBorrow);
                 tpu.setFlag(PARITY, getParity(diff8));
                 tpu.setFlag(ZERO, diff8 == 0);
                 tpu.setFlag(SIGN, diff8 & 0x80);
-                tpu.setFlag(OVERFLOW, isBorrow);
+
+                // overflow is set when the operands' signs differ and the difference's differs from A's, for sub and ssub alike
+                tpu.setFlag(OVERFLOW, ((uA ^ uB) & (uA ^ diff8) & 0x80) != 0);
                 break;
             }
             case 1:   // Subtracts imm16 from a 16-bit register and stores in first operand.
@@ -631,11 +708,13 @@ namespace instructions {
 
                 // store result & update flags
                 tpu.moveToRegister( dest, diff16 );
-                tpu.setFlag(CARRY, isBorrow); // same as overflow
+                tpu.setFlag(CARRY, isBorrow);
                 tpu.setFlag(PARITY, getParity(diff16));
                 tpu.setFlag(ZERO, diff16 == 0);
                 tpu.setFlag(SIGN, diff16 & 0x8000);
-                tpu.setFlag(OVERFLOW, isBorrow);
+
+                // overflow is set when the operands' signs differ and the difference's differs from A's, for sub and ssub alike
+                tpu.setFlag(OVERFLOW, ((uA ^ uB) & (uA ^ diff16) & 0x8000) != 0);
                 break;
             }
             default: {
@@ -648,7 +727,6 @@ namespace instructions {
     void processMUL(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // multiply operands
         const bool isSignedOp = mod.getValue() & 8;
@@ -733,7 +811,6 @@ namespace instructions {
     void processDIV(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // divide operands
         const bool isSignedOp = mod.getValue() & 8;
@@ -814,7 +891,6 @@ namespace instructions {
     void processCMP(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u8 opA = tpu.readByte(memory).getValue();
@@ -851,10 +927,13 @@ namespace instructions {
                 }
 
                 // update flags
-                tpu.setFlag(CARRY, isCarry); // same as overflow
+                tpu.setFlag(CARRY, isCarry);
                 tpu.setFlag(PARITY, getParity(diff8));
                 tpu.setFlag(ZERO, diff8 == 0);
-                tpu.setFlag(OVERFLOW, isCarry);
+
+                // sign & overflow always describe the raw A - B, so jl/jg/etc. work after cmp and scmp alike
+                tpu.setFlag(SIGN, (diff8 & 0x80) != 0);
+                tpu.setFlag(OVERFLOW, ((uA ^ uB) & (uA ^ diff8) & 0x80) != 0);
                 break;
             }
             case 1:   // Compares a 16-bit register value and imm16.
@@ -885,10 +964,13 @@ namespace instructions {
                 }
 
                 // update flags
-                tpu.setFlag(CARRY, isCarry); // same as overflow
+                tpu.setFlag(CARRY, isCarry);
                 tpu.setFlag(PARITY, getParity(diff16));
                 tpu.setFlag(ZERO, diff16 == 0);
-                tpu.setFlag(OVERFLOW, isCarry);
+
+                // sign & overflow always describe the raw A - B, so jl/jg/etc. work after cmp and scmp alike
+                tpu.setFlag(SIGN, (diff16 & 0x8000) != 0);
+                tpu.setFlag(OVERFLOW, ((uA ^ uB) & (uA ^ diff16) & 0x8000) != 0);
                 break;
             }
             default: {
@@ -901,7 +983,6 @@ namespace instructions {
     void processBUF(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u16 value;
@@ -941,7 +1022,6 @@ namespace instructions {
     void processAND(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u8 opA = tpu.readByte(memory).getValue();
@@ -1004,7 +1084,6 @@ namespace instructions {
     void processOR(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u8 opA = tpu.readByte(memory).getValue();
@@ -1067,7 +1146,6 @@ namespace instructions {
     void processXOR(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u8 opA = tpu.readByte(memory).getValue();
@@ -1130,7 +1208,6 @@ namespace instructions {
     void processNOT(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u8 opA = tpu.readByte(memory).getValue();
@@ -1155,7 +1232,6 @@ namespace instructions {
     void processSHL(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u8 opA = tpu.readByte(memory).getValue();
@@ -1204,7 +1280,6 @@ namespace instructions {
     void processSHR(TPU& tpu, Memory& memory) {
         // determine operands from mod byte
         Byte mod = tpu.readByte(memory);
-        tpu.sleep(); // wait since TPU has to process mod byte
 
         // get operands
         u8 opA = tpu.readByte(memory).getValue();
@@ -153,6 +153,15 @@ void heapFree(u16 addr) {
     }
 }
 
+// returns the total number of bytes currently allocated on the heap
+u32 getHeapUsage() {
+    u32 total = 0;
+    for (HeapFrag* pNode = pHeap; pNode != nullptr; pNode = pNode->pNext)
+        if (!pNode->isFree)
+            total += pNode->size;
+    return total;
+}
+
 // frees the heap
 void resetHeap() {
     delete pHeap;
@@ -42,4 +42,7 @@ u16 heapRealloc(u16 addr, u16 size);
 // frees the chunk held at the given address
 void heapFree(u16 addr);
 
+// returns the total number of bytes currently allocated on the heap
+u32 getHeapUsage();
+
 #endif
\ No newline at end of file
@@ -1,10 +1,14 @@
 #include <iostream>
+#include <stdexcept>
 
 #include "util/globals.hpp"
 #include "tpu.hpp"
 #include "memory.hpp"
 #include "asm_loader.hpp"
 #include "kernel/kernel.hpp"
+#include "tracer.hpp"
+#include "profiler.hpp"
+#include "branch_profile.hpp"
 
 /**
  * The TPU-2 (Terrible Processing Unit version 2) is an emulated 16-bit CPU.
@@ -20,16 +24,62 @@
 */
 
 /**
- * NOTE: due to internal clock resolution, the thread sleep handles microseconds and thus any
- *  clock speed past 1 Mhz will cause the thread to sleep for 0 microseconds (basically not sleeping).
+ * NOTE: each instruction is charged its cost from the TPU's cycle table, and the TPU sleeps until
+ *  the host clock catches up to the total cycle count (so timing doesn't drift at high clock speeds).
 */
 
+/**
+ * Usage: <executable> path_to_file.tpu <optional: args>
+ * 
+ * Arguments:
+ *  -trace <output path>:
+ *      Writes a Chrome trace_event JSON file of guest calls, syscalls, stack and heap usage
+ *  -profile <output path>:
+ *      Samples the guest IP & callstack on a host timer and writes a flat profile and folded callstacks
+ *  -branch-profile <output path>:
+ *      Counts taken/not-taken outcomes & mispredictions per jump site and writes branch and loop records
+ *  -timing <profile path>:
+ *      Overrides the default (8086-like) instruction cycle costs, see references/cycle_profiles
+ */
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Invalid usage: <executable> path_to_file.tpu\n";
+    if (argc < 2) {
+        std::cerr << "Invalid usage: <executable> path_to_file.tpu <optional: args>\n";
         exit(1);
     }
 
+    // grab any extra args
+    std::string tracePath, profilePath, branchProfilePath, timingPath;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "-trace") {
+            if (i+1 == argc) {
+                std::cerr << "Error: Invalid usage, output file must be specified after \"-trace\" flag.\n";
+                exit(1);
+            }
+            tracePath = std::string(argv[++i]);
+        } else if (arg == "-profile") {
+            if (i+1 == argc) {
+                std::cerr << "Error: Invalid usage, output file must be specified after \"-profile\" flag.\n";
+                exit(1);
+            }
+            profilePath = std::string(argv[++i]);
+        } else if (arg == "-branch-profile") {
+            if (i+1 == argc) {
+                std::cerr << "Error: Invalid usage, output file must be specified after \"-branch-profile\" flag.\n";
+                exit(1);
+            }
+            branchProfilePath = std::string(argv[++i]);
+        } else if (arg == "-timing") {
+            if (i+1 == argc) {
+                std::cerr << "Error: Invalid usage, profile file must be specified after \"-timing\" flag.\n";
+                exit(1);
+            }
+            timingPath = std::string(argv[++i]);
+        } else {
+            std::cout << "Warning: Skipping invalid argument: " << arg << '\n';
+        }
+    }
+
     // initialize the processor & memory
     TPU tpu(CLOCK_FREQ_HZ);
     Memory memory;
@@ -38,12 +88,41 @@ int main(int argc, char* argv[]) {
     startKernel();
 
     try {
+        // load instruction timings
+        if (timingPath.size() > 0)
+            tpu.getCycleTable().loadProfile(timingPath);
+
         // load test program to memory
-        loadFileToMemory(argv[1], memory);
+        label_map_t labelMap;
+        loadFileToMemory(argv[1], memory, &labelMap);
+
+        // name addresses by their labels
+        symbol_map_t symbolMap;
+        loadSymbolMap(labelMap, symbolMap);
+
+        // start the tracer
+        if (tracePath.size() > 0)
+            startTracer(tracePath, symbolMap, CLOCK_FREQ_HZ);
+
+        // start the sampling profiler
+        if (profilePath.size() > 0)
+            startProfiler(tpu, memory);
+
+        // start recording branch outcomes
+        if (branchProfilePath.size() > 0)
+            startBranchProfiler();
 
         // start the CPU's clock and wait
         tpu.start(memory);
 
+        if (branchProfilePath.size() > 0)
+            writeBranchProfile(branchProfilePath, symbolMap);
+
+        if (profilePath.size() > 0) {
+            stopProfiler();
+            writeProfile(profilePath, symbolMap);
+        }
+
         std::cout << tpu.readRegister16(Register::AX) << ' ' << tpu.readRegister16(Register::BX) << '\n';
         std::cout << tpu.readRegister16(Register::CX) << ' ' << tpu.readRegister16(Register::DX) << '\n';
         std::cout << (memory)[tpu.readRegister16(Register::SP).getValue()-1] << '\n';
@@ -54,8 +133,17 @@ int main(int argc, char* argv[]) {
         std::cout << "Program exited with status " << (short)tpu.readRegister16(Register::ES).getValue() << ".\n";
     } catch (std::invalid_argument& e) {
         std::cerr << e.what() << '\n';
+    } catch (std::runtime_error& e) {
+        std::cerr << e.what() << '\n';
+    } catch (std::out_of_range& e) {
+        std::cerr << e.what() << '\n';
     }
 
+    // flush any remaining trace records, stop sampling & free the samples and branch counters
+    stopTracer();
+    killProfiler();
+    killBranchProfiler();
+
     // kill the kernel
     killKernel();
 
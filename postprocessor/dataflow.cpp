@@ -0,0 +1,537 @@
+#include <map>
+#include <tuple>
+
+#include "dataflow.hpp"
+
+/*************************************************************/
+/*                          EFFECTS                          */
+/*************************************************************/
+
+// returns, for each instruction, true if the flags it leaves behind are never read
+static void findDeadFlags(const std::vector<IRInst>& insts, std::vector<bool>& isDeadAfter) {
+    isDeadAfter.assign(insts.size(), false);
+    bool isLive = true; // everything is used after the block
+    for (size_t i = insts.size(); i-- > 0;) {
+        isDeadAfter[i] = !isLive;
+
+        const inst_effects_t effects = getEffects(insts[i]);
+        if (effects.isBarrier || (effects.uses & REGS_FLAGS)) isLive = true;
+        else if (effects.defs & REGS_FLAGS) isLive = false;
+    }
+}
+
+/*************************************************************/
+/*                  STACK VALUE FORWARDING                   */
+/*************************************************************/
+
+// a byte on the symbolic stack, pushed by the instruction in the given slot (or unknown)
+typedef struct stack_byte_t {
+    size_t slot;
+    u8 size; // the size of the push it came from
+    u8 part; // 0 for the low/only byte, 1 for the high byte of a pushw
+} stack_byte_t;
+
+#define UNKNOWN_SLOT ((size_t)-1)
+
+// removes the given pushes (consecutive on the stack, lowest first) that are read back at slot j, moving any
+// SP-relative accesses in between that reach below them; returns false (w/o changing anything) if that isn't safe
+static bool removePushes(std::vector<std::vector<IRInst>>& slots, const std::vector<size_t>& pushes, const size_t j) {
+    // every byte pushed above the removed ones since the first of them
+    int above = 0;
+    int shift = 0; // the number of removed bytes on the stack
+
+    std::vector<std::pair<IROperand*, int>> newOffsets;
+    size_t nextPush = 0;
+    for (size_t t = pushes[0]; t < j; ++t) {
+        if (nextPush < pushes.size() && t == pushes[nextPush]) {
+            shift += slots[t][0].op == IROpcode::PUSHW ? 2 : 1;
+            ++nextPush;
+            if (above != 0) return false;
+            continue;
+        }
+
+        for (IRInst& inst : slots[t]) {
+            const inst_effects_t effects = getEffects(inst);
+            int delta;
+            if (effects.isBarrier || !getStackDelta(inst, effects, delta)) return false;
+
+            // only SP-relative memory accesses can be told apart from the removed bytes
+            for (IROperand* pOperand : {&inst.a, &inst.b}) {
+                if (pOperand->type == IROperandType::ADDR) return false;
+                if (pOperand->type != IROperandType::OFFSET) continue;
+                if (!isStackOffset(*pOperand)) return false;
+
+                const int offset = pOperand->value;
+                if (offset >= -above) continue; // above the removed bytes
+                if (offset >= -above - shift) return false; // reads/writes a removed byte
+                newOffsets.push_back({pOperand, offset + shift});
+            }
+
+            above += delta;
+            if (above < 0) return false;
+        }
+    }
+    if (above != 0) return false;
+
+    for (const std::pair<IROperand*, int>& newOffset : newOffsets)
+        newOffset.first->value = newOffset.second;
+    for (const size_t push : pushes)
+        slots[push].clear();
+    return true;
+}
+
+// returns true if the value pushed in the slot can still be read at slot j (after the push was removed)
+static bool isPushedValueIntact(const std::vector<std::vector<IRInst>>& slots, const size_t push, const size_t j) {
+    const IROperand& source = slots[push][0].a;
+    reg_set_t sourceRegs = 0;
+    if (source.type == IROperandType::ADDR) return false;
+    if ((source.type == IROperandType::REG || source.type == IROperandType::OFFSET) && !getRegisterSet(source.name, sourceRegs))
+        return false;
+    if (source.type == IROperandType::REG && (sourceRegs & REGS_SP)) return false;
+
+    for (size_t t = push+1; t < j; ++t) {
+        for (const IRInst& inst : slots[t]) {
+            const inst_effects_t effects = getEffects(inst);
+            if (effects.clobbers & sourceRegs & ~REGS_SP) return false;
+
+            // stack-relative sources are below any later pushes, but not necessarily below other stores
+            const bool isPush = inst.op == IROpcode::PUSH || inst.op == IROpcode::PUSHW;
+            if (source.type == IROperandType::OFFSET && effects.writesMemory && !isPush) return false;
+        }
+    }
+    return true;
+}
+
+// matches the pops in a block to pushes earlier in it (see header)
+size_t forwardStackValues(std::vector<IRInst>& insts) {
+    std::vector<std::vector<IRInst>> slots;
+    for (const IRInst& inst : insts)
+        slots.push_back({inst});
+
+    std::vector<bool> isFlagDeadAfter;
+    findDeadFlags(insts, isFlagDeadAfter);
+
+    size_t numRewrites = 0;
+    std::vector<stack_byte_t> stack;
+    for (size_t j = 0; j < slots.size(); ++j) {
+        const IRInst inst = slots[j][0];
+        const inst_effects_t effects = getEffects(inst);
+        int delta;
+        if (effects.isBarrier || !getStackDelta(inst, effects, delta)) {
+            stack.clear();
+            continue;
+        }
+
+        if (inst.op == IROpcode::PUSH || inst.op == IROpcode::PUSHW) {
+            for (u8 part = 0; part < delta; ++part)
+                stack.push_back({j, (u8)delta, part});
+            continue;
+        } else if (delta > 0) { // add SP, imm reserves unknown bytes
+            stack.insert(stack.end(), delta, {UNKNOWN_SLOT, 1, 0});
+            continue;
+        } else if (delta == 0) {
+            continue;
+        } else if ((size_t)-delta > stack.size()) {
+            stack.clear();
+            continue;
+        }
+
+        // a subtraction from the SP just drops whole pushes off the top (only if the flags it sets aren't used)
+        if (inst.op == IROpcode::SUB) {
+            int numBytes = -delta;
+            while (numBytes > 0 && isFlagDeadAfter[j]) {
+                const stack_byte_t top = stack.back();
+                if (top.slot == UNKNOWN_SLOT || top.part+1 != top.size || top.size > numBytes ||
+                    (top.size == 2 && stack[stack.size()-2].slot != top.slot)) break;
+                if (!removePushes(slots, {top.slot}, j)) break;
+
+                stack.resize(stack.size() - top.size);
+                numBytes -= top.size;
+                slots[j].clear();
+                if (numBytes > 0)
+                    slots[j].push_back( IRInst(IROpcode::SUB, inst.a, IROperand::makeImm(numBytes)) );
+                ++numRewrites;
+            }
+            stack.resize(stack.size() - numBytes);
+            continue;
+        }
+
+        // find the push(es) read back by this pop
+        const IROperand& dest = inst.a;
+        std::vector<size_t> pushes;
+        const stack_byte_t top = stack.back();
+        if (inst.op == IROpcode::POP) {
+            if (top.size == 1) pushes.push_back(top.slot);
+        } else {
+            const stack_byte_t low = stack[stack.size()-2];
+            if (top.size == 2 && top.part == 1 && low.slot == top.slot) {
+                pushes.push_back(top.slot);
+            } else if (top.size == 1 && low.size == 1) {
+                pushes.push_back(low.slot);
+                pushes.push_back(top.slot);
+            }
+        }
+        stack.resize(stack.size() + delta);
+        if (pushes.size() == 0 || pushes[0] == UNKNOWN_SLOT || pushes.back() == UNKNOWN_SLOT) continue;
+
+        // work out the moves replacing the pop
+        std::vector<IRInst> moves;
+        if (dest.type == IROperandType::REG) {
+            for (const size_t push : pushes)
+                if (!isPushedValueIntact(slots, push, j)) goto nextPop;
+
+            if (inst.op == IROpcode::POP || pushes.size() == 2) {
+                // byte pushes, read back into a byte register or the halves of a 16-bit one
+                std::vector<IROperand> parts;
+                if (inst.op == IROpcode::POP) {
+                    parts.push_back(dest);
+                } else {
+                    reg_set_t regs = 0;
+                    getRegisterSet(dest.name, regs);
+                    if (regs & ~(REGS_AX | REGS_BX | REGS_CX | REGS_DX)) goto nextPop; // BP, SI, DI & SP have no byte halves
+                    parts.push_back( IROperand::makeReg(dest.name.substr(0, 1) + "L") );
+                    parts.push_back( IROperand::makeReg(dest.name.substr(0, 1) + "H") );
+                }
+
+                for (size_t k = 0; k < pushes.size(); ++k) {
+                    IROperand source = slots[pushes[k]][0].a;
+                    if (isStackOffset(source)) {
+                        // the SP has moved down to where the lowest removed push was
+                        source.value += (int)k;
+                        if (source.value >= 0) goto nextPop;
+                    }
+
+                    // the low half mustn't be overwritten before the high half is read
+                    if (k == 1 && source.type == IROperandType::REG && source.name == parts[0].name) goto nextPop;
+                    if (source != parts[k]) moves.push_back( IRInst(IROpcode::MOV, parts[k], source) );
+                }
+            } else if (slots[pushes[0]][0].a != dest) {
+                moves.push_back( IRInst(IROpcode::MOVW, dest, slots[pushes[0]][0].a) );
+            }
+        }
+
+        if (removePushes(slots, pushes, j)) {
+            slots[j] = moves;
+            ++numRewrites;
+        }
+        nextPop:;
+    }
+
+    if (numRewrites == 0) return 0;
+    insts.clear();
+    for (const std::vector<IRInst>& slot : slots)
+        insts.insert(insts.end(), slot.begin(), slot.end());
+    return numRewrites;
+}
+
+/*************************************************************/
+/*                     VALUE NUMBERING                       */
+/*************************************************************/
+
+/**
+ * Symbolic values, interned so that equal values share an id. Bytes are constants, fresh unknowns or halves of
+ * 16-bit values; 16-bit values are addresses relative to the SP at the start of the block, fresh unknowns or a
+ * pair of bytes (16-bit constants are pairs of constant bytes).
+ */
+class ValueTable {
+    public:
+        int makeFresh() { return makeValue(FRESH, (int)values.size(), 0); };
+        int makeConst(int byte) { return makeValue(CONST, byte & 0xFF, 0); };
+        int makeStackAddress(int offset) { return makeValue(STACK, offset, 0); };
+
+        int makeLow(int word) { return values[word].kind == PAIR ? values[word].a : makeValue(LOW, word, 0); };
+        int makeHigh(int word) { return values[word].kind == PAIR ? values[word].b : makeValue(HIGH, word, 0); };
+        int makePair(int low, int high) {
+            if (values[low].kind == LOW && values[high].kind == HIGH && values[low].a == values[high].a) return values[low].a;
+            return makeValue(PAIR, low, high);
+        };
+        int makeWord(int value) { return makePair(makeConst(value), makeConst(value >> 8)); };
+
+        // returns true if the value is an address relative to the starting SP (written to offset)
+        bool isStackAddress(int value, int& offset) const {
+            offset = values[value].a;
+            return values[value].kind == STACK;
+        };
+    private:
+        enum Kind { FRESH, CONST, STACK, LOW, HIGH, PAIR };
+        typedef struct value_t { Kind kind; int a, b; } value_t;
+
+        int makeValue(Kind kind, int a, int b) {
+            const std::tuple<int, int, int> key(kind, a, b);
+            std::map<std::tuple<int, int, int>, int>::const_iterator it = ids.find(key);
+            if (it != ids.end()) return it->second;
+
+            values.push_back({kind, a, b});
+            return ids[key] = (int)values.size()-1;
+        };
+
+        std::vector<value_t> values;
+        std::map<std::tuple<int, int, int>, int> ids;
+};
+
+// the values held by each tracked register and the known bytes of stack memory
+class ValueState {
+    public:
+        ValueState(ValueTable& table) : table(table) { reset(); };
+
+        void reset() {
+            for (int& value : byteRegs) value = table.makeFresh();
+            for (int& value : wordRegs) value = table.makeFresh();
+            wordRegs[3] = table.makeStackAddress(0);
+            memory.clear();
+        };
+
+        int getByte(const IROperand& operand) {
+            if (operand.type == IROperandType::IMM) return table.makeConst(operand.value);
+            if (operand.type == IROperandType::REG) return byteRegs[getByteIndex(operand.name)];
+
+            int address;
+            if (!getAddress(operand, address)) return table.makeFresh();
+            return loadByte(address);
+        };
+
+        int getWord(const IROperand& operand) {
+            if (operand.type == IROperandType::IMM) return table.makeWord(operand.value);
+            if (operand.type != IROperandType::REG) return table.makeFresh(); // labels
+            const int wordIndex = getWordIndex(operand.name);
+            if (wordIndex != -1) return wordRegs[wordIndex];
+
+            const int lowIndex = getByteIndex(operand.name.substr(0, 1) + "L");
+            return table.makePair(byteRegs[lowIndex], byteRegs[lowIndex+1]);
+        };
+
+        void setByte(const IROperand& operand, const int value) {
+            if (operand.type == IROperandType::REG) {
+                byteRegs[getByteIndex(operand.name)] = value;
+                return;
+            }
+
+            int address;
+            if (getAddress(operand, address)) {
+                memory[address] = value;
+            } else { // could be anywhere
+                memory.clear();
+            }
+        };
+
+        void setWord(const IROperand& operand, const int value) {
+            const int wordIndex = getWordIndex(operand.name);
+            if (wordIndex != -1) {
+                wordRegs[wordIndex] = value;
+                return;
+            }
+
+            const int lowIndex = getByteIndex(operand.name.substr(0, 1) + "L");
+            byteRegs[lowIndex] = table.makeLow(value);
+            byteRegs[lowIndex+1] = table.makeHigh(value);
+        };
+
+        // gives every register in the set an unknown value
+        void clobber(const reg_set_t regs) {
+            for (int i = 0; i < 8; ++i)
+                if (regs & (1 << i)) byteRegs[i] = table.makeFresh();
+            for (int i = 0; i < 4; ++i)
+                if (regs & (REGS_BP << i)) wordRegs[i] = table.makeFresh();
+            if (regs & REGS_SP) memory.clear(); // stack addresses can't be told apart from the new SP's
+        };
+
+        // pushes & pops (positive for pushes)
+        void moveStack(const int delta) {
+            int offset;
+            if (table.isStackAddress(wordRegs[3], offset)) wordRegs[3] = table.makeStackAddress(offset + delta);
+            else clobber(REGS_SP);
+        };
+
+        bool getAddress(const IROperand& operand, int& address) {
+            if (operand.type != IROperandType::OFFSET) return false;
+            const int wordIndex = getWordIndex(operand.name);
+            if (wordIndex == -1 || !table.isStackAddress(wordRegs[wordIndex], address)) return false;
+            address += operand.value;
+            return true;
+        };
+
+        int loadByte(const int address) {
+            std::map<int, int>::const_iterator it = memory.find(address);
+            if (it != memory.end()) return it->second;
+            return memory[address] = table.makeFresh();
+        };
+
+        static int getByteIndex(const std::string& name) {
+            for (int i = 0; i < 8; ++i)
+                if (name == BYTE_REGISTERS[i]) return i;
+            return -1;
+        };
+
+        static int getWordIndex(const std::string& name) {
+            if (name == "BP") return 0;
+            if (name == "SI") return 1;
+            if (name == "DI") return 2;
+            if (name == "SP") return 3;
+            return -1;
+        };
+
+        ValueTable& table;
+        int byteRegs[8];
+        int wordRegs[4]; // BP, SI, DI & SP
+        std::map<int, int> memory; // bytes of stack memory by their address relative to the starting SP
+};
+
+// updates the state for an instruction that's being kept
+static void applyValues(ValueState& state, const IRInst& inst, const inst_effects_t& effects) {
+    ValueTable& table = state.table;
+    if (effects.isBarrier) {
+        // conditional jumps fall through w/ everything intact, everything else may have changed it all
+        if (!inst.isConditionalJump()) state.reset();
+        return;
+    }
+
+    switch (inst.op) {
+        case IROpcode::MOV:
+            state.setByte(inst.a, state.getByte(inst.b));
+            return;
+        case IROpcode::MOVW:
+            state.setWord(inst.a, state.getWord(inst.b));
+            return;
+        case IROpcode::PUSH: case IROpcode::PUSHW: {
+            int address;
+            const bool isKnown = table.isStackAddress(state.wordRegs[3], address);
+            if (inst.op == IROpcode::PUSH) {
+                const int value = state.getByte(inst.a);
+                if (isKnown) state.memory[address] = value;
+            } else if (isKnown) {
+                const int value = state.getWord(inst.a);
+                state.memory[address] = table.makeLow(value);
+                state.memory[address+1] = table.makeHigh(value);
+            }
+            state.moveStack(inst.op == IROpcode::PUSH ? 1 : 2);
+            return;
+        }
+        case IROpcode::POP: case IROpcode::POPW: {
+            int address;
+            if (!table.isStackAddress(state.wordRegs[3], address)) {
+                state.clobber(effects.clobbers);
+                return;
+            }
+            if (inst.op == IROpcode::POP) {
+                if (inst.a.type == IROperandType::REG) state.setByte(inst.a, state.loadByte(address-1));
+            } else if (inst.a.type == IROperandType::REG) {
+                state.setWord(inst.a, table.makePair(state.loadByte(address-2), state.loadByte(address-1)));
+            }
+            state.moveStack(inst.op == IROpcode::POP ? -1 : -2);
+            return;
+        }
+        case IROpcode::ADD: case IROpcode::SUB: {
+            // keep track of stack addresses being offset
+            int address;
+            if (inst.a.width == 16 && inst.b.type == IROperandType::IMM && table.isStackAddress(state.getWord(inst.a), address)) {
+                const int delta = inst.op == IROpcode::ADD ? inst.b.value : -inst.b.value;
+                state.setWord(inst.a, table.makeStackAddress(address + delta));
+                return;
+            }
+            break;
+        }
+        case IROpcode::XOR:
+            if (inst.a == inst.b) { // zeroing
+                state.clobber(REGS_FLAGS);
+                if (inst.a.width == 8) state.setByte(inst.a, table.makeConst(0));
+                else state.setWord(inst.a, table.makeWord(0));
+                return;
+            }
+            break;
+        default: break;
+    }
+
+    // anything else just has unknown results
+    if (effects.writesMemory) state.memory.clear();
+    state.clobber(effects.clobbers);
+}
+
+// numbers the values in a block, removing redundant moves & stack address recomputations (see header)
+size_t numberValues(std::vector<IRInst>& insts) {
+    std::vector<bool> isFlagDeadAfter;
+    findDeadFlags(insts, isFlagDeadAfter);
+
+    ValueTable table;
+    ValueState state(table);
+    std::vector<IRInst> newInsts;
+    size_t numRewrites = 0;
+    for (size_t i = 0; i < insts.size(); ++i) {
+        const IRInst& inst = insts[i];
+        const inst_effects_t effects = getEffects(inst);
+        if (!effects.isBarrier) {
+            // moves & stores of what's already there
+            if (inst.op == IROpcode::MOV && state.getByte(inst.b) == state.getByte(inst.a)) {
+                ++numRewrites;
+                continue;
+            } else if (inst.op == IROpcode::MOVW && state.getWord(inst.b) == state.getWord(inst.a)) {
+                ++numRewrites;
+                continue;
+            }
+
+            // recomputing a stack address (movw R, SP then add/sub R, imm) from what the register already holds
+            int spOffset, regOffset;
+            if (inst.op == IROpcode::MOVW && inst.b.type == IROperandType::REG && inst.b.name == "SP" && inst.a.name != "SP" && i+1 < insts.size() &&
+                table.isStackAddress(state.wordRegs[3], spOffset) && table.isStackAddress(state.getWord(inst.a), regOffset)) {
+                const IRInst& next = insts[i+1];
+                if ((next.op == IROpcode::ADD || next.op == IROpcode::SUB) && next.a == inst.a &&
+                    next.b.type == IROperandType::IMM && isFlagDeadAfter[i+1]) {
+                    const int target = spOffset + (next.op == IROpcode::ADD ? next.b.value : -next.b.value);
+                    if (target != regOffset) {
+                        const IROpcode op = target > regOffset ? IROpcode::ADD : IROpcode::SUB;
+                        const IRInst adjustment(op, inst.a, IROperand::makeImm(target > regOffset ? target - regOffset : regOffset - target));
+                        newInsts.push_back(adjustment);
+                        applyValues(state, adjustment, getEffects(adjustment));
+                    }
+                    ++numRewrites;
+                    ++i;
+                    continue;
+                }
+            }
+        }
+
+        applyValues(state, inst, effects);
+        newInsts.push_back(inst);
+    }
+
+    if (numRewrites > 0) insts = newInsts;
+    return numRewrites;
+}
+
+/*************************************************************/
+/*                   DEAD CODE ELIMINATION                   */
+/*************************************************************/
+
+// removes instructions whose results aren't used (see header)
+size_t removeDeadCode(std::vector<IRInst>& insts) {
+    std::vector<bool> isDead(insts.size(), false);
+    size_t numRewrites = 0;
+
+    reg_set_t live = REGS_ALL; // everything is used after the block
+    for (size_t i = insts.size(); i-- > 0;) {
+        const IRInst& inst = insts[i];
+        const inst_effects_t effects = getEffects(inst);
+        if (effects.isBarrier) {
+            live = REGS_ALL;
+            continue;
+        }
+
+        // only instructions that can't fault & only write registers other than the SP
+        const bool isRemovable = (inst.op == IROpcode::MOV || inst.op == IROpcode::MOVW ||
+            (inst.op >= IROpcode::ADD && inst.op <= IROpcode::SHR && inst.op != IROpcode::MUL && inst.op != IROpcode::DIV)) &&
+            !effects.writesMemory && !(effects.clobbers & REGS_SP);
+        if (isRemovable && !(effects.clobbers & live)) {
+            isDead[i] = true;
+            ++numRewrites;
+            continue;
+        }
+
+        live = (live & ~effects.defs) | effects.uses;
+    }
+
+    if (numRewrites == 0) return 0;
+    std::vector<IRInst> newInsts;
+    for (size_t i = 0; i < insts.size(); ++i)
+        if (!isDead[i]) newInsts.push_back(insts[i]);
+    insts = newInsts;
+    return numRewrites;
+}
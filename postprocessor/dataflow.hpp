@@ -0,0 +1,30 @@
+#ifndef __DATAFLOW_HPP
+#define __DATAFLOW_HPP
+
+#include <vector>
+
+#include "../tlang/ir/ir.hpp"
+
+/**
+ * Dataflow passes run by the postprocessor over each basic block (a run of instructions between labels).
+ *
+ * Every label is assumed to be reached from anywhere, so nothing is known about the registers, flags or stack
+ * when a block starts and everything is assumed to be used after it ends. Jumps, calls, returns & syscalls
+ * inside a block are treated the same way.
+ */
+
+// a pass over one block, returns the number of rewrites it made
+typedef size_t (*post_block_pass_fn)(std::vector<IRInst>&);
+
+// matches pops (and target-less pops from subtracting from the SP) to the pushes they read back
+// across instructions that don't clobber the pushed value, removing both and moving the value directly
+size_t forwardStackValues(std::vector<IRInst>&);
+
+// numbers the values held in registers & stack memory, removing moves and stores of a value that's already
+// there and recomputations of stack addresses already held in a register
+size_t numberValues(std::vector<IRInst>&);
+
+// removes instructions whose results (including flags) are overwritten before being used
+size_t removeDeadCode(std::vector<IRInst>&);
+
+#endif
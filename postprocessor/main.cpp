@@ -0,0 +1,135 @@
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "postprocessor.hpp"
+
+/**
+ * A postprocessor for reducing the number of instructions of a given TPU file.
+ * 
+ * Usage: ./postproc <in.tpu> <optional: args>
+ * 
+ * Arguments:
+ *  -f:
+ *      Force overwrite the input file
+ *  -minify, --m:
+ *      Strip all extra whitespace
+ *  -strip-comments, --sc:
+ *      Strip all comments
+ *  -o <output path>:
+ *      Specifies the output path to be used
+ *  -stats:
+ *      Print how many times each rule matched (and whether they stopped at the iteration cap)
+ *  -no-dataflow:
+ *      Skip the dataflow passes over each basic block (only run the window rules)
+ *  -keep-fallthrough-jumps:
+ *      Keep jumps to the label right after them
+ */
+int main(int argc, char* argv[]) {
+    // grab cmd args
+    if (argc < 2) {
+        std::cerr << "Invalid usage: ./postproc <in.tpu> <optional: args>\n";
+        return 1;
+    }
+
+    // create post opts
+    post_process_opts opts;
+
+    // specify paths
+    const std::string inPath(argv[1]);
+    std::string outPath;
+
+    // grab any extra args
+    bool forceOverwrite = false;
+    bool printStats = false;
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "-f") {
+            if (outPath.size() > 0) {
+                std::cerr << "Error: Output path specified more than once.\n";
+                return 1;
+            }
+            forceOverwrite = true;
+            outPath = inPath;
+        } else if (arg == "-minify" || arg == "--m") {
+            opts.minify = true;
+        } else if (arg == "-strip-comments" || arg == "--sc") {
+            opts.stripComments = true;
+        } else if (arg == "-stats") {
+            printStats = true;
+        } else if (arg == "-no-dataflow") {
+            opts.forwardStackValues = opts.numberValues = opts.removeDeadCode = false;
+        } else if (arg == "-keep-fallthrough-jumps") {
+            opts.removeFallthroughJumps = false;
+        } else if (arg == "-o") {
+            if (i+1 == argc) {
+                std::cerr << "Error: Invalid usage, output file must be specified after \"-o\" flag.\n";
+                return 1;
+            } else if (outPath.size() > 0) {
+                std::cerr << "Error: Output path specified more than once.\n";
+                return 1;
+            }
+
+            // grab output file
+            outPath = std::string(argv[++i]);
+        } else {
+            std::cout << "Warning: Skipping invalid argument: " << arg << '\n';
+        }
+    }
+
+    // verify output file was set
+    if (outPath.size() == 0) {
+        std::cerr << "Error: Missing output path (usage: \"-o <out.tpu>\")\n";
+        return 1;
+    }
+
+    // grab input file
+    if (inPath == outPath) {
+        if (!forceOverwrite) {
+            std::cerr << "Error: Cannot use input file as output file (-f arg to bypass)\n";
+            return 1;
+        } else {
+            // use temp file
+            outPath += "_tmp";
+        }
+    }
+
+    // open input file
+    std::ifstream inHandle(inPath);
+    if (!inHandle.is_open()) {
+        std::cerr << "Failed to open input file: " << inPath << '\n';
+        return 1;
+    }
+
+    // open output file
+    std::ofstream outHandle(outPath);
+    if (!outHandle.is_open()) {
+        inHandle.close();
+        std::cerr << "Failed to open output file: " << outPath << '\n';
+        return 1;
+    }
+
+    // read the whole input into memory
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(inHandle, line))
+        lines.push_back(line);
+
+    // reduce & write the instructions
+    std::vector<post_rule_stats_t> stats;
+    const bool isFixpoint = postprocess(lines, outHandle, opts, &stats);
+    if (printStats) printPostprocessStats(stats, isFixpoint, std::cout);
+
+    // close file handles & overwrite temp .tpu file
+    inHandle.close();
+    outHandle.close();
+
+    // if force overwriting, overwrite
+    if (forceOverwrite) {
+        std::filesystem::remove(inPath);
+        std::filesystem::rename(outPath, inPath);
+    }
+    return 0;
+}
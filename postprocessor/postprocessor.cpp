@@ -1,335 +1,292 @@
-#include <iostream>
-#include <filesystem>
-#include <fstream>
+#include <iomanip>
 #include <string>
 #include <vector>
 
-#include <string>
-
+#include "postprocessor.hpp"
 #include "../util/globals.hpp"
 
-#define TAB "    "
+// fwd declarations
+void writeInstruction(const post_process_opts&, std::ostream&, const std::string&, const std::string&);
+void stripComments(std::string&);
 
-typedef struct post_process_opts {
-    // removes any identity operations (ex. movw AX, AX) that don't set flags (doesn't remove arithmetic identities that may be used as a buffer)
-    bool removeIdentities   = true; // default: true
+void splitLines(const std::string& text, std::vector<std::string>& lines) {
+    size_t lineStart = 0;
+    while (lineStart < text.size()) {
+        size_t lineEnd = text.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = text.size();
+        lines.emplace_back(text, lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+    }
+}
 
-    // combines any consecutive imm8 push operations into imm16 pushw operations
-    bool mergeImm8Pushes    = true; // default: true
+/*************************************************************/
+/*                           RULES                           */
+/*************************************************************/
 
-    // combines any push/pop operations between registers to mov/movw instructions and remove redundant push/pops
-    bool reducePushPops     = true; // default: true
+// removes any identity moves (ex. movw AX, AX)
+static size_t removeIdentities(const std::vector<PostLine>& lines, size_t i, std::vector<IRInst>&) {
+    const IRInst& inst = lines[i].inst;
+    return (inst.op == IROpcode::MOV || inst.op == IROpcode::MOVW) && inst.a == inst.b ? 1 : 0;
+}
 
-    // combines any consecutive target-less pop/popw instructions to just subtracting from the SP
-    bool dissolvePops       = true; // default: true
+// combines two imm8 pushes into one imm16 pushw
+static size_t mergeImm8Pushes(const std::vector<PostLine>& lines, size_t i, std::vector<IRInst>& replacement) {
+    if (i+1 == lines.size()) return 0;
 
-    // removes any comments from the input file
-    bool stripComments      = false; // default: false
+    const IRInst& low = lines[i].inst;
+    const IRInst& high = lines[i+1].inst;
+    if (low.op != IROpcode::PUSH || high.op != IROpcode::PUSH ||
+        low.a.type != IROperandType::IMM || high.a.type != IROperandType::IMM) return 0;
 
-    // removes any unnecessary whitespace (ex. leading tabs)
-    bool minify             = false; // default: false
-} post_process_opts;
+    replacement.push_back( IRInst(IROpcode::PUSHW, IROperand::makeImm(((high.a.value & 0xFF) << 8) | (low.a.value & 0xFF))) );
+    return 2;
+}
 
-// fwd declarations
-void readNextLine(const post_process_opts&, std::string&, std::string&, std::ifstream&);
-void writeInstruction(const post_process_opts&, std::ofstream&, const std::string&, const std::string&);
-void trimString(std::string&);
-void ltrimString(std::string&);
-void rtrimString(std::string&);
-void stripComments(std::string&);
+// turns a push followed by a pop into a move (or nothing), and removes a pop followed by pushing the same operand back
+static size_t reducePushPops(const std::vector<PostLine>& lines, size_t i, std::vector<IRInst>& replacement) {
+    if (i+1 == lines.size()) return 0;
+
+    const IRInst& first = lines[i].inst;
+    const IRInst& second = lines[i+1].inst;
+    if (first.a.type == IROperandType::NONE) return 0;
+
+    if (first.op == IROpcode::PUSH || first.op == IROpcode::PUSHW) {
+        const bool isWordOp = first.op == IROpcode::PUSHW;
+        if (second.op != (isWordOp ? IROpcode::POPW : IROpcode::POP)) return 0;
+
+        // whatever is pushed gets popped, so only move it if the pop has a target
+        if (second.a.type != IROperandType::NONE && second.a != first.a)
+            replacement.push_back( IRInst(isWordOp ? IROpcode::MOVW : IROpcode::MOV, second.a, first.a) );
+        return 2;
+    } else if (first.op == IROpcode::POP || first.op == IROpcode::POPW) {
+        const bool isWordOp = first.op == IROpcode::POPW;
+        return second.op == (isWordOp ? IROpcode::PUSHW : IROpcode::PUSH) && second.a == first.a ? 2 : 0;
+    }
+    return 0;
+}
 
-/**
- * A postprocessor for reducing the number of instructions of a given TPU file.
- * 
- * Usage: ./postproc <in.tpu> <optional: args>
- * 
- * Arguments:
- *  -f:
- *      Force overwrite the input file
- *  -minify, --m:
- *      Strip all extra whitespace
- *  -strip-comments, --sc:
- *      Strip all comments
- *  -o <output path>:
- *      Specifies the output path to be used
- */
-int main(int argc, char* argv[]) {
-    // grab cmd args
-    if (argc < 2) {
-        std::cerr << "Invalid usage: ./postproc <in.tpu> <optional: args>\n";
-        return 1;
+// combines any consecutive target-less pops into one subtraction from the SP
+static size_t dissolvePops(const std::vector<PostLine>& lines, size_t i, std::vector<IRInst>& replacement) {
+    size_t numPops = 0, popSize = 0;
+    for ((void)numPops; i+numPops < lines.size(); ++numPops) {
+        const IRInst& inst = lines[i+numPops].inst;
+        if ((inst.op != IROpcode::POP && inst.op != IROpcode::POPW) || inst.a.type != IROperandType::NONE) break;
+        popSize += inst.op == IROpcode::POPW ? 2 : 1;
     }
 
-    // create post opts
-    post_process_opts opts;
-
-    // specify paths
-    const std::string inPath(argv[1]);
-    std::string outPath;
-
-    // grab any extra args
-    bool forceOverwrite = false;
-    for (int i = 2; i < argc; ++i) {
-        const std::string arg(argv[i]);
-        if (arg == "-f") {
-            if (outPath.size() > 0) {
-                std::cerr << "Error: Output path specified more than once.\n";
-                return 1;
-            }
-            forceOverwrite = true;
-            outPath = inPath;
-        } else if (arg == "-minify" || arg == "--m") {
-            opts.minify = true;
-        } else if (arg == "-strip-comments" || arg == "--sc") {
-            opts.stripComments = true;
-        } else if (arg == "-o") {
-            if (i+1 == argc) {
-                std::cerr << "Error: Invalid usage, output file must be specified after \"-o\" flag.\n";
-                return 1;
-            } else if (outPath.size() > 0) {
-                std::cerr << "Error: Output path specified more than once.\n";
-                return 1;
-            }
+    if (numPops == 0) return 0;
+    replacement.push_back( IRInst(IROpcode::SUB, IROperand::makeReg("SP"), IROperand::makeImm(popSize)) );
+    return numPops;
+}
 
-            // grab output file
-            outPath = std::string(argv[++i]);
-        } else {
-            std::cout << "Warning: Skipping invalid argument: " << arg << '\n';
-        }
-    }
+// removes jumps to a label declared right after them
+static size_t removeFallthroughJumps(const std::vector<PostLine>& lines, size_t i, std::vector<IRInst>&) {
+    const IRInst& inst = lines[i].inst;
+    if (inst.op != IROpcode::JMP || inst.a.type != IROperandType::LABEL || i+1 == lines.size()) return 0;
+    return lines[i+1].label == inst.a.name ? 1 : 0;
+}
 
-    // verify output file was set
-    if (outPath.size() == 0) {
-        std::cerr << "Error: Missing output path (usage: \"-o <out.tpu>\")\n";
-        return 1;
-    }
+/*************************************************************/
+/*                          DRIVER                           */
+/*************************************************************/
 
-    // grab input file
-    if (inPath == outPath) {
-        if (!forceOverwrite) {
-            std::cerr << "Error: Cannot use input file as output file (-f arg to bypass)\n";
-            return 1;
-        } else {
-            // use temp file
-            outPath += "_tmp";
-        }
-    }
+typedef struct post_rule_entry_t {
+    post_rule_fn rule;
+    post_rule_stats_t stats;
+} post_rule_entry_t;
+
+typedef struct post_block_pass_entry_t {
+    post_block_pass_fn pass;
+    post_rule_stats_t stats;
+} post_block_pass_entry_t;
+
+static void addRule(std::vector<post_rule_entry_t>& rules, const bool isEnabled, const std::string& name, post_rule_fn rule) {
+    if (!isEnabled) return;
+
+    post_rule_entry_t entry;
+    entry.rule = rule;
+    entry.stats.name = name;
+    rules.push_back(entry);
+}
+
+static void addBlockPass(std::vector<post_block_pass_entry_t>& passes, const bool isEnabled, const std::string& name, post_block_pass_fn pass) {
+    if (!isEnabled) return;
+
+    post_block_pass_entry_t entry;
+    entry.pass = pass;
+    entry.stats.name = name;
+    passes.push_back(entry);
+}
+
+// parses the lines to be postprocessed, skipping blank ones
+static void parseLines(const post_process_opts& opts, const std::vector<std::string>& lines, std::vector<PostLine>& postLines) {
+    for (const std::string& rawLine : lines) {
+        PostLine line;
+        line.text = rawLine;
+        ltrimString(line.text); // strip whitespace
+        if (line.text.size() == 0) continue; // skip blank lines
+
+        // strip comments for the stripped line (used to match args)
+        line.stripped = line.text;
+        stripComments(line.stripped);
+        rtrimString(line.stripped);
+
+        // strip comments from actual line if needed
+        if (opts.stripComments) stripComments(line.text);
+        if (line.text.size() == 0) continue; // skip blank lines
 
-    // open input file
-    std::ifstream inHandle(inPath);
-    if (!inHandle.is_open()) {
-        std::cerr << "Failed to open input file: " << inPath << '\n';
-        return 1;
+        // labels, comments & anything unrecognized are passed through (and end any window)
+        if (!parseIRInst(line.stripped, line.inst, line.label))
+            line.inst.op = IROpcode::RAW;
+        postLines.push_back(line);
     }
+}
+
+// tries each rule on the window starting at the given line, returns true if one matched (and replaced the window)
+static bool applyRules(std::vector<PostLine>& lines, size_t i, std::vector<post_rule_entry_t>& rules) {
+    std::vector<IRInst> replacement;
+    for (post_rule_entry_t& entry : rules) {
+        replacement.clear();
+        const size_t numMatched = entry.rule(lines, i, replacement);
+        if (numMatched == 0) continue;
+
+        // swap in the replacement instructions
+        std::vector<PostLine> newLines( replacement.size() );
+        for (size_t j = 0; j < replacement.size(); ++j) {
+            newLines[j].inst = replacement[j];
+            newLines[j].text = newLines[j].stripped = replacement[j].toString();
+        }
+        lines.erase(lines.begin() + i, lines.begin() + i + numMatched);
+        lines.insert(lines.begin() + i, newLines.begin(), newLines.end());
 
-    // open output file
-    std::ofstream outHandle(outPath);
-    if (!outHandle.is_open()) {
-        inHandle.close();
-        std::cerr << "Failed to open output file: " << outPath << '\n';
-        return 1;
+        entry.stats.hits++;
+        entry.stats.instsRemoved += (long)numMatched - (long)replacement.size();
+        return true;
     }
+    return false;
+}
 
-    // read the current and last instructions into memory (break/reset on labels)
-    std::string line, strippedLine;
-
-    // read first line
-    readNextLine(opts, line, strippedLine, inHandle);
-    while (line != "") {
-        // handle arguments & such
-        if (opts.removeIdentities && strippedLine.find("mov") == 0) {
-            bool isWordOp = strippedLine.find("movw") == 0;
-
-            // grab both args
-            const size_t commaIndex = strippedLine.find(',');
-            size_t startIndex = 4 + isWordOp;
-            std::string argA = strippedLine.substr(startIndex, commaIndex - startIndex);
-            
-            startIndex = commaIndex+1;
-            std::string argB = strippedLine.substr(startIndex);
-
-            // strip whitespace
-            trimString(argA), trimString(argB);
-
-            // write the instruction if args aren't equal
-            if (argA != argB)
-                writeInstruction(opts, outHandle, line, strippedLine);
-        } else if ((opts.mergeImm8Pushes || opts.reducePushPops) && strippedLine.find("push ") == 0) {
-            // get next line and check for another push to combine with
-            std::string lineBuf, strippedLineBuf;
-            readNextLine(opts, lineBuf, strippedLineBuf, inHandle);
-
-            if (opts.mergeImm8Pushes && strippedLineBuf.find("push ") == 0) { // can be combined
-                // extract values
-                try {
-                    int valA = std::stoi( strippedLine.substr(5) );
-                    int valB = std::stoi( strippedLineBuf.substr(5) );
-
-                    std::string newInst = "pushw " + std::to_string( ((valB << 8) | valA) & 0xFFFF );
-                    writeInstruction(opts, outHandle, newInst, newInst);
-                } catch (std::invalid_argument& e) {
-                    // not pushing imm8s, handle as separate instructions
-                    writeInstruction(opts, outHandle, line, strippedLine);
-                    line = lineBuf;
-                    strippedLine = strippedLineBuf;
-                    continue; // skip reading another line
-                }
-            } else if (opts.reducePushPops && strippedLineBuf.find("pop ") == 0) {
-                // move the value between registers
-                std::string regA = strippedLine.substr(5);
-                std::string regB = strippedLineBuf.substr(4);
-
-                // write instruction if not the same argument
-                if (regA != regB) {
-                    std::string newInst = "mov " + regB + ", " + regA;
-                    writeInstruction(opts, outHandle, newInst, newInst);
-                }
-            } else {
-                // base case, current instruction not matched, so write that and pass along the next one
-                writeInstruction(opts, outHandle, line, strippedLine);
-                line = lineBuf;
-                strippedLine = strippedLineBuf;
-                continue; // skip reading another line
-            }
-        } else if (opts.reducePushPops && strippedLine.find("pushw ") == 0) {
-            // get next line and check for a popw to combine with
-            std::string lineBuf, strippedLineBuf;
-            readNextLine(opts, lineBuf, strippedLineBuf, inHandle);
-
-            if (strippedLineBuf.find("popw ") == 0) {
-                // move the value between registers
-                std::string regA = strippedLine.substr(6);
-                std::string regB = strippedLineBuf.substr(5);
-
-                // write instruction if not the same argument
-                if (regA != regB) {
-                    std::string newInst = "movw " + regB + ", " + regA;
-                    writeInstruction(opts, outHandle, newInst, newInst);
-                }
-            } else if (strippedLineBuf != "popw") { // if popw, ignore anyways since whatever is pushed gets popped
-                // base case, current instruction not matched, so write that and pass along the next one
-                writeInstruction(opts, outHandle, line, strippedLine);
-                line = lineBuf;
-                strippedLine = strippedLineBuf;
-                continue; // skip reading another line
-            }
-        } else if ((opts.dissolvePops || opts.reducePushPops) && strippedLine.find("pop") == 0) {
-            // check the next instruction
-            std::string lineBuf, strippedLineBuf;
-            readNextLine(opts, lineBuf, strippedLineBuf, inHandle);
-
-            // fetch any successive pop/popw to combine
-            if (opts.dissolvePops && (strippedLine == "popw" || strippedLine == "pop")) {
-                size_t popSize = strippedLine == "popw" ? 2 : 1;
-                while (strippedLineBuf == "popw" || strippedLineBuf == "pop") {
-                    popSize += strippedLineBuf == "popw" ? 2 : 1;
-                    readNextLine(opts, lineBuf, strippedLineBuf, inHandle);
-                }
-
-                // write SP substraction instruction
-                const std::string subInst = "sub SP, " + std::to_string(popSize);
-                writeInstruction(opts, outHandle, subInst, subInst);
-
-                // stopped on a non-matching line, so pass along
-                line = lineBuf;
-                strippedLine = strippedLineBuf;
-                continue; // skip reading another line
-            } else if (opts.reducePushPops &&
-                       ((strippedLineBuf.find("pushw ") == 0 && strippedLine.find("popw ") == 0) ||
-                       (strippedLineBuf.find("push ") == 0 && strippedLine.find("pop ") == 0))) {
-                // verify that the two arguments match
-                const bool isWordOp = strippedLine.find("popw ") == 0;
-                const std::string argA = strippedLine.substr(4 + isWordOp);
-                const std::string argB = strippedLineBuf.substr(5 + isWordOp);
-                
-                // if args aren't redundant, write them
-                if (argA != argB) {
-                    // not redundant, write this and pass along next
-                    writeInstruction(opts, outHandle, line, strippedLine);
-                    line = lineBuf;
-                    strippedLine = strippedLineBuf;
-                    continue;
-                }
-            } else {
-                // base case, current instruction not matched, so write that and pass along the next one
-                writeInstruction(opts, outHandle, line, strippedLine);
-                line = lineBuf;
-                strippedLine = strippedLineBuf;
-                continue; // skip reading another line
-            }
-        } else if (strippedLine.find("jmp ") == 0) {
-            // check for the desired label immediately after this
-            const std::string labelName = strippedLine.substr(4);
+// runs the dataflow passes over each basic block (each run of instructions), returns true if any changed
+static bool applyBlockPasses(std::vector<PostLine>& lines, std::vector<post_block_pass_entry_t>& passes) {
+    bool hasChanged = false;
+    std::vector<IRInst> block;
+    size_t start = 0;
+    while (start < lines.size()) {
+        if (lines[start].inst.op == IROpcode::RAW) {
+            ++start;
+            continue;
+        }
 
-            // check next instruction
-            std::string lineBuf, strippedLineBuf;
-            readNextLine(opts, lineBuf, strippedLineBuf, inHandle);
+        size_t end = start;
+        block.clear();
+        for ((void)end; end < lines.size() && lines[end].inst.op != IROpcode::RAW; ++end)
+            block.push_back(lines[end].inst);
 
-            // the label is not declared right on the next line, so write this line
-            if (strippedLineBuf != labelName + ':') {
-                writeInstruction(opts, outHandle, line, strippedLine);
-            }
+        size_t numRewrites = 0;
+        for (post_block_pass_entry_t& entry : passes) {
+            const size_t oldSize = block.size();
+            const size_t passRewrites = entry.pass(block);
+            if (passRewrites == 0) continue;
 
-            // regardless, write the next line
-            line = lineBuf;
-            strippedLine = strippedLineBuf;
-            continue; // skip reading another line
-        } else {
-            // write instruction as usual
-            writeInstruction(opts, outHandle, line, strippedLine);
+            entry.stats.hits += passRewrites;
+            entry.stats.instsRemoved += (long)oldSize - (long)block.size();
+            numRewrites += passRewrites;
         }
 
-        // get next instruction
-        readNextLine(opts, line, strippedLine, inHandle);
+        // swap in the rewritten block
+        if (numRewrites > 0) {
+            std::vector<PostLine> newLines( block.size() );
+            for (size_t j = 0; j < block.size(); ++j) {
+                newLines[j].inst = block[j];
+                newLines[j].text = newLines[j].stripped = block[j].toString();
+            }
+            lines.erase(lines.begin() + start, lines.begin() + end);
+            lines.insert(lines.begin() + start, newLines.begin(), newLines.end());
+            end = start + block.size();
+            hasChanged = true;
+        }
+        start = end;
     }
+    return hasChanged;
+}
+
+bool postprocess(const std::vector<std::string>& lines, std::ostream& outHandle, const post_process_opts& opts,
+                 std::vector<post_rule_stats_t>* pStats) {
+    std::vector<PostLine> postLines;
+    parseLines(opts, lines, postLines);
+
+    // the rules in the order they're tried
+    std::vector<post_rule_entry_t> rules;
+    addRule(rules, opts.removeIdentities, "remove-identities", removeIdentities);
+    addRule(rules, opts.mergeImm8Pushes, "merge-imm8-pushes", mergeImm8Pushes);
+    addRule(rules, opts.reducePushPops, "reduce-push-pops", reducePushPops);
+    addRule(rules, opts.dissolvePops, "dissolve-pops", dissolvePops);
+    addRule(rules, opts.removeFallthroughJumps, "remove-fallthrough-jumps", removeFallthroughJumps);
+
+    std::vector<post_block_pass_entry_t> blockPasses;
+    addBlockPass(blockPasses, opts.forwardStackValues, "forward-stack-values", forwardStackValues);
+    addBlockPass(blockPasses, opts.numberValues, "number-values", numberValues);
+    addBlockPass(blockPasses, opts.removeDeadCode, "remove-dead-code", removeDeadCode);
+
+    // slide over the lines until no rule matches anymore
+    bool hasChanged = true;
+    for (size_t iteration = 0; iteration < POSTPROCESS_MAX_ITERATIONS && hasChanged; ++iteration) {
+        hasChanged = false;
+        size_t i = 0;
+        while (i < postLines.size()) {
+            if (!applyRules(postLines, i, rules)) {
+                ++i;
+                continue;
+            }
 
-    // close file handles & overwrite temp .tpu file
-    inHandle.close();
-    outHandle.close();
+            // a replacement can complete a window starting just before it
+            hasChanged = true;
+            if (i > 0) --i;
+        }
 
-    // if force overwriting, overwrite
-    if (forceOverwrite) {
-        std::filesystem::remove(inPath);
-        std::filesystem::rename(outPath, inPath);
+        // then look across whole blocks
+        if (!hasChanged) hasChanged = applyBlockPasses(postLines, blockPasses);
     }
-    return 0;
-}
 
-/*************************************************************/
-/*                          TOOLBOX                          */
-/*************************************************************/
+    // write the instructions
+    for (const PostLine& line : postLines)
+        writeInstruction(opts, outHandle, line.text, line.stripped);
 
-void readNextLine(const post_process_opts& opts, std::string& buffer, std::string& strippedBuffer, std::ifstream& inHandle) {
-    buffer.clear(); // clear buffer
+    if (pStats != nullptr) {
+        for (const post_rule_entry_t& entry : rules)
+            pStats->push_back(entry.stats);
+        for (const post_block_pass_entry_t& entry : blockPasses)
+            pStats->push_back(entry.stats);
+    }
 
-    std::string line, strippedLine;
-    while (std::getline(inHandle, line)) {
-        // strip whitespace and comments
-        ltrimString(line); // strip whitespace
-        strippedLine = line;
-        if (line.size() == 0) continue; // skip blank lines
-        
-        // strip comments for temp line (used to match args)
-        stripComments(strippedLine);
-        rtrimString(strippedLine);
+    // still changing after the last iteration means the cap cut it short
+    return !hasChanged;
+}
 
-        // strip comments from actual line if needed
-        if (opts.stripComments) stripComments(line);
-        if (line.size() == 0) continue; // skip blank lines
+// writes the rule counters
+void printPostprocessStats(const std::vector<post_rule_stats_t>& stats, const bool isFixpoint, std::ostream& outHandle) {
+    outHandle << std::left << std::setw(24) << "postprocessor rule" << std::right << std::setw(8) << "hits"
+              << std::setw(10) << "removed" << '\n';
 
-        // update buffer & escape
-        buffer = line;
-        strippedBuffer = strippedLine;
-        return;
+    for (const post_rule_stats_t& entry : stats) {
+        outHandle << std::left << std::setw(24) << entry.name << std::right << std::setw(8) << entry.hits
+                  << std::setw(10) << entry.instsRemoved << '\n';
     }
+
+    if (!isFixpoint)
+        outHandle << "stopped after " << POSTPROCESS_MAX_ITERATIONS << " iterations, the rules were still matching\n";
 }
 
-void writeInstruction(const post_process_opts& opts, std::ofstream& outHandle, const std::string& line, const std::string& strippedLine) {
+/*************************************************************/
+/*                          TOOLBOX                          */
+/*************************************************************/
+
+void writeInstruction(const post_process_opts& opts, std::ostream& outHandle, const std::string& line, const std::string& strippedLine) {
     if (opts.minify) { // remove any leading whitespace
         outHandle << line << '\n';
     } else { // don't minify
         // don't indent labels inside user functions
-        bool isUnindented = (strippedLine.back() == ':' && strippedLine[strippedLine.size()-2] != FUNC_END_LABEL_SUFFIX &&
+        bool isUnindented = (strippedLine.size() > 1 && strippedLine.back() == ':' && strippedLine[strippedLine.size()-2] != FUNC_END_LABEL_SUFFIX &&
             (strippedLine.find(FUNC_LABEL_PREFIX) == 0 || strippedLine.find(RESERVED_LABEL_MAIN) == 0)) || strippedLine.find("section ") == 0;
         if (isUnindented) {
             outHandle << line << '\n'; // don't indent
@@ -339,28 +296,6 @@ void writeInstruction(const post_process_opts& opts, std::ofstream& outHandle, c
     }
 }
 
-// helper for trimming strings in place
-void trimString(std::string& str) {
-    ltrimString(str);
-    rtrimString(str);
-}
-
-void ltrimString(std::string& str) {
-    if (str.size() == 0) return; // skip blank lines
-
-    while (str.length() > 0 && std::isspace(str[0])) {
-        str.erase(str.begin());
-    }
-}
-
-void rtrimString(std::string& str) {
-    if (str.size() == 0) return; // skip blank lines
-
-    while (str.length() > 0 && std::isspace(str.back())) {
-        str.pop_back();
-    }
-}
-
 // strips comments from a given line
 void stripComments(std::string& line) {
     if (line.size() == 0) return; // skip blank lines
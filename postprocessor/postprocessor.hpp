@@ -0,0 +1,82 @@
+#ifndef __POSTPROCESSOR_HPP
+#define __POSTPROCESSOR_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "dataflow.hpp"
+#include "../tlang/ir/ir.hpp"
+
+typedef struct post_process_opts {
+    // removes any identity operations (ex. movw AX, AX) that don't set flags (doesn't remove arithmetic identities that may be used as a buffer)
+    bool removeIdentities       = true; // default: true
+
+    // combines any consecutive imm8 push operations into imm16 pushw operations
+    bool mergeImm8Pushes        = true; // default: true
+
+    // combines any push/pop operations between registers to mov/movw instructions and remove redundant push/pops
+    bool reducePushPops         = true; // default: true
+
+    // combines any consecutive target-less pop/popw instructions to just subtracting from the SP
+    bool dissolvePops           = true; // default: true
+
+    // removes unconditional jumps to the label right after them
+    bool removeFallthroughJumps = true; // default: true
+
+    // forwards pushed values to the pops that read them back across non-clobbering instructions (see dataflow.hpp)
+    bool forwardStackValues     = true; // default: true
+
+    // removes moves, stores & stack address recomputations of values already in place
+    bool numberValues           = true; // default: true
+
+    // removes instructions whose results are never used
+    bool removeDeadCode         = true; // default: true
+
+    // removes any comments from the input file
+    bool stripComments          = false; // default: false
+
+    // removes any unnecessary whitespace (ex. leading tabs)
+    bool minify                 = false; // default: false
+} post_process_opts;
+
+/**
+ * The postprocessor parses each line into an instruction (see tlang/ir) and runs its rules over the list until none
+ * of them match anymore. A rule looks at a window of any number of instructions starting at one position and
+ * replaces it; labels, data and anything that couldn't be parsed end the window. Once the rules stop matching,
+ * the dataflow passes run over each basic block and the rules are tried again.
+ */
+
+// one line of the file being postprocessed
+class PostLine {
+    public:
+        IRInst inst;        // the parsed instruction (RAW if the line isn't one)
+        std::string label;  // set if the line declares a label
+        std::string text;   // the line as written (w/o leading whitespace)
+        std::string stripped; // the line w/o comments or surrounding whitespace
+};
+
+// a rule tries to match the window starting at the given line, returning the number of lines it replaces (0 if no match)
+typedef size_t (*post_rule_fn)(const std::vector<PostLine>&, size_t, std::vector<IRInst>&);
+
+// the number of times each rule matched
+typedef struct post_rule_stats_t {
+    std::string name;
+    size_t hits = 0;
+    long instsRemoved = 0;
+} post_rule_stats_t;
+
+// a safety net against rules that undo each other, hitting it is reported with the stats
+#define POSTPROCESS_MAX_ITERATIONS 16
+
+// splits TPU assembly text into the lines passed to postprocess
+void splitLines(const std::string&, std::vector<std::string>&);
+
+// reduces the number of instructions of the given TPU assembly lines, writing the result (and counting rule hits if given),
+// returns false if it stopped at POSTPROCESS_MAX_ITERATIONS before reaching a fixpoint
+bool postprocess(const std::vector<std::string>&, std::ostream&, const post_process_opts&, std::vector<post_rule_stats_t>* =nullptr);
+
+// writes the rule counters (and a warning if the rules didn't reach a fixpoint)
+void printPostprocessStats(const std::vector<post_rule_stats_t>&, const bool isFixpoint, std::ostream&);
+
+#endif
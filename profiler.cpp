@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <csignal>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <stdexcept>
+#include <unistd.h>
+#include <vector>
+
+#include "profiler.hpp"
+
+static const TPU* pTPU = nullptr;
+static const Memory* pMemory = nullptr;
+
+static profile_sample_t* pSamples = nullptr;
+static volatile sig_atomic_t numSamples = 0;
+static volatile sig_atomic_t numDropped = 0;
+
+// older glibc headers only expose the target thread under its internal name
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+static timer_t timerID;
+static struct sigaction prevAction;
+static bool isProfiling = false;
+
+/****************************************************/
+/*                  signal handler                  */
+/****************************************************/
+
+// snapshots the guest IP & callstack (must stay async-signal-safe)
+static void handleSample(int) {
+    if (numSamples == (sig_atomic_t)PROFILER_MAX_SAMPLES) {
+        numDropped = numDropped + 1;
+        return;
+    }
+
+    profile_sample_t& sample = pSamples[numSamples];
+    sample.IP = pTPU->IP.getValue();
+
+    // copy the innermost return addresses off the callstack
+    const u16 CP = pTPU->CP.getValue();
+    u16 totalFrames = (CP - CALLSTACK_LOWER_ADDR) / 2;
+    u16 depth = std::min<u16>(totalFrames, PROFILER_MAX_DEPTH);
+    u16 addr = CP - depth * 2;
+    for (u16 i = 0; i < depth; i++, addr += 2)
+        sample.frames[i] = (*pMemory)[addr].getValue() | ((*pMemory)[(u16)(addr+1)].getValue() << 8);
+
+    sample.depth = depth;
+    numSamples = numSamples + 1;
+}
+
+/****************************************************/
+/*                profiler interface                */
+/****************************************************/
+
+void startProfiler(const TPU& tpu, const Memory& memory, int sampleFreq) {
+    if (isProfiling) return;
+
+    pTPU = &tpu;
+    pMemory = &memory;
+    pSamples = new profile_sample_t[PROFILER_MAX_SAMPLES];
+    numSamples = numDropped = 0;
+
+    // install the handler
+    struct sigaction action = {};
+    action.sa_handler = handleSample;
+    action.sa_flags = SA_RESTART; // don't interrupt the emulator's sleeps & I/O
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &prevAction) != 0) {
+        killProfiler();
+        throw std::runtime_error("Failed to install profiler signal handler");
+    }
+
+    // deliver the timer's signal to this (the emulator) thread only, since the tracer may have its own thread
+    struct sigevent event = {};
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_notify_thread_id = gettid();
+
+    // wall-clock timer, since the emulator spends most of its time sleeping on the virtual clock
+    if (timer_create(CLOCK_MONOTONIC, &event, &timerID) != 0) {
+        sigaction(SIGPROF, &prevAction, nullptr);
+        killProfiler();
+        throw std::runtime_error("Failed to create profiler timer");
+    }
+
+    const long intervalNs = 1e+9 / sampleFreq;
+    struct itimerspec spec = {};
+    spec.it_interval.tv_sec = spec.it_value.tv_sec = intervalNs / 1'000'000'000;
+    spec.it_interval.tv_nsec = spec.it_value.tv_nsec = intervalNs % 1'000'000'000;
+    if (timer_settime(timerID, 0, &spec, nullptr) != 0) {
+        timer_delete(timerID);
+        sigaction(SIGPROF, &prevAction, nullptr);
+        killProfiler();
+        throw std::runtime_error("Failed to start profiler timer");
+    }
+
+    isProfiling = true;
+}
+
+void stopProfiler() {
+    if (!isProfiling) return;
+    isProfiling = false;
+
+    timer_delete(timerID);
+    sigaction(SIGPROF, &prevAction, nullptr);
+}
+
+void killProfiler() {
+    stopProfiler();
+
+    // free the sample buffer
+    delete[] pSamples;
+    pSamples = nullptr;
+    numSamples = numDropped = 0;
+}
+
+/****************************************************/
+/*                    reporting                     */
+/****************************************************/
+
+void writeProfile(const std::string& outPath, const symbol_map_t& symbolMap) {
+    std::ofstream outHandle(outPath);
+    if (!outHandle.is_open())
+        throw std::runtime_error("Failed to open profile output file: " + outPath);
+
+    // only keep function entry labels for attributing samples
+    symbol_map_t funcMap;
+    loadFunctionSymbolMap(symbolMap, funcMap);
+
+    // aggregate samples by function (self) & by folded callstack
+    std::map<std::string, size_t> selfCounts;
+    std::map<std::string, size_t> foldedCounts;
+    const size_t total = numSamples;
+    for (size_t i = 0; i < total; i++) {
+        const profile_sample_t& sample = pSamples[i];
+        const std::string leaf = getContainingSymbol(funcMap, sample.IP);
+        selfCounts[leaf]++;
+
+        std::string folded;
+        for (u16 j = 0; j < sample.depth; j++)
+            folded += getContainingSymbol(funcMap, sample.frames[j]) + ';';
+        foldedCounts[folded + leaf]++;
+    }
+
+    // sort functions by self samples
+    std::vector<std::pair<std::string, size_t>> flat(selfCounts.begin(), selfCounts.end());
+    std::sort(flat.begin(), flat.end(), [](auto& a, auto& b) { return a.second > b.second; });
+
+    outHandle << "# samples: " << total << ", dropped: " << numDropped << '\n';
+    outHandle << "# self%\tsamples\tfunction\n";
+    for (auto& entry : flat)
+        outHandle << "# " << std::fixed << std::setprecision(2) << (100.0 * entry.second / total) << '\t' << entry.second << '\t' << entry.first << '\n';
+
+    for (auto& entry : foldedCounts)
+        outHandle << entry.first << ' ' << entry.second << '\n';
+
+    outHandle.close();
+}
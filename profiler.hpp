@@ -0,0 +1,45 @@
+#ifndef __PROFILER_HPP
+#define __PROFILER_HPP
+
+#include <string>
+
+#include "util/globals.hpp"
+#include "asm_loader.hpp"
+#include "tpu.hpp"
+#include "memory.hpp"
+
+/**
+ * Statistical sampling profiler for guest code.
+ *
+ * A host interval timer (timer_create + SIGPROF) interrupts the emulator thread, and the signal
+ * handler copies the guest IP and the return addresses on the callstack (CALLSTACK_LOWER_ADDR to CP)
+ * into a preallocated sample buffer. Nothing is allocated or formatted until the profiler is stopped,
+ * so the overhead on TPU::start is limited to the handler itself.
+ */
+
+// default number of samples taken per second of host wall-clock time
+#define PROFILER_SAMPLE_FREQ_HZ 1'000
+
+// the max number of samples held (samples past this are dropped)
+#define PROFILER_MAX_SAMPLES    (1u << 15)
+
+// the max number of callstack frames kept per sample (the innermost frames are kept)
+#define PROFILER_MAX_DEPTH      32
+
+typedef struct profile_sample_t {
+    u16 IP;
+    u16 depth;  // the number of frames stored
+    u16 frames[PROFILER_MAX_DEPTH]; // return addresses, outermost first
+} profile_sample_t;
+
+// used to start & stop the profiler (throws std::runtime_error if the host timer can't be created)
+void startProfiler(const TPU& tpu, const Memory& memory, int sampleFreq = PROFILER_SAMPLE_FREQ_HZ);
+void stopProfiler();
+
+// stops the profiler & frees the collected samples (safe to call on any exit path, and more than once)
+void killProfiler();
+
+// writes the samples collected between the last start & stop as a flat profile followed by folded callstacks (flamegraph.pl format)
+void writeProfile(const std::string& outPath, const symbol_map_t& symbolMap);
+
+#endif
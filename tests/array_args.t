@@ -0,0 +1,42 @@
+#include <stdlib.t>
+
+// arrays are passed as pointers, so after a call the caller only pops a pointer for each array arg
+// and its own locals (declared before and after the array) keep their values
+
+int sum(int* values, const int count) {
+    int total = 0;
+    int i = 0;
+    while (i < count) {
+        total = total + values[i];
+        i = i + 1;
+    }
+    return total;
+}
+
+void fill(int* values, const int count, const int value) {
+    int i = 0;
+    while (i < count) {
+        values[i] = value + i;
+        i = i + 1;
+    }
+}
+
+int main() {
+    int before = 11;
+    int values[5];
+    int after = 22;
+
+    fill(values, 5, 100);
+    const int all = sum(values, 5);
+    const int firstTwo = sum(values, 2);
+
+    print(itoa(all));
+    print(" ");
+    print(itoa(firstTwo));
+    print(" ");
+    print(itoa(before));
+    print(" ");
+    print(itoa(after));
+    print("\n");
+    return before + after;
+}
@@ -0,0 +1,51 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// conditions of if/while/for jump straight on the comparison, and && / || short-circuit, so the right
+// operand only runs (and prints its letter) when it decides the result
+
+int say(const char* letter, const int value) {
+    print(letter);
+    return value;
+}
+
+int main() {
+    int neg = -5;
+    int pos = 5;
+    unsigned int big = 40000;
+    char c = 'x';
+    int* ptr = &pos;
+
+    if (neg < pos) { print("a"); }
+    if (big > pos) { print("b"); }
+    if (neg >= pos) { print("!"); } else { print("c"); }
+    if (c == 'x' && pos != 0) { print("d"); }
+    if (!(neg > 0)) { print("e"); }
+    if (pos) { print("f"); }
+    if (ptr) { print("g"); }
+    if (neg <= -5 || say("!", 1)) { print("h"); }
+    if (neg > 0 && say("!", 1)) { print("!"); } else { print("i"); }
+    print("\n");
+
+    if (say("A", 0) || say("B", 1)) { print("1"); }
+    if (say("C", 1) && say("D", 0)) { print("!"); } else { print("2"); }
+    if (say("E", 0) && say("!", 1) || say("F", 1)) { print("3"); }
+    print("\n");
+
+    int i = 0;
+    int total = 0;
+    while (i < 10 && total <= 20) {
+        total = total + i;
+        i = i + 1;
+    }
+    pn(i);
+    pn(total);
+
+    int down = 0;
+    for (i = 3; i > -3; i = i - 1) {
+        down = down * 2 + (i != 0);
+    }
+    pn(down);
+    print("\n");
+    return 0;
+}
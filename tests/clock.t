@@ -0,0 +1,25 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// CLOCKS_PER_SEC comes from the emulator's own clock frequency, and clock() counts up in cycles of it
+// (it's unsigned, so using it directly in an expression mustn't treat it as negative), & clock32() stores both
+// words of the count (zeroed beforehand so a missing store can't pass)
+
+int main() {
+    const unsigned int perSecond = CLOCKS_PER_SEC;
+    const unsigned int start = clock();
+    unsigned int cycles[2] = {0, 0};
+    clock32(cycles);
+    unsigned int later[2] = {0, 0};
+    clock32(later);
+
+    pn(perSecond / 1000);
+    pn(clock_since(start) > 0);
+    pn(cycles[1]);
+    pn(cycles[0] > start);
+    pn(later[0] > cycles[0]);
+    pn(CLOCKS_PER_SEC / 1000);
+    pn(CLOCKS_PER_SEC > 1000);
+    print("\n");
+    return 0;
+}
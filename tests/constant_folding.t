@@ -0,0 +1,57 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// constant expressions are evaluated at compile time, so they have to wrap & truncate the way the
+// emulator would at runtime
+
+// the arithmetic here folds to literals, so only the casts to char are left for runtime
+// ASM-NOT printConstants: \b(s?mul|s?div|s?shl|s?shr|xor|not|s?cmp)\b
+void printConstants() {
+    const int K = 6 * 7;
+    const char C = 'a' - 'A';
+    const int DIFF = 7 - 10;
+    int scaled = K * 10 + C;
+
+    char wrapped = 100 + 100;
+    char product = 20 * 20;
+    unsigned int carried = 65535 + 2;
+
+    pn(-0b11101001);
+    pn(K);
+    pn(scaled);
+    pn(wrapped);
+    pn(product);
+    pn(carried);
+    pn(DIFF / 2);
+    pn(-17 % 5);
+    pn(1 << 10);
+    pn(100 >> 2);
+    pn(-1 < 1);
+    pn((unsigned int) -1 > 1);
+    pn(~0);
+    pn(3855 & 255 | 4096 ^ 4097);
+    pn(!0 + !5);
+    pn(3 < 4 && 4 < 3 || 2 == 2);
+    print("\n");
+}
+
+int main() {
+    printConstants();
+
+    // the same operations at runtime
+    char hundred = 100;
+    char twenty = 20;
+    unsigned int max = 65535;
+    int seven = 7;
+    int minus17 = -17;
+    char sum = hundred + hundred;
+    char square = twenty * twenty;
+    int diff = seven - 10;
+    pn(sum);
+    pn(square);
+    pn(max + 2);
+    pn(diff / 2);
+    pn(minus17 % 5);
+    print("\n");
+    return 6 * 7;
+}
@@ -0,0 +1,40 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// precedence, associativity & grouping, which the expression parser has to get right in one pass
+
+int sub(const int a, const int b) {
+    return a - b;
+}
+
+int main() {
+    int a = 10;
+    int b = 3;
+    int c = 0;
+    int arr[4] = {1, 2, 3, 4};
+
+    pn(a - b - 1);
+    pn(a - (b - 1));
+    pn((a - b) - 1);
+    pn((a) / b);
+    pn(100 / a / 2);
+    pn(a + b * 2);
+    pn((a + b) * 2);
+    pn(a - b * 2 + 1);
+    pn(a % b * 2);
+    pn(1 + 2 << 2);
+    pn(a > b == b < a);
+    pn(a & 6 | 1);
+    pn(-a + b);
+    pn(-(a + b));
+    pn(!a || b && !c);
+    pn(sub(sub(a, b), sub(b, 1)));
+    pn(sub(arr[3], arr[arr[0]]) * -b);
+    pn((char) 300 + 1);
+    pn(sizeof(int) + sizeof(arr));
+
+    a = b = c = 7;
+    pn(a + b + c);
+    print("\n");
+    return sub(a, 2 * b);
+}
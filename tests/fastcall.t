@@ -0,0 +1,65 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// values of up to 2 bytes are returned in AX, and arguments are cast to their parameters' sizes, so
+// calls nested in arguments & operands mustn't clobber each other and overloads take exact matches
+
+int twice(const int x) {
+    return x + x;
+}
+
+char lower(const char x) {
+    return x + 32;
+}
+
+bool isNeg(const int x) {
+    return x < 0;
+}
+
+int* pick(int* a, int* b, const int first) {
+    if (first) {
+        return a;
+    }
+    return b;
+}
+
+int add(const int a, const int b) {
+    return a + b;
+}
+
+int which(const int x) {
+    return 1;
+}
+
+int which(const char x) {
+    return 2;
+}
+
+int main() {
+    char c = 'A';
+    int big = 300;
+    int x = 7;
+    int y = 9;
+
+    pn(twice(big));
+    pn(lower(c));
+    pn(isNeg(-x));
+    pn(isNeg(x));
+    int* p = pick(&x, &y, 0);
+    pn(*p);
+    int sum = add(twice(1), twice(2));
+    pn(sum);
+    pn(big + twice(x));
+    print("\n");
+
+    pn(twice(c));
+    pn(lower(big));
+    sum = add(c, big);
+    pn(sum);
+    sum = add(big, c);
+    pn(sum);
+    pn(which(c));
+    pn(which(big));
+    print("\n");
+    return add(x, y);
+}
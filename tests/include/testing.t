@@ -0,0 +1,11 @@
+/**
+ * Helpers shared by the tests (include as "include/testing.t").
+ */
+
+#include <stdlib.t>
+
+// prints a number followed by a space
+void pn(const int x) {
+    print(itoa(x));
+    print(" ");
+}
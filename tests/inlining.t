@@ -0,0 +1,46 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// small functions (and ones marked inline) are substituted at their call sites, which must still
+// evaluate each argument exactly once and keep writes to parameters local
+
+int sq(const int x) {
+    return x * x;
+}
+
+int bump(int* counter) {
+    *counter = *counter + 1;
+    return *counter;
+}
+
+inline int clampSum(int a, int b, const int limit) {
+    a = a + b;
+    if (a > limit) {
+        return limit;
+    }
+    b = 0;
+    return a + b;
+}
+
+// ASM-NOT main: call (sq|bump|clampSum|min|max)$
+int main() {
+    int n = 0;
+    int a = 3;
+    int b = 4;
+
+    int r = min(a, b);
+    pn(r);
+    r = max(a, -b);
+    pn(r);
+    pn(sq(a + 1));
+    pn(sq(bump(&n)));
+    pn(sq(bump(&n)));
+    pn(n);
+    r = clampSum(a, b, 100);
+    pn(r);
+    r = clampSum(a, b, 5);
+    pn(r);
+    pn(sq(sq(2)));
+    print("\n");
+    return 0;
+}
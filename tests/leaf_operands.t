@@ -0,0 +1,48 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// leaf operands (literals & plain locals) are loaded straight into registers, so operand order,
+// widths and signedness have to survive without the stack in between
+
+// a variable is still read before a later operand's call or assignment changes it
+int bump(int* p) {
+    *p = *p + 10;
+    return 1;
+}
+
+int main() {
+    int a = 1000;
+    int b = -7;
+    char c = 'A';
+    char d = -3;
+    unsigned int u = 40000;
+
+    pn(a - b);
+    pn(b - a);
+    pn(a / b);
+    pn(a % 7);
+    pn(a * b);
+    pn(c + d);
+    pn(c - 100);
+    pn(a + c);
+    pn(u / 8);
+    pn(b < a);
+    pn(a < b);
+    pn(a == 1000);
+    pn(c != 'A');
+    print("\n");
+
+    int x = 1;
+    int y = x + bump(&x);
+    pn(y);
+    pn(x - bump(&x));
+    pn(x * (x = 3));
+    pn(x < bump(&x));
+    if (x == bump(&x)) {
+        pn(0);
+    } else {
+        pn(x);
+    }
+    print("\n");
+    return b;
+}
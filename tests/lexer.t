@@ -0,0 +1,36 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+/* identifiers that start with keywords, literals in every base & escapes,
+   and comment markers inside strings, which the lexer has to classify in one scan */
+
+int main() {
+    int intValue = 0x1F;            // hex
+    int iffy = 0b1010;              // binary
+    int returned = 017;             // not octal: leading zeros are ignored
+    int sizeofThing = sizeof(int);
+    bool truex = true;
+    bool falsey = false;
+    char charm = '\'';
+    char whiler = '\\';
+	int	tabbed	=	-42;            /* tabs */
+    int constant = intValue+iffy*returned;
+    int masked = 0x0F0F & 0x00FF;   // not an address
+
+    pn(intValue);
+    pn(iffy);
+    pn(returned);
+    pn(sizeofThing);
+    pn(truex);
+    pn(falsey);
+    pn(charm);
+    pn(whiler);
+    pn(tabbed);
+    pn(constant);
+    pn(masked);
+    print("\n");
+
+    print("/* not a comment */ // nor this\n");
+    print("tab:\tquote:\" end\n");
+    return 'A'/*inline*/-'B';
+}
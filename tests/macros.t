@@ -0,0 +1,36 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// object-like and function-like macros are expanded per identifier, so only whole identifiers outside
+// string & char literals expand, arguments may hold nested parentheses & commas, and bodies expand in turn
+
+#define N 5
+#define NN (N * 2)
+#define SQ(x) ((x) * (x))
+#define ADD3(a, b, c) ((a) + (b) + (c))
+#define SCALE 3
+#define SCALE 4
+#define MSG "N SQ(N)\n"
+
+int sub(const int a, const int b) {
+    return a - b;
+}
+
+int main() {
+    int NNN = 7;
+    int N_ = 8;
+    int sum = ADD3(1, sub(10, 4), SQ(2));
+    int square = SQ(sub(N, 1));
+
+    pn(N);
+    pn(NN);
+    pn(SQ(N + 1));
+    pn(sum);
+    pn(square);
+    pn(SCALE);
+    pn(NNN + N_);
+    pn('N');
+    print("\n");
+    print(MSG);
+    return SQ(3);
+}
@@ -0,0 +1,60 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// temporaries that have to survive a multiply or divide are kept in spare registers instead of the stack,
+// so locals read while they're held (and anything pushed above them) must still find their slots
+
+// b & c are kept in SI & DI, so a temporary takes over SI once b is last read
+// ASM mixed: movw SI, AX
+int mixed(int a, int b, int c) {
+    return (a - b) * (c + 3) + (a * 7) / (c + 1) + (b - c) % (a + 2);
+}
+
+// both operands of the outer multiply are held at once
+int nested(int a, int b) {
+    return ((a + 1) * (b - 2)) * ((a - b) * (a + b));
+}
+
+char bytes(char a, char b) {
+    return (a - b) * (b + 2) - (a / (b - 1));
+}
+
+int sq(int x) {
+    return x * x;
+}
+
+// a call in between keeps the temporary on the stack
+int aroundCall(int a, int b) {
+    return (a + b) * (sq(a) - b);
+}
+
+int subscripts(int* arr, int n) {
+    int total = 0;
+    int i = 0;
+    while (i < n) {
+        total = total + arr[i] * (arr[n - 1 - i] - i) + (i * 3) / (arr[i] + 100);
+        i = i + 1;
+    }
+    return total;
+}
+
+int main() {
+    pn(mixed(20, 6, 4));
+    pn(mixed(-9, 5, 2));
+    pn(nested(5, 9));
+    pn(nested(-4, 3));
+    pn(bytes(20, 4));
+    pn(bytes(-12, 3));
+    pn(aroundCall(7, 3));
+    print("\n");
+
+    int arr[8];
+    int i = 0;
+    while (i < 8) {
+        arr[i] = i * 5 - 11;
+        i = i + 1;
+    }
+    pn(subscripts(arr, 8));
+    print("\n");
+    return 0;
+}
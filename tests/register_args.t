@@ -0,0 +1,77 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// the last one or two args are passed in CX & DX: a function without calls keeps its ints there in SI & DI
+// (even when assigned), the rest are pushed to its frame on entry & popped by the caller with the pushed args
+
+int twice(const int x) {
+    return x + x;
+}
+
+// ASM sumTo: movw SI, CX
+// ASM sumTo: movw DI, DX
+// ASM-NOT sumTo: pushw [CD]X
+int sumTo(int from, int to) {
+    int sum = 0;
+    while (from <= to) {
+        sum = sum + from;
+        from = from + 1;
+    }
+    return sum;
+}
+
+// only ints stay in registers, the char is pushed
+// ASM offsetSum: movw SI, CX
+// ASM offsetSum: push DL
+int offsetSum(const int* values, const int n, const char offset) {
+    int total = 0;
+    int i;
+    for (i = 0; i < n; i = i + 1) {
+        total = total + values[i] + offset;
+    }
+    return total;
+}
+
+// the pointed to param stays in the frame
+// ASM bump: movw SI, CX
+// ASM bump: pushw DX
+int bump(int a, int b) {
+    int* p = &b;
+    *p = *p + a;
+    int i;
+    for (i = 0; i < 2; i = i + 1) {
+        a = a + 1;
+    }
+    return a * b;
+}
+
+// the calls clobber CX & DX, so both params are pushed
+// ASM viaCalls: pushw CX
+// ASM viaCalls: pushw DX
+int viaCalls(int a, int b) {
+    int i;
+    for (i = 0; i < 1; i = i + 1) {
+        a = twice(a);
+    }
+    return sumTo(a, b) - sumTo(b, a + b);
+}
+
+int main() {
+    char c = 'A';
+    int x = 7;
+    int y = 9;
+    int arr[4] = {1, 2, 3, 4};
+
+    pn(sumTo(1, 10));
+    pn(sumTo(x, y));
+    pn(sumTo(x = 2, x + 1));
+    pn(x);
+    print("\n");
+
+    pn(offsetSum(arr, 4, 'A' - 64));
+    pn(offsetSum(arr, y - 6, c));
+    pn(bump(3, 4));
+    pn(viaCalls(2, 5));
+    print("\n");
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// a return from a nested scope pops the function's locals down to its params, which don't include the ones kept
+// in SI & DI (so neither the caller's locals nor its stack are disturbed)
+
+// ASM earlyOut: movw SI, CX
+// ASM earlyOut: movw DI, DX
+int earlyOut(int a, int b) {
+    int t = a * 3;
+    if (a > b) {
+        int u = a + b;
+        int w = u * 2;
+        return w + t;
+    }
+    return t;
+}
+
+int main() {
+    int total = 0;
+    int i;
+    for (i = 0; i < 50; i = i + 1) {
+        total = total + earlyOut(i, 3);
+    }
+    pn(total);
+    pn(i);
+    print("\n");
+    return 0;
+}
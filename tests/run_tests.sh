@@ -0,0 +1,165 @@
+#!/bin/bash
+# Runs every test with a NAME.expected file next to it and diffs the output (run via `make test`).
+#
+# NAME.t is compiled once per entry of TCC_VARIANTS, from every optimization down to none, and every
+# build must match. NAME.tpu is run as written and again after each entry of POSTPROC_VARIANTS.
+#
+# A .t test can also check the assembly of its fully optimized build: `// ASM <func>: <regex>` requires
+# a line of <func> to match the (extended) regex and `// ASM-NOT <func>: <regex>` forbids one. Call
+# targets are written as the called function's name (ex. `call sq`). `// SKIP-WITH <flag>` leaves out the
+# builds that pass <flag> (ex. a recursion that only fits the stack as tail calls).
+#
+# dataflow_* .tpu tests must also come out of the postprocessor shorter than with -no-dataflow.
+#
+# The emulator's register dump is dropped from the output (the exit status line is kept), so tests
+# should end their output with a newline. Helpers shared by the .t tests live in tests/include.
+
+cd "$(dirname "$0")/.."
+shopt -s nullglob
+
+EMU=./build/main.o
+TCC=./tlang/tcc
+POSTPROC=./build/postproc
+TIMING=references/cycle_profiles/uniform.txt
+
+# flags of each build of a .t test (the first one is checked against its ASM lines)
+TCC_VARIANTS=(
+    ""
+    "-no-inline"
+    "-no-inline -no-fastcall"
+    "-skip-post -skip-passes -no-inline -no-fastcall -no-tail-calls -no-regalloc"
+)
+
+# flags of each postprocessed build of a .tpu test
+POSTPROC_VARIANTS=(
+    ""
+    "-no-dataflow"
+)
+
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+cp -r tests/include "$TMP/include"
+
+# runs a .tpu file, printing its output & exit status
+run() {
+    "$EMU" "$1" -timing "$TIMING" </dev/null 2>&1 | awk '{ lines[NR] = $0 } END {
+        for (i = 1; i <= NR-6; i++) print lines[i]
+        print lines[NR]
+    }'
+}
+
+# compiles a .t file with the given flags to the given .tpu path
+compile() {
+    local src=$1 out=$2
+    shift 2
+    cp "$src" "$TMP/build.t"
+    rm -f "$TMP/build.tpu"
+    "$TCC" "$TMP/build.t" "$@" >/dev/null || return 1
+    mv "$TMP/build.tpu" "$out"
+}
+
+# postprocesses a .tpu file with the given flags to the given path
+postprocess() {
+    local src=$1 out=$2
+    shift 2
+    "$POSTPROC" "$src" -o "$out" "$@" >/dev/null
+}
+
+# diffs a run against the expected output
+check() {
+    local name=$1 variant=$2 tpu=$3
+    if ! run "$tpu" | diff -u "tests/$name.expected" - >"$TMP/diff"; then
+        echo "FAIL: $name ($variant)"
+        cat "$TMP/diff"
+        return 1
+    fi
+}
+
+# counts the instructions (non-blank, non-comment, non-label lines) in a .tpu file
+count() {
+    grep -cvE '^\s*(;.*)?$|:\s*(;.*)?$' "$1"
+}
+
+# prints the body of a function compiled by TCC (which names each function in a comment above its label)
+body() {
+    awk -v fn="$2" '
+        NR == FNR {
+            if ($0 ~ /^[ \t]*; [A-Za-z_][A-Za-z0-9_]*$/) { name = $2; named = 1; next }
+            if (named && $1 ~ /^[^;]+:/) { label = $1; sub(/:.*/, "", label); names[label] = name }
+            named = 0
+            next
+        }
+        /^[ \t]*; [A-Za-z_][A-Za-z0-9_]*$/ { inside = ($2 == fn); next }
+        /^section / { inside = 0 }
+        inside {
+            if ($1 == "call" && ($2 in names)) $0 = "    call " names[$2]
+            print
+        }' "$1" "$1"
+}
+
+# checks a .t test's ASM lines against the given build of it
+checkAsm() {
+    local name=$1 tpu=$2 ok=true kind fn regex
+    while IFS=$'\t' read -r kind fn regex; do
+        body "$tpu" "$fn" >"$TMP/body"
+        if [ ! -s "$TMP/body" ]; then
+            echo "FAIL: $name (no function $fn in the assembly)"; ok=false
+        elif [ "$kind" = ASM ] && ! grep -qE "$regex" "$TMP/body"; then
+            echo "FAIL: $name (no line of $fn matches: $regex)"; ok=false
+        elif [ "$kind" = ASM-NOT ] && grep -E "$regex" "$TMP/body" >"$TMP/match"; then
+            echo "FAIL: $name (a line of $fn matches: $regex)"; cat "$TMP/match"; ok=false
+        fi
+    done < <(sed -nE 's|^\s*// (ASM(-NOT)?) ([A-Za-z_][A-Za-z0-9_]*): (.*)$|\1\t\3\t\4|p' "tests/$name.t")
+    $ok
+}
+
+passed=0
+failed=0
+for expected in tests/*.expected; do
+    name=$(basename "$expected" .expected)
+    ok=true
+
+    if [ -f "tests/$name.t" ]; then
+        skipped=$(sed -nE 's|^\s*// SKIP-WITH (.*)$|\1|p' "tests/$name.t")
+        for i in "${!TCC_VARIANTS[@]}"; do
+            flags=${TCC_VARIANTS[$i]}
+            variant="tcc${flags:+ $flags}"
+            for flag in $skipped; do
+                [[ " $flags " == *" $flag "* ]] && continue 2
+            done
+            if ! compile "tests/$name.t" "$TMP/$i.tpu" $flags; then
+                echo "FAIL: $name ($variant)"; ok=false
+                continue
+            fi
+            check "$name" "$variant" "$TMP/$i.tpu" || ok=false
+            [ "$i" -eq 0 ] && { checkAsm "$name" "$TMP/$i.tpu" || ok=false; }
+        done
+    elif [ -f "tests/$name.tpu" ]; then
+        check "$name" "as written" "tests/$name.tpu" || ok=false
+
+        for i in "${!POSTPROC_VARIANTS[@]}"; do
+            flags=${POSTPROC_VARIANTS[$i]}
+            variant="postproc${flags:+ $flags}"
+            if ! postprocess "tests/$name.tpu" "$TMP/post$i.tpu" $flags; then
+                echo "FAIL: $name ($variant)"; ok=false
+                continue
+            fi
+            check "$name" "$variant" "$TMP/post$i.tpu" || ok=false
+        done
+
+        if [[ $name == dataflow_* ]] && [ "$(count "$TMP/post0.tpu")" -ge "$(count "$TMP/post1.tpu")" ]; then
+            echo "FAIL: $name (dataflow passes removed nothing)"; ok=false
+        fi
+    else
+        echo "FAIL: $name (no $name.t or $name.tpu)"; ok=false
+    fi
+
+    if $ok; then
+        passed=$((passed+1))
+    else
+        failed=$((failed+1))
+    fi
+done
+
+echo "$passed passed, $failed failed."
+[ $failed -eq 0 ]
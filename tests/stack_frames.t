@@ -0,0 +1,76 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// runs of uninitialized locals are allocated with a single adjustment, and a local declared after one
+// that its body no longer references takes over that slot, so values in reused slots, sibling scopes,
+// loop bodies & recursive frames mustn't leak into each other
+
+// each local is dead once the one after next is declared, so all of them fit in two slots
+// (returns how far above the caller's local the last one ends up)
+int chained(const int seed, int* callerLocal) {
+    int a = seed + 1;
+    int b = a * 2;
+    int c = b + 3;
+    int d = c * 2;
+    int e = d + 5;
+    int f = e * 2;
+    int g = f + 7;
+    int h = g * 2;
+    int last = h;
+    pn(last);
+    return (int) &last - (int) callerLocal;
+}
+
+int sumTo(const int n) {
+    int local[3] = {n, n, n};
+    if (n == 0) {
+        return 0;
+    }
+    int rest = sumTo(n - 1);
+    return local[0] + rest;
+}
+
+int main() {
+    int outer = 1;
+    int i;
+    int total;
+
+    if (outer) {
+        int a = 10;
+        char b = 'b';
+        outer = outer + a + b;
+    }
+    if (outer) {
+        int c = 20;
+        int d[3] = {1, 2, 3};
+        outer = outer + c + d[0] + d[2];
+    }
+    pn(outer);
+
+    total = 0;
+    for (i = 0; i < 4; i = i + 1) {
+        int sq = i * i;
+        if (i % 2 == 0) {
+            int half = sq / 2;
+            total = total + half;
+        } else {
+            int neg = -1;
+            total = total + sq * neg;
+        }
+    }
+    pn(total);
+
+    int x = 5;
+    if (x) {
+        int y = x + 1;
+        pn(y);
+    }
+    pn(x);
+    pn(sumTo(20));
+
+    // the args & a few slots (w/o reuse, the locals alone would take 18 bytes)
+    const int depth = chained(1, &x);
+    pn(depth < 16);
+    print("\n");
+    return outer;
+}
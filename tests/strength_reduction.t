@@ -0,0 +1,70 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// multiplies, divides & modulos by constants are lowered to shifts, masks & multiply-highs, which have
+// to give the same results as mul/div for negative and unsigned operands (chars are zero-extended
+// when mixed with ints, so c * 2 is 156 * 2)
+
+// positive powers of two never need a mul or div
+// ASM-NOT byPowersOfTwo: \bs?(mul|div)\b
+void byPowersOfTwo(const int n, const int p, const unsigned int u, const char c) {
+    pn(n * 0);
+    pn(n * 1);
+    pn(n * 16);
+    pn(c * 2);
+    pn(n / 8);
+    pn(n % 8);
+    pn(p / 8);
+    pn(p % 8);
+    pn(u / 16);
+    pn(u % 16);
+    pn(c / 4);
+    print("\n");
+}
+
+// whether these are lowered depends on the constant & the cycle costs
+void byOtherConstants(const int n, const int p, const unsigned int u) {
+    pn(n * 3);
+    pn(p * 10);
+    pn(p * -4);
+    pn(n / 7);
+    pn(n % 7);
+    pn(p / 10);
+    pn(p % 10);
+    pn(u / 7);
+    pn(u % 7);
+    print("\n");
+}
+
+int main() {
+    int n = -1234;
+    int p = 1234;
+    unsigned int u = 60000;
+    char c = -100;
+    int arr[5] = {10, 20, 30, 40, 50};
+    int* ptr = arr;
+
+    byPowersOfTwo(n, p, u, c);
+    byOtherConstants(n, p, u);
+
+    pn(*(ptr + 3));
+    pn(*(arr + 4) - *(ptr + 1));
+    print("\n");
+
+    // the same operations through mul/div
+    int two = 2;
+    int three = 3;
+    int four = 4;
+    int seven = 7;
+    int eight = 8;
+    pn(n * three);
+    pn(c * two);
+    pn(n / eight);
+    pn(n % eight);
+    pn(n / seven);
+    pn(n % seven);
+    pn(u / seven);
+    pn(c / four);
+    print("\n");
+    return 0;
+}
@@ -0,0 +1,9 @@
+// f tail calls g with more args than f has params, so g's second arg has no slot of f's to be passed through in
+
+int h(int z) { return z; }
+
+int g(char a, char b) { return h(a) + b; }
+
+int f(int x) { return g(x, 3); }
+
+int main() { return f(4); }
@@ -0,0 +1,57 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// calls in tail position reuse the caller's frame, so their arguments are reshuffled in place (including
+// swaps, calls with more or fewer parameters than the caller, and chars) before jumping to the callee
+
+int gcd(const int a, const int b) {
+    if (b == 0) {
+        return a;
+    }
+    return gcd(b, a % b);
+}
+
+int sum(const int n, const int acc) {
+    if (n == 0) {
+        return acc;
+    }
+    return sum(n - 1, acc + n);
+}
+
+int parity(const int n) {
+    if (n < 2) {
+        return n;
+    }
+    return parity(n - 2);
+}
+
+int weigh(const char c, const int scale, const int offset) {
+    return c * scale + offset;
+}
+
+int scaled(const int x) {
+    return weigh('a', x, -x);
+}
+
+char pickChar(const int i, const char a, const char b) {
+    if (i > 0) {
+        return pickChar(i - 1, b, a);
+    }
+    return a;
+}
+
+int main() {
+    int r = gcd(1071, 462);
+    pn(r);
+    r = gcd(17, 5);
+    pn(r);
+    r = sum(250, 0);
+    pn(r);
+    pn(parity(501));
+    pn(parity(600));
+    pn(scaled(3));
+    const char c = pickChar(3, 'x', 'y');
+    print(itoa(c));
+    print("\n");
+    return gcd(48, 18);
+}
@@ -0,0 +1,19 @@
+#include <stdlib.t>
+#include "include/testing.t"
+
+// 5000 nested calls would overflow the stack & callstack, so this only runs if the recursion reuses one frame
+// SKIP-WITH -no-tail-calls
+
+int count(const int n, const int acc) {
+    if (n == 0) {
+        return acc;
+    }
+    return count(n - 1, acc + 2);
+}
+
+int main() {
+    const int total = count(5000, 0);
+    pn(total);
+    print("\n");
+    return 0;
+}
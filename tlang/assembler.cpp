@@ -1,9 +1,17 @@
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "assembler.hpp"
 #include "ast/ast.hpp"
+#include "ir/builder.hpp"
+#include "ir/ir.hpp"
+#include "ir/passes.hpp"
+#include "ir/regalloc.hpp"
+#include "strength_reduction.hpp"
 #include "util/toolbox.hpp"
 #include "util/token.hpp"
 #include "util/type.hpp"
@@ -16,9 +24,168 @@ static size_t nextJMPLabelID = 0;
 static size_t nextStringDataID = 0;
 static label_map_t labelMap;
 static std::vector<DataElem> dataElements;
+static PassManager passManager;
+static std::vector<const ASTFunction*> inlineStack; // functions currently being substituted at a call site
+static std::vector<std::pair<IROperand, size_t>> pushedValues; // virtual registers on the stack & the scope size after each
+static std::unordered_map<symbol_t, std::pair<IROperand, Type>> registerVars; // params of the current function kept in registers instead of the frame
+
+// shorthands for IR operands
+static IROperand irReg(const std::string& name) { return IROperand::makeReg(name); }
+static IROperand irReg(const char letter, const size_t size) { return IROperand::makeReg(std::string(1, letter) + (size == 2 ? 'X' : 'L')); }
+static IROperand irImm(const int value) { return IROperand::makeImm(value); }
+static IROperand irLabel(const std::string& name) { return IROperand::makeLabel(name); }
+static IROperand irStack(const size_t offset) { return IROperand::makeOffset("SP", -(int)offset); } // [SP-offset]
+static IROperand irPointer(const size_t offset) { return IROperand::makeOffset("BP", offset); } // [BP+offset]
+
+// the 8 or 16-bit version of an instruction
+static IROpcode getMoveOp(const size_t size) { return size == 2 ? IROpcode::MOVW : IROpcode::MOV; }
+static IROpcode getPushOp(const size_t size) { return size == 2 ? IROpcode::PUSHW : IROpcode::PUSH; }
+static IROpcode getPopOp(const size_t size) { return size == 2 ? IROpcode::POPW : IROpcode::POP; }
+
+// the register a function's param is passed in (CX for the first register param, DX for the second)
+static IROperand irArgReg(const AssembledFunc& func, const size_t i, const size_t size) {
+    return irReg(i + func.getNumRegisterParams() == func.getParamTypes().size() ? 'C' : 'D', size);
+}
+
+// the register a variable is kept in instead of the stack & its type, or nullptr if it's on the stack
+static const std::pair<IROperand, Type>* findRegisterVar(const symbol_t id) {
+    auto itr = registerVars.find(id);
+    return itr == registerVars.end() ? nullptr : &itr->second;
+}
+
+// the jump taken after "cmp A, B" when "A <op> B" is true (or false)
+static IROpcode getCompareJump(const TokenType opType, const bool isUnsigned, const bool jumpIfTrue) {
+    switch (opType) {
+        case TokenType::OP_EQ:  return jumpIfTrue ? IROpcode::JZ : IROpcode::JNZ;
+        case TokenType::OP_NEQ: return jumpIfTrue ? IROpcode::JNZ : IROpcode::JZ;
+        case TokenType::OP_LT:  return isUnsigned ? (jumpIfTrue ? IROpcode::JB : IROpcode::JAE) : (jumpIfTrue ? IROpcode::JL : IROpcode::JGE);
+        case TokenType::OP_GT:  return isUnsigned ? (jumpIfTrue ? IROpcode::JA : IROpcode::JBE) : (jumpIfTrue ? IROpcode::JG : IROpcode::JLE);
+        case TokenType::OP_LTE: return isUnsigned ? (jumpIfTrue ? IROpcode::JBE : IROpcode::JA) : (jumpIfTrue ? IROpcode::JLE : IROpcode::JG);
+        case TokenType::OP_GTE: return isUnsigned ? (jumpIfTrue ? IROpcode::JAE : IROpcode::JB) : (jumpIfTrue ? IROpcode::JGE : IROpcode::JL);
+        default: throw TDevException("Invalid comparison in getCompareJump!");
+    }
+}
+
+// pushes a register, immediate or label as a new virtual register (which stays on the stack unless it's given a register)
+static void pushValue(IRBuilder& ir, Scope& scope, const IROperand& value, const size_t size) {
+    // values above the top of the stack were dropped without being popped
+    while (pushedValues.size() > 0 && pushedValues.back().second > scope.size())
+        pushedValues.pop_back();
+
+    const IROperand vreg = ir.makeVReg(size * 8);
+    ir.emit(getMoveOp(size), vreg, value);
+    scope.addPlaceholder(size);
+    pushedValues.push_back({vreg, scope.size()});
+}
+
+// pops the top of the stack into a register, reading the virtual register it was pushed as if there is one
+static void popValue(IRBuilder& ir, Scope& scope, const IROperand& dest, const size_t size) {
+    // values above the top of the stack were dropped without being popped
+    while (pushedValues.size() > 0 && pushedValues.back().second > scope.size())
+        pushedValues.pop_back();
+
+    if (pushedValues.size() > 0 && pushedValues.back().second == scope.size() && pushedValues.back().first.width == size * 8) {
+        ir.emit(getMoveOp(size), dest, pushedValues.back().first);
+        pushedValues.pop_back();
+    } else {
+        ir.emit(getPopOp(size), dest);
+    }
+    scope.pop(size);
+}
+
+// visits every node of a subtree (including expressions held outside of the children), stopping early if visit returns false
+static bool visitNodes(ASTNode* pNode, const std::function<bool(ASTNode&)>& visit) {
+    if (pNode == nullptr) return true;
+    if (!visit(*pNode)) return false;
+
+    // expressions held outside of the children
+    bool isDone = true;
+    switch (pNode->getNodeType()) {
+        case ASTNodeType::IF_CONDITION: isDone = visitNodes(static_cast<ASTIfCondition*>(pNode)->pExpr, visit); break;
+        case ASTNodeType::ELSE_IF_CONDITION: isDone = visitNodes(static_cast<ASTElseIfCondition*>(pNode)->pExpr, visit); break;
+        case ASTNodeType::WHILE_LOOP: isDone = visitNodes(static_cast<ASTWhileLoop*>(pNode)->pExpr, visit); break;
+        case ASTNodeType::FOR_LOOP: {
+            ASTForLoop* pLoop = static_cast<ASTForLoop*>(pNode);
+            isDone = visitNodes(pLoop->pExprA, visit) && visitNodes(pLoop->pExprB, visit) && visitNodes(pLoop->pExprC, visit);
+            break;
+        }
+        case ASTNodeType::VAR_DECLARATION: isDone = visitNodes(static_cast<ASTVarDeclaration*>(pNode)->pExpr, visit); break;
+        default: break;
+    }
+
+    ASTTypedNode* pTypedNode = dynamic_cast<ASTTypedNode*>(pNode);
+    if (pTypedNode != nullptr)
+        for (ASTArraySubscript* pSub : pTypedNode->getSubscripts())
+            isDone = isDone && visitNodes(pSub, visit);
 
-AssembledFunc::AssembledFunc(const std::string& funcName, const ASTFunction& func) {
+    for (size_t i = 0; i < pNode->size() && isDone; ++i)
+        isDone = visitNodes(pNode->at(i), visit);
+    return isDone;
+}
+
+// true if evaluating the subtree may write memory (calls, assignments or raw assembly)
+static bool hasSideEffects(ASTNode& node) {
+    return !visitNodes(&node, [](ASTNode& sub) {
+        const ASTNodeType nodeType = sub.getNodeType();
+        if (nodeType == ASTNodeType::FUNCTION_CALL || nodeType == ASTNodeType::ASM || nodeType == ASTNodeType::ASM_INST) return false;
+        return !(nodeType == ASTNodeType::BIN_OP && isTokenAssignOp(static_cast<ASTOperator*>(&sub)->getOpTokenType()));
+    });
+}
+
+// counts the AST nodes of a function body & whether it's straight-line code without calls,
+// returns false if it calls the function itself or contains raw assembly
+static bool countInlineNodes(ASTNode* pNode, const symbol_t funcName, size_t& count, bool& isLeaf) {
+    return visitNodes(pNode, [&](ASTNode& node) {
+        count++;
+
+        // raw assembly may declare labels, which can't be duplicated
+        const ASTNodeType nodeType = node.getNodeType();
+        if (nodeType == ASTNodeType::ASM) return false;
+        if (nodeType == ASTNodeType::FUNCTION_CALL && node.id == funcName) return false;
+        if (nodeType == ASTNodeType::FUNCTION_CALL || nodeType == ASTNodeType::WHILE_LOOP || nodeType == ASTNodeType::FOR_LOOP)
+            isLeaf = false;
+        return true;
+    });
+}
+
+// true if the subtree makes calls or contains raw assembly (either of which may use any register)
+static bool hasCallsOrAssembly(ASTNode& head) {
+    return !visitNodes(&head, [](ASTNode& node) {
+        const ASTNodeType nodeType = node.getNodeType();
+        return nodeType != ASTNodeType::FUNCTION_CALL && nodeType != ASTNodeType::ASM && nodeType != ASTNodeType::ASM_INST;
+    });
+}
+
+// true if the variable is only ever written by assignments straight to it, so its address is never needed
+static bool isOnlyAssignedDirectly(ASTNode& head, const symbol_t id, const Type& type) {
+    size_t numLValues = 0, numAssignments = 0;
+    visitNodes(&head, [&](ASTNode& node) {
+        if (node.getNodeType() == ASTNodeType::IDENTIFIER && node.id == id && static_cast<ASTTypedNode*>(&node)->isLValue())
+            ++numLValues;
+
+        if (node.getNodeType() == ASTNodeType::BIN_OP && static_cast<ASTOperator*>(&node)->getOpTokenType() == TokenType::ASSIGN) {
+            ASTTypedNode& lvalue = *static_cast<ASTTypedNode*>(static_cast<ASTOperator*>(&node)->left());
+            if (lvalue.getNodeType() == ASTNodeType::IDENTIFIER && lvalue.id == id && lvalue.getNumSubscripts() == 0 &&
+                lvalue.getType() == type) ++numAssignments;
+        }
+        return true;
+    });
+    return numLValues == numAssignments;
+}
+
+// maps each identifier referenced in a body to the index of the last of its children that references it
+static void collectLastReferences(ASTNode& head, std::unordered_map<symbol_t, size_t>& lastReferences) {
+    for (size_t i = 0; i < head.size(); ++i) {
+        visitNodes(head.at(i), [&](ASTNode& node) {
+            if (node.getNodeType() == ASTNodeType::IDENTIFIER) lastReferences[node.id] = i;
+            return true;
+        });
+    }
+}
+
+AssembledFunc::AssembledFunc(const std::string& funcName, ASTFunction& func) {
     this->funcName = funcName;
+    this->pFuncNode = &func;
 
     // determine if this is the main function
     this->paramTypes = std::vector<Type>();
@@ -30,15 +197,69 @@ AssembledFunc::AssembledFunc(const std::string& funcName, const ASTFunction& fun
     // determine labels
     this->startLabel = func.isMainFunction() ? RESERVED_LABEL_MAIN : (FUNC_LABEL_PREFIX + std::to_string(nextFuncLabelID++));
     this->endLabel = this->startLabel + FUNC_END_LABEL_SUFFIX;
+
+    // collect variables whose address is taken
+    visitNodes(&func, [&](ASTNode& node) {
+        if (node.getNodeType() == ASTNodeType::UNARY_OP && static_cast<ASTOperator*>(&node)->getOpTokenType() == TokenType::AMPERSAND) {
+            visitNodes(&node, [&](ASTNode& operand) {
+                if (operand.getNodeType() == ASTNodeType::IDENTIFIER) this->addressTakenVars.insert(operand.id);
+                return true;
+            });
+        }
+        return true;
+    });
+
+    // results of up to 2 bytes are returned in AX/AL (main still returns its status on the stack)
+    this->_isFastcall = USE_FASTCALL && !func.isMainFunction() && this->returnType.getSizeBytes() <= 2;
+
+    // so are the last one or two args (they're evaluated last, on top of any pushed ones); a function that never calls
+    // out or runs raw assembly keeps the plain ints among them in SI & DI for good, if they're only read & assigned
+    this->numRegisterParams = this->_isFastcall ? std::min<size_t>(2, this->paramTypes.size()) : 0;
+    this->paramRegisters.assign(this->paramTypes.size(), "");
+
+    const char* const residentRegisters[] = {"SI", "DI"};
+    const bool isResidentAllowed = !hasCallsOrAssembly(func);
+    for (size_t i = this->paramTypes.size() - this->numRegisterParams, j = 0; i < this->paramTypes.size() && isResidentAllowed; ++i) {
+        const Type& type = this->paramTypes[i];
+        const symbol_t id = func.paramAt(i)->id;
+        if (type.isPointer() || type.isArray() || type.getSizeBytes() != 2 || this->isAddressTaken(id) ||
+            !isOnlyAssignedDirectly(func, id, type)) continue;
+        this->paramRegisters[i] = residentRegisters[j++];
+    }
+
+    // small straight-line functions (or any non-recursive function marked inline) are substituted at their call sites
+    size_t numNodes = 0;
+    bool isLeaf = true;
+    this->_isInlinable = !func.isMainFunction() && countInlineNodes(&func, func.id, numNodes, isLeaf) &&
+                         (func.isInline() || (isLeaf && numNodes <= INLINE_NODE_BUDGET));
+}
+
+AssembledFunc::AssembledFunc(const AssembledFunc& func, const std::string& endLabel) : AssembledFunc(func) {
+    this->endLabel = endLabel;
+
+    // an inlined copy's args are all left on the stack, none are in registers
+    this->numRegisterParams = 0;
+    std::fill(this->paramRegisters.begin(), this->paramRegisters.end(), std::string());
+}
+
+// the bytes of params in the function's frame (all but the ones kept in registers)
+size_t AssembledFunc::getFrameParamSize() const {
+    size_t size = 0;
+    for (size_t i = 0; i < this->paramTypes.size(); ++i)
+        if (this->paramRegisters[i].empty()) size += this->paramTypes[i].getSizeBytes(SIZE_ARR_AS_PTR);
+    return size;
 }
 
 // generate TPU assembly code from the AST
-void generateAssembly(AST& ast, std::ofstream& outHandle) {
+void generateAssembly(AST& ast, std::ostream& outHandle) {
+    // set up the IR pipeline
+    if (RUN_IR_PASSES) addDefaultPasses(passManager);
+
     // write .text section
     outHandle << "section .text\n";
 
     // iterate over global functions
-    std::vector<ASTNode*>& globalChildren = ast.getChildren();
+    ast_vector_t<ASTNode*>& globalChildren = ast.getChildren();
     for (ASTNode* pFunc : globalChildren) {
         // build list of function labels
         ASTFunction& funcNode = *static_cast<ASTFunction*>(pFunc);
@@ -58,160 +279,166 @@ void generateAssembly(AST& ast, std::ofstream& outHandle) {
     }
 }
 
+// writes the IR pass counters
+void printPassStats(std::ostream& outHandle) {
+    passManager.printStats(outHandle);
+}
+
 // for assembling functions
-void assembleFunction(ASTFunction& funcNode, std::ofstream& outHandle) {
+void assembleFunction(ASTFunction& funcNode, std::ostream& outHandle) {
     // determine labelName
     const std::string funcName = funcNode.getName();
 
     // create new AssembledFunc to store name & return type
     AssembledFunc asmFunc = AssembledFunc(funcName, funcNode);
-    labelMap.insert({funcName, asmFunc});
+    labelMap[funcNode.id].push_back(asmFunc);
 
     // create a scope for this body
     Scope scope;
+    pushedValues.clear();
 
-    // assemble this function into the file
-    outHandle << asmFunc.getStartLabel() << ":\n";
+    // build the function as IR so its temporaries can be given registers before it's written
+    IRFunction irFunc;
+    irFunc.name = asmFunc.getStartLabel();
+    IRBuilder ir(irFunc);
+    ir.label(asmFunc.getStartLabel());
 
     // if this is main, add return byte spacing on top of stack
     const size_t returnSize = funcNode.getReturnType().getSizeBytes();
     if (asmFunc.getStartLabel() == RESERVED_LABEL_MAIN && returnSize > 0)
-        OUT << "add SP, " << returnSize << '\n';
+        ir.emit(IROpcode::ADD, irReg("SP"), irImm(returnSize));
 
     // add return bytes to scope
-    if (funcNode.getReturnType().getSizeBytes() > 0)
+    if (!asmFunc.isFastcall() && funcNode.getReturnType().getSizeBytes() > 0)
         scope.declareVariable(funcNode.getReturnType(), SCOPE_RETURN_START, funcNode.err);
 
     // add function args to scope (args on top of stack just above return bytes)
+    // register params are pushed after the rest, unless they're kept in registers for the whole function
+    registerVars.clear();
+    const size_t firstRegisterParam = funcNode.getNumParams() - asmFunc.getNumRegisterParams();
     for (size_t i = 0; i < funcNode.getNumParams(); ++i) { // add the variable to the scope
         ASTFuncParam* pArg = funcNode.paramAt(i);
-        scope.declareFunctionParam(pArg->type, pArg->name, funcNode.err);
+        const std::string& paramRegister = asmFunc.getParamRegister(i);
+        if (!paramRegister.empty()) {
+            ir.emit(IROpcode::MOVW, irReg(paramRegister), irArgReg(asmFunc, i, 2));
+            registerVars.emplace(pArg->id, std::make_pair(irReg(paramRegister), pArg->type));
+            continue;
+        }
+
+        if (i >= firstRegisterParam) {
+            const size_t size = pArg->type.getSizeBytes(SIZE_ARR_AS_PTR);
+            ir.emit(getPushOp(size), irArgReg(asmFunc, i, size));
+        }
+        scope.declareFunctionParam(pArg->type, pArg->id, funcNode.err);
     }
 
     // assemble body content
-    bool hasReturned = assembleBody(&funcNode, outHandle, scope, asmFunc, true);
+    bool hasReturned = assembleBody(&funcNode, ir, scope, asmFunc, true);
 
     // declare end of function label
     if (!hasReturned && returnSize > 0)
         throw TMissingReturnException(funcNode.err);
 
     // write return label
-    OUT << asmFunc.getEndLabel() << ":\n";
+    ir.label(asmFunc.getEndLabel());
 
     // stop clock after execution is done IF MAIN or return to previous label
     if (asmFunc.getStartLabel() == RESERVED_LABEL_MAIN) {
         // handle return status
-        OUT << "movw AX, 0x03\n"; // specify syscall type
-        OUT << "popw BX\n"; // pop return status to AX
-        OUT << "syscall\n"; // trigger syscall
-        OUT << "hlt\n";
+        ir.emit(IROpcode::MOVW, irReg("AX"), irImm(0x03)); // specify syscall type
+        ir.emit(IROpcode::POPW, irReg("BX")); // pop return status to AX
+        ir.emit(IROpcode::SYSCALL); // trigger syscall
+        ir.emit(IROpcode::HLT);
     } else { // return to previous label from call instruction
-        OUT << "ret\n";
+        ir.emit(IROpcode::RET);
     }
+
+    // optimize, give the temporaries registers and write to the file (named in a comment above its label)
+    passManager.run(irFunc);
+    if (ALLOCATE_REGISTERS) allocateRegisters(irFunc);
+    outHandle << "; " << funcName << '\n';
+    lowerIRFunction(irFunc, outHandle);
 }
 
 // for assembling body content that may or may not have its own scope
 // returns true if the current body has returned (really only matters in function scopes)
-bool assembleBody(ASTNode* pHead, std::ofstream& outHandle, Scope& scope, const AssembledFunc& asmFunc, const bool isTopScope) {
+bool assembleBody(ASTNode* pHead, IRBuilder& ir, Scope& scope, const AssembledFunc& asmFunc, const bool isTopScope) {
     size_t startingScopeSize = scope.size(); // remove any scoped variables at the end
     const Type& desiredType = asmFunc.getReturnType();
     const size_t returnSize = desiredType.getSizeBytes();
 
+    // variables declared directly in this body whose slots could be reused (with the last child referencing each)
+    // & bytes of uninitialized ones not yet allocated
+    std::vector<std::pair<ASTVarDeclaration*, size_t>> blockVars;
+    std::unordered_map<symbol_t, size_t> lastReferences; // collected once the body declares something
+    size_t pendingFrameSize = 0;
+
     // iterate over children of this node
-    bool hasReturned = false;
+    bool hasReturned = false, hasTailCalled = false;
     size_t numChildren = pHead->size();
     for (size_t i = 0; i < numChildren && !hasReturned; i++) {
         ASTNode& child = *pHead->at(i);
 
+        // allocate a run of uninitialized variables with a single adjustment before anything else is emitted
+        const bool isUninitializedDecl = child.getNodeType() == ASTNodeType::VAR_DECLARATION &&
+                                         static_cast<ASTVarDeclaration*>(&child)->pExpr == nullptr;
+        if (pendingFrameSize > 0 && !isUninitializedDecl) {
+            ir.emit(IROpcode::ADD, irReg("SP"), irImm(pendingFrameSize));
+            pendingFrameSize = 0;
+        }
+
         // switch on node type
         switch (child.getNodeType()) {
             case ASTNodeType::WHILE_LOOP: {
                 ASTWhileLoop& loop = *static_cast<ASTWhileLoop*>(&child);
 
-                // create label for the start of the loop body (here)
+                // create label for the start of the loop body
                 const std::string loopStartLabel = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
 
-                // determine the label where all branches merge
-                const std::string mergeLabel = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-
-                // append loopStartLabel
-                OUT << loopStartLabel << ":\n";
-
-                // check condition
-                size_t resultSize = assembleExpression(*loop.pExpr, outHandle, scope).getSizeBytes();
-
-                // load result to AL/AX
-                if (resultSize == 2) {
-                    OUT << "pop AX\n"; // load value to AH
-                    scope.pop();
-                } else {
-                    OUT << "pop AL\n";
-                    OUT << "xor AH, AH\n"; // clear AH if no value is there
-                }
-                scope.pop();
-                OUT << "buf AX\n"; // test ZF flag
-
-                // if the result sets the ZF flag, it's false so jmp to mergeLabel
-                OUT << "jz " << mergeLabel << "\n";
+                // the condition is checked at the bottom of the loop, so jump there to start
+                const std::string conditionLabel = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
+                ir.emit(IROpcode::JMP, irLabel(conditionLabel));
 
                 // assemble the body here in new scope
-                assembleBody(&loop, outHandle, scope, asmFunc);
+                ir.label(loopStartLabel);
+                assembleBody(&loop, ir, scope, asmFunc);
 
-                // jump back to the loopStartLabel
-                OUT << "jmp " << loopStartLabel << '\n';
-
-                // add merge label
-                OUT << mergeLabel << ":\n";
+                // check condition, jumping back to the loopStartLabel while it's true
+                ir.label(conditionLabel);
+                assembleBranch(*loop.pExpr, ir, scope, loopStartLabel, true);
                 break;
             }
             case ASTNodeType::FOR_LOOP: {
                 ASTForLoop& loop = *static_cast<ASTForLoop*>(&child);
 
                 // assemble first expression in current scope
-                size_t resultSize = assembleExpression(*loop.pExprA, outHandle, scope).getSizeBytes();
+                size_t resultSize = assembleExpression(*loop.pExprA, ir, scope).getSizeBytes();
 
                 // nothing from the expression is handled so pop the result off the stack
-                OUT << "sub SP, " << resultSize << '\n';
+                ir.emit(IROpcode::SUB, irReg("SP"), irImm(resultSize));
                 scope.pop(resultSize);
 
-                // create label for the start of the loop body (here)
+                // create label for the start of the loop body
                 const std::string loopStartLabel = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
 
-                // determine the label where all branches merge
-                const std::string mergeLabel = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-
-                // append loopStartLabel
-                OUT << loopStartLabel << ":\n";
-
-                // check condition
-                resultSize = assembleExpression(*loop.pExprB, outHandle, scope).getSizeBytes();
-
-                // load result to AL/AX
-                if (resultSize == 2) {
-                    OUT << "popw AX\n"; // load value to AH
-                    scope.pop();
-                } else {
-                    OUT << "pop AL\n";
-                    OUT << "xor AH, AH\n"; // clear AH if no value is there
-                }
-                scope.pop();
-                OUT << "buf AX\n"; // test ZF flag
-
-                // if the result sets the ZF flag, it's false so jmp to mergeLabel
-                OUT << "jz " << mergeLabel << "\n";
+                // the condition is checked at the bottom of the loop, so jump there to start
+                const std::string conditionLabel = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
+                ir.emit(IROpcode::JMP, irLabel(conditionLabel));
 
                 // assemble the body here in new scope
-                assembleBody(&loop, outHandle, scope, asmFunc);
+                ir.label(loopStartLabel);
+                assembleBody(&loop, ir, scope, asmFunc);
 
                 // assemble third expression
-                resultSize = assembleExpression(*loop.pExprC, outHandle, scope).getSizeBytes();
+                resultSize = assembleExpression(*loop.pExprC, ir, scope).getSizeBytes();
 
                 // nothing from the expression is handled so pop the result off the stack
-                OUT << "sub SP, " << resultSize << '\n';
+                ir.emit(IROpcode::SUB, irReg("SP"), irImm(resultSize));
                 scope.pop(resultSize);
 
-                OUT << "jmp " << loopStartLabel << '\n'; // jump back to the loopStartLabel
-                OUT << mergeLabel << ":\n"; // add merge label
+                // check condition, jumping back to the loopStartLabel while it's true
+                ir.label(conditionLabel);
+                assembleBranch(*loop.pExprB, ir, scope, loopStartLabel, true);
                 break;
             }
             case ASTNodeType::CONDITIONAL: {
@@ -234,27 +461,19 @@ bool assembleBody(ASTNode* pHead, std::ofstream& outHandle, Scope& scope, const
                         else // else if branch
                             pExpr = static_cast<ASTElseIfCondition*>(conditional.at(j))->pExpr;
 
-                        assembleExpression(*pExpr, outHandle, scope);
-
-                        // pop the result off the stack to AL
-                        OUT << "pop AL\n"; // pop to AL
-                        OUT << "xor AH, AH\n"; // clear AH since no value is put there
-                        scope.pop();
-
                         // if false, jump to next condition
-                        OUT << "buf AX\n"; // set ZF if false
-                        OUT << "jz " << nextLabel << '\n';
+                        assembleBranch(*pExpr, ir, scope, nextLabel, false);
                     }
 
                     // this is executed when not jumping anywhere (else branch or false condition)
                     // process the body in a new scope
-                    assembleBody(conditional.at(j), outHandle, scope, asmFunc);
+                    assembleBody(conditional.at(j), ir, scope, asmFunc);
 
                     // jump to merge label
-                    OUT << "jmp " << mergeLabel << '\n';
+                    ir.emit(IROpcode::JMP, irLabel(mergeLabel));
 
                     // write next label
-                    OUT << nextLabel << ":\n";
+                    ir.label(nextLabel);
                 }
 
                 break;
@@ -264,44 +483,91 @@ bool assembleBody(ASTNode* pHead, std::ofstream& outHandle, Scope& scope, const
                 ASTVarDeclaration* pVarChild = static_cast<ASTVarDeclaration*>(&child);
                 const Type varType = pVarChild->getType();
                 const size_t typeSize = varType.getSizeBytes();
+                const symbol_t varId = pVarChild->pIdentifier->id;
+                if (findRegisterVar(varId) != nullptr)
+                    throw TIdentifierInUseException(pVarChild->pIdentifier->err);
+
+                if (lastReferences.size() == 0)
+                    collectLastReferences(*pHead, lastReferences);
+
+                // reuse the slot of a variable from this body that's never referenced again
+                auto deadItr = blockVars.end();
+                if (!varType.isArray()) {
+                    deadItr = std::find_if(blockVars.begin(), blockVars.end(), [&](const std::pair<ASTVarDeclaration*, size_t>& var) {
+                        return var.second <= i && var.first->getTypeRef().getSizeBytes() == typeSize;
+                    });
+                }
+
+                // only primitives that are never pointed to can have their slots reused later on
+                const bool isReusable = !varType.isArray() && !asmFunc.isAddressTaken(varId);
+                const std::pair<ASTVarDeclaration*, size_t> blockVar(pVarChild, lastReferences[varId]);
+
+                if (deadItr != blockVars.end()) {
+                    // store the value over the dead variable
+                    if (pVarChild->pExpr != nullptr) {
+                        assembleExpression(*pVarChild->pExpr, ir, scope);
+                        popValue(ir, scope, irReg('B', typeSize), typeSize);
+
+                        const size_t stackOffset = scope.getOffset(deadItr->first->pIdentifier->id, pVarChild->pIdentifier->err);
+                        ir.emit(IROpcode::MOV, irStack(stackOffset), irReg("BL"));
+                        if (typeSize == 2)
+                            ir.emit(IROpcode::MOV, irStack(stackOffset-1), irReg("BH"));
+                    }
+
+                    scope.renameVariable(deadItr->first->pIdentifier->id, varType, varId, pVarChild->pIdentifier->err);
+                    blockVars.erase(deadItr);
+                    if (isReusable) blockVars.push_back(blockVar);
+                    break;
+                }
 
                 // get the value of the assignment
-                if (pVarChild->pExpr == nullptr) { // no assignment
-                    OUT << "add SP, " << typeSize << '\n';
+                if (pVarChild->pExpr == nullptr) { // no assignment, allocated with any neighboring declarations
+                    pendingFrameSize += typeSize;
                 } else { // has assignment, assemble its expression
-                    assembleExpression(*pVarChild->pExpr, outHandle, scope);
+                    assembleExpression(*pVarChild->pExpr, ir, scope);
 
                     // remove any placeholders
                     for (size_t j = 0; j < typeSize; j++) scope.pop();
                 }
 
                 // add variable to scope
-                scope.declareVariable(varType, pVarChild->pIdentifier->raw, pVarChild->pIdentifier->err);
+                scope.declareVariable(varType, varId, pVarChild->pIdentifier->err);
+                if (isReusable) blockVars.push_back(blockVar);
                 break;
             }
             case ASTNodeType::RETURN: {
                 // assemble expression (first and only child of retNode is an ASTExpr*)
                 ASTReturn& retNode = *static_cast<ASTReturn*>(&child);
 
+                // a call in tail position reuses this function's frame & jumps straight to the callee
+                if (assembleTailCall(retNode, ir, scope, asmFunc)) {
+                    hasReturned = hasTailCalled = true;
+                    break;
+                }
+
                 if (retNode.size() > 0) {
-                    Type resultType = assembleExpression(*retNode.at(0), outHandle, scope);
+                    Type resultType = assembleExpression(*retNode.at(0), ir, scope);
 
                     if (desiredType.isVoidNonPtr() && !resultType.isVoidNonPtr())
                         throw TVoidReturnException(retNode.err);
 
                     // implicit cast result to desired size, if needed
                     if (resultType != desiredType)
-                        implicitCast(outHandle, resultType, desiredType, scope, retNode.err);
+                        implicitCast(ir, resultType, desiredType, scope, retNode.err);
+
+                    // fastcall results are handed back in AX/AL
+                    if (asmFunc.isFastcall() && returnSize > 0)
+                        popValue(ir, scope, irReg('A', returnSize), returnSize);
 
-                    // move result bytes to their place earlier on the stack
-                    for (size_t j = 0; j < returnSize; ++j) {
+                    // otherwise move result bytes to their place earlier on the stack
+                    for (size_t j = 0; j < returnSize && !asmFunc.isFastcall(); ++j) {
                         // pop top of stack into DL
-                        OUT << "pop DL\n";
+                        ir.emit(IROpcode::POP, irReg("DL"));
                         scope.pop();
 
                         // mov DL to return bytes location
                         size_t index = scope.getOffset(SCOPE_RETURN_START, retNode.err) - (returnSize - 1 - j);
-                        OUT << "mov [SP-" << index << "], DL\n";
+                        ir.emit(IROpcode::MOV, irStack(index), irReg("DL"));
                     }
                 }
 
@@ -311,12 +577,12 @@ bool assembleBody(ASTNode* pHead, std::ofstream& outHandle, Scope& scope, const
             }
             case ASTNodeType::EXPR: {
                 // assemble expression
-                Type resultType = assembleExpression(child, outHandle, scope);
+                Type resultType = assembleExpression(child, ir, scope);
                 const size_t resultSize = resultType.getSizeBytes();
 
                 // nothing from the expression is handled so pop the result off the stack
                 if (resultSize > 0) {
-                    OUT << "sub SP, " << resultSize << '\n';
+                    ir.emit(IROpcode::SUB, irReg("SP"), irImm(resultSize));
                     scope.pop(resultSize);
                 }
                 break;
@@ -330,33 +596,277 @@ bool assembleBody(ASTNode* pHead, std::ofstream& outHandle, Scope& scope, const
     // remove extra scope variables after the scope closes
     long long sizeFreed = scope.size() - startingScopeSize;
 
-    // move back SP
+    // move back SP (trailing uninitialized variables were never allocated)
     if (sizeFreed > 0) {
-        OUT << "sub SP, " << sizeFreed << '\n';
+        if (sizeFreed > (long long)pendingFrameSize && !hasTailCalled)
+            ir.emit(IROpcode::SUB, irReg("SP"), irImm(sizeFreed - pendingFrameSize));
         scope.pop(sizeFreed);
     }
 
-    // jump to end if returned
-    if (hasReturned) {
+    // jump to end if returned (a tail call has already left the function)
+    if (hasReturned && !hasTailCalled) {
         // remove everything else in the scope except the return bytes
         // DON'T USE scope.pop SINCE THIS ISN'T A GUARANTEED RETURN
         if (!isTopScope) {
-            size_t argSizes = 0;
-            for (const Type& t : asmFunc.getParamTypes())
-                argSizes += t.getSizeBytes();
+            const size_t returnBytes = asmFunc.isFastcall() ? 0 : returnSize; // fastcall results are in AX
+            long long popSize = scope.size() - returnBytes - asmFunc.getFrameParamSize(); // frame params popped by caller
 
-            long long popSize = scope.size() - returnSize - argSizes; // argSizes popped by caller
-
-            if (popSize > 0) OUT << "sub SP, " << popSize << '\n';
+            if (popSize > 0) ir.emit(IROpcode::SUB, irReg("SP"), irImm(popSize));
         }
-        OUT << "jmp " << asmFunc.getEndLabel() << '\n';
+        ir.emit(IROpcode::JMP, irLabel(asmFunc.getEndLabel()));
     }
 
     return hasReturned;
 }
 
+// finds the overload of a called function whose parameters match the call's arguments (preferring an exact match)
+AssembledFunc* findFunction(ASTFunctionCall& func) {
+    auto overloadsItr = labelMap.find(func.id);
+    if (overloadsItr == labelMap.end()) throw TUnknownIdentifierException(func.err);
+
+    const size_t numParams = func.size();
+    AssembledFunc* pImplicitMatch = nullptr;
+    for (AssembledFunc& overload : overloadsItr->second) {
+        // check if parameters match
+        const std::vector<Type>& paramTypes = overload.getParamTypes();
+        if (paramTypes.size() != numParams) continue;
+
+        bool isExactMatch = true;
+        size_t j;
+        for (j = 0; j < numParams; ++j) {
+            const Type& actualType = static_cast<ASTTypedNode*>(func.at(j))->getTypeRef();
+            const int matchStatus = paramTypes[j].isParamMatch(actualType, func.at(j)->err);
+            if (matchStatus == TYPE_PARAM_MISMATCH) break;
+            isExactMatch = isExactMatch && matchStatus == TYPE_PARAM_EXACT_MATCH;
+        }
+
+        // if broken prematurely, a type didn't match
+        if (j < numParams) continue;
+        if (isExactMatch) return &overload;
+        if (pImplicitMatch == nullptr) pImplicitMatch = &overload;
+    }
+
+    if (pImplicitMatch == nullptr) throw TUnknownIdentifierException(func.err);
+    return pImplicitMatch;
+}
+
+// compiles `return f(...);` as a jump to f that reuses the current frame, returns false if the call isn't eligible
+bool assembleTailCall(ASTReturn& retNode, IRBuilder& ir, Scope& scope, const AssembledFunc& asmFunc) {
+    // inlined bodies have no frame of their own & main exits the program instead of returning
+    if (!TAIL_CALLS || !inlineStack.empty() || asmFunc.getFuncNode().isMainFunction() || retNode.size() == 0) return false;
+
+    // unwrap the returned expression down to a bare call
+    ASTNode* pNode = retNode.at(0);
+    while (pNode->getNodeType() == ASTNodeType::EXPR && pNode->size() == 1)
+        pNode = pNode->at(0);
+    if (pNode->getNodeType() != ASTNodeType::FUNCTION_CALL) return false;
+
+    ASTFunctionCall& func = *static_cast<ASTFunctionCall*>(pNode);
+    const AssembledFunc* pDestFunc = findFunction(func);
+    // the return bytes below the args (if not returned in AX) are left in place for the callee to fill in
+    if (pDestFunc->isFastcall() != asmFunc.isFastcall() || pDestFunc->getReturnType() != asmFunc.getReturnType()) return false;
+
+    // calls that would be inlined are cheaper still
+    if (INLINE_FUNCTIONS && pDestFunc->isInlinable()) return false;
+
+    // locals can't be pointed to from the args once the frame is reused
+    if (asmFunc.hasAddressTakenVars()) return false;
+
+    // the callee's frame must exactly cover the current args (the caller pops them after the callee returns)
+    ASTFunction& funcNode = asmFunc.getFuncNode();
+    const size_t returnBytes = asmFunc.isFastcall() ? 0 : asmFunc.getReturnType().getSizeBytes();
+    size_t paramSize = 0, argSize = returnBytes;
+    for (const Type& t : asmFunc.getParamTypes()) {
+        if (t.isArray()) return false;
+        paramSize += t.getSizeBytes();
+    }
+    if (pDestFunc->getFrameParamSize() != paramSize) return false;
+
+    // the callee's register args are left in CX & DX, the rest are moved into its frame
+    const std::vector<Type>& destParamTypes = pDestFunc->getParamTypes();
+    const size_t firstRegisterArg = func.size() - pDestFunc->getNumRegisterParams();
+    std::vector<size_t> argOffsets; // where each arg starts in the frame (above the return bytes)
+    std::vector<bool> isPassedThrough; // args that are already in place (a param passed along in its own slot)
+    for (size_t j = 0; j < func.size(); ++j) {
+        ASTNode* pArg = func.at(j);
+        const Type& argType = static_cast<ASTTypedNode*>(pArg)->getTypeRef();
+        const size_t argTypeSize = argType.getSizeBytes();
+        if (destParamTypes[j].isArray() || argType.isArray() || argTypeSize > 2 || argTypeSize != destParamTypes[j].getSizeBytes())
+            return false;
+
+        while (pArg->getNodeType() == ASTNodeType::EXPR && pArg->size() == 1)
+            pArg = pArg->at(0);
+        isPassedThrough.push_back(pArg->getNodeType() == ASTNodeType::IDENTIFIER && j < funcNode.getNumParams() && j < firstRegisterArg &&
+                                  pArg->id == funcNode.paramAt(j)->id && asmFunc.getParamTypes()[j].getSizeBytes() == argTypeSize);
+        argOffsets.push_back(argSize);
+        if (j < firstRegisterArg) argSize += argTypeSize;
+    }
+
+    // a passed through param's offset must match too (args past the current function's params are never passed through)
+    const size_t numPassableArgs = std::min(func.size(), asmFunc.getParamTypes().size());
+    for (size_t j = 0, offset = returnBytes; j < numPassableArgs; offset += asmFunc.getParamTypes()[j++].getSizeBytes())
+        if (isPassedThrough[j] && argOffsets[j] != offset) isPassedThrough[j] = false;
+    for (size_t j = numPassableArgs; j < func.size(); ++j)
+        isPassedThrough[j] = false;
+
+    // push the new args on top of the frame
+    for (size_t j = 0; j < func.size(); ++j)
+        if (!isPassedThrough[j]) assembleExpression(*func.at(j), ir, scope);
+
+    // move them down over the current args (which start at the bottom of the frame, after any return bytes), or into CX & DX
+    for (size_t j = func.size(); j-- > 0;) {
+        if (isPassedThrough[j]) continue;
+
+        const size_t argTypeSize = destParamTypes[j].getSizeBytes();
+        if (j >= firstRegisterArg) {
+            popValue(ir, scope, irArgReg(*pDestFunc, j, argTypeSize), argTypeSize);
+            continue;
+        }
+        popValue(ir, scope, irReg('B', argTypeSize), argTypeSize);
+
+        ir.emit(IROpcode::MOV, irStack(scope.size() - argOffsets[j]), irReg("BL"));
+        if (argTypeSize == 2)
+            ir.emit(IROpcode::MOV, irStack(scope.size() - argOffsets[j] - 1), irReg("BH"));
+    }
+
+    // drop the locals (& the slots the callee pushes its register args to) & enter the callee with the original
+    // return address still on the callstack
+    // DON'T USE scope.pop SINCE THIS ISN'T A GUARANTEED RETURN
+    if (scope.size() > argSize)
+        ir.emit(IROpcode::SUB, irReg("SP"), irImm(scope.size() - argSize));
+    ir.emit(IROpcode::JMP, irLabel(pDestFunc->getStartLabel()));
+    return true;
+}
+
+// substitutes a function's body at a call site, where its return bytes & args are already on the stack
+void assembleInlineCall(const AssembledFunc& destFunc, IRBuilder& ir) {
+    ASTFunction& funcNode = destFunc.getFuncNode();
+
+    // the stack already matches what the function's own scope expects (return bytes below args)
+    Scope scope;
+    if (!destFunc.isFastcall() && funcNode.getReturnType().getSizeBytes() > 0)
+        scope.declareVariable(funcNode.getReturnType(), SCOPE_RETURN_START, funcNode.err);
+
+    for (size_t i = 0; i < funcNode.getNumParams(); ++i) {
+        ASTFuncParam* pArg = funcNode.paramAt(i);
+        scope.declareFunctionParam(pArg->type, pArg->id, funcNode.err);
+    }
+
+    // returns jump to a label after this copy of the body instead of the function's end
+    const AssembledFunc inlineFunc(destFunc, JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++));
+    // the body's values are pushed relative to its own scope, & its args are all on the stack
+    std::vector<std::pair<IROperand, size_t>> callerValues;
+    std::unordered_map<symbol_t, std::pair<IROperand, Type>> callerRegisterVars;
+    callerValues.swap(pushedValues);
+    callerRegisterVars.swap(registerVars);
+
+    inlineStack.push_back(&funcNode);
+    assembleBody(&funcNode, ir, scope, inlineFunc, true);
+    inlineStack.pop_back();
+    pushedValues.swap(callerValues);
+    registerVars.swap(callerRegisterVars);
+
+    ir.label(inlineFunc.getEndLabel());
+}
+
+// pushes a call's args, converting each to the size of its parameter (arrays are passed as pointers),
+// then moves the callee's register params off the top of the stack into CX & DX unless it's being inlined
+void assembleArguments(ASTFunctionCall& func, const AssembledFunc& destFunc, IRBuilder& ir, Scope& scope,
+                       std::vector<Type>& resultTypes, const bool isRegisterCall) {
+    const std::vector<Type>& paramTypes = destFunc.getParamTypes();
+    const size_t firstRegisterArg = func.size() - (isRegisterCall ? destFunc.getNumRegisterParams() : 0);
+    std::vector<bool> isRegOperand(func.size(), false); // leaves loaded straight into their register after the rest
+    for (size_t i = 0; i < func.size(); ++i) {
+        ASTNode& arg = *func.at(i);
+
+        // a leaf of its param's exact type can be read once the later args have run, unless they may change it
+        bool isReadInOrder = false;
+        for (size_t j = i + 1; j < func.size() && !isReadInOrder; ++j)
+            isReadInOrder = hasSideEffects(*func.at(j));
+
+        if (i >= firstRegisterArg && !isReadInOrder && isRegisterOperand(arg, scope) &&
+            static_cast<ASTTypedNode*>(&arg)->getTypeRef() == paramTypes[i]) {
+            isRegOperand[i] = true;
+            arg.isAssembled = true;
+            resultTypes.push_back(paramTypes[i]);
+            continue;
+        }
+
+        Type argType = assembleExpression(arg, ir, scope);
+        if (!argType.isArray() && !paramTypes[i].isArray() && argType.getSizeBytes() != paramTypes[i].getSizeBytes()) {
+            implicitCast(ir, argType, paramTypes[i], scope, arg.err);
+            argType = paramTypes[i];
+        }
+        resultTypes.push_back(argType);
+    }
+
+    // the register args were evaluated last, so they're popped first
+    for (size_t i = func.size(); i-- > firstRegisterArg;) {
+        const size_t argSize = resultTypes[i].getSizeBytes(SIZE_ARR_AS_PTR);
+        if (isRegOperand[i]) loadRegisterOperand(*func.at(i), ir, scope, i == firstRegisterArg ? 'C' : 'D');
+        else popValue(ir, scope, irArgReg(destFunc, i, argSize), argSize);
+    }
+}
+
+// assembles an operator's operands bottom-up, leaving register operands to be loaded by the operator itself
+void assembleOperands(ASTNode& bodyNode, IRBuilder& ir, Scope& scope, const bool usesRegisterOperands,
+                      std::vector<Type>& resultTypes, std::vector<bool>& isRegOperand) {
+    const size_t numChildren = bodyNode.size();
+    const bool isAssignment = bodyNode.getNodeType() == ASTNodeType::BIN_OP &&
+                              isTokenAssignOp(static_cast<ASTOperator*>(&bodyNode)->getOpTokenType());
+    isRegOperand.assign(numChildren, false);
+    for (size_t i = 0; i < numChildren; ++i) {
+        ASTNode& child = *bodyNode.at(i);
+
+        // register operands are read after the later operands run, so a variable one of them may change is pushed in order instead
+        unsigned int constant;
+        bool isReadInOrder = false;
+        for (size_t j = i + 1; j < numChildren && !isAssignment && !getRegisterLiteral(child, constant) && !isReadInOrder; ++j)
+            isReadInOrder = hasSideEffects(*bodyNode.at(j));
+
+        if (usesRegisterOperands && !isReadInOrder && (isRegisterOperand(child, scope) ||
+            (i == 0 && isAssignment && isDirectStoreTarget(child, scope)))) {
+            isRegOperand[i] = true;
+            child.isAssembled = true;
+            resultTypes.push_back( static_cast<ASTTypedNode*>(&child)->getType() );
+            continue;
+        }
+
+        resultTypes.push_back( assembleExpression(child, ir, scope) );
+    }
+}
+
+// moves a binary operator's assembled operands into AX/AL & BX/BL (popping them in reverse, higher first)
+void loadBinaryOperands(ASTOperator& binOp, IRBuilder& ir, Scope& scope,
+                        const std::vector<Type>& resultTypes, const std::vector<bool>& isRegOperand) {
+    if (isRegOperand[1]) { // load straight to BX
+        loadRegisterOperand(*binOp.right(), ir, scope, 'B');
+    } else if (resultTypes[1].getSizeBytes() == 2) { // pop to BX
+        popValue(ir, scope, irReg("BX"), 2);
+    } else { // pop to BL and zero BH
+        popValue(ir, scope, irReg("BL"), 1);
+        ir.emit(IROpcode::XOR, irReg("BH"), irReg("BH"));
+    }
+
+    // ignore popping to the AL/AX register if nothing was pushed from the stack (for assignments)
+    if (isTokenAssignOp(binOp.getOpTokenType())) {
+        // force assignment to pop the address (unless storing straight to a variable)
+        if (!isRegOperand[0])
+            popValue(ir, scope, irReg("AX"), 2);
+    } else if (isRegOperand[0]) { // load straight to AX
+        loadRegisterOperand(*binOp.left(), ir, scope, 'A');
+    } else {
+        if (resultTypes[0].getSizeBytes(SIZE_ARR_AS_PTR) == 2) { // pop to AX
+            popValue(ir, scope, irReg("AX"), 2);
+        } else { // pop to AL and zero AH
+            popValue(ir, scope, irReg("AL"), 1);
+            ir.emit(IROpcode::XOR, irReg("AH"), irReg("AH"));
+        }
+    }
+}
+
 // assembles an expression, returning the type of the value pushed to the stack
-Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scope) {
+Type assembleExpression(ASTNode& bodyNode, IRBuilder& ir, Scope& scope) {
     // if this is a literal array without a type (ie. not part of an assignment), yell at the user (LOUDLY)
     // literal arrays are ONLY allowed during assignment
     if (bodyNode.getNodeType() == ASTNodeType::LIT_ARR) {
@@ -369,54 +879,51 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
     const Type desiredType = static_cast<ASTTypedNode*>(&bodyNode)->getType();
 
     // if this node is a function call, allocate return bytes below args
+    AssembledFunc* pDestFunc = nullptr;
+    bool isInlineCall = false;
     if (bodyNode.getNodeType() == ASTNodeType::FUNCTION_CALL) {
         ASTFunctionCall& func = *static_cast<ASTFunctionCall*>(&bodyNode);
-        const std::string& funcName = func.raw;
 
         // find function and verify parameters match
-        AssembledFunc* pDestFunc = nullptr;
-        const size_t numParams = func.size();
-        auto [itr, end] = labelMap.equal_range(funcName);
-        for ((void)itr; itr != end; ++itr) {
-            // check if parameters match
-            const std::vector<Type>& paramTypes = itr->second.getParamTypes();
-            if (paramTypes.size() != func.size()) continue;
-
-            size_t j;
-            for (j = 0; j < numParams; ++j) {
-                const Type& actualType = static_cast<ASTTypedNode*>(func.at(j))->getTypeRef();
-                if (paramTypes[j].isParamMatch(actualType, func.at(j)->err) == TYPE_PARAM_MISMATCH) break;
-            }
-
-            // if broken prematurely, a type didn't match
-            if (j == numParams) {
-                pDestFunc = &itr->second;
-                break;
-            }
-        }
+        pDestFunc = findFunction(func);
 
-        if (pDestFunc == nullptr)
-            throw TUnknownIdentifierException(bodyNode.err);
+        // call the function, or substitute its body if it's small enough (and isn't already being substituted)
+        isInlineCall = INLINE_FUNCTIONS && pDestFunc->isInlinable() &&
+            std::find(inlineStack.begin(), inlineStack.end(), &pDestFunc->getFuncNode()) == inlineStack.end();
 
-        // allocate space on the stack for return bytes
-        size_t returnSize = pDestFunc->getReturnType().getSizeBytes();
+        // allocate space on the stack for return bytes (fastcall results come back in AX instead)
+        size_t returnSize = pDestFunc->isFastcall() ? 0 : pDestFunc->getReturnType().getSizeBytes();
 
         for (size_t i = 0; i < returnSize; i++) {
             if (i+1 < returnSize) {
-                OUT << "pushw 0\n";
+                ir.emit(IROpcode::PUSHW, irImm(0));
                 ++i;
             } else {
-                OUT << "push 0\n";
+                ir.emit(IROpcode::PUSH, irImm(0));
             }
         }
         scope.addPlaceholder(returnSize);
     }
 
+    // determine if this operator loads its operands from registers (rather than popping them off the stack)
+    bool usesRegisterOperands = false;
+    if (bodyNode.getNodeType() == ASTNodeType::BIN_OP) {
+        usesRegisterOperands = !static_cast<ASTOperator*>(&bodyNode)->isNullified();
+    } else if (bodyNode.getNodeType() == ASTNodeType::UNARY_OP) {
+        ASTOperator& unaryOp = *static_cast<ASTOperator*>(&bodyNode);
+        const TokenType opType = unaryOp.getOpTokenType();
+        usesRegisterOperands = !unaryOp.isNullified() && unaryOp.getUnaryType() != ASTUnaryType::TYPE_CAST &&
+            (opType == TokenType::OP_SUB || opType == TokenType::OP_BIT_NOT || opType == TokenType::OP_BOOL_NOT);
+    }
+
     // recurse this expression's children, bottom-up
-    size_t numChildren = bodyNode.size();
     std::vector<Type> resultTypes;
-    for (size_t i = 0; i < numChildren; ++i) {
-        resultTypes.push_back( assembleExpression(*bodyNode.at(i), outHandle, scope) );
+    std::vector<bool> isRegOperand; // operands left off the stack & loaded by this node
+    if (pDestFunc != nullptr) {
+        assembleArguments(*static_cast<ASTFunctionCall*>(&bodyNode), *pDestFunc, ir, scope, resultTypes, !isInlineCall);
+        isRegOperand.assign(resultTypes.size(), false);
+    } else {
+        assembleOperands(bodyNode, ir, scope, usesRegisterOperands, resultTypes, isRegOperand);
     }
 
     // assemble this node
@@ -443,31 +950,32 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
 
             // pop in reverse (higher first, later first)
             size_t resultSize = resultTypes[0].getSizeBytes(SIZE_ARR_AS_PTR);
-            if (resultSize == 2) {
-                OUT << "popw AX\n";
-                scope.pop(); // additional pop
-            } else if (resultSize == 1) {
-                OUT << "pop AL\n";
-                OUT << "xor AH, AH\n"; // zero out AH
+            if (isRegOperand[0]) {
+                loadRegisterOperand(*unaryOp.at(0), ir, scope, 'A');
             } else {
-                throw TInvalidOperationException(bodyNode.err);
+                if (resultSize == 2) {
+                    popValue(ir, scope, irReg("AX"), 2);
+                } else if (resultSize == 1) {
+                    popValue(ir, scope, irReg("AL"), 1);
+                    ir.emit(IROpcode::XOR, irReg("AH"), irReg("AH")); // zero out AH
+                } else {
+                    throw TInvalidOperationException(bodyNode.err);
+                }
             }
-            scope.pop();
 
             // determine output register
-            const std::string regA = resultSize == 1 ? "AL" : "AX";
+            const IROperand regA = irReg('A', resultSize);
             const TokenType opType = unaryOp.getOpTokenType();
 
             switch (opType) {
                 case TokenType::OP_SUB:
                 case TokenType::OP_BIT_NOT: {
-                    OUT << "not " << regA << '\n'; // flip all bits
+                    ir.emit(IROpcode::NOT, regA); // flip all bits
                     if (opType == TokenType::OP_SUB) // add 1 (2's complement)
-                        OUT << "add " << regA << ", 1\n";
+                        ir.emit(IROpcode::ADD, regA, irImm(1));
 
                     // push values to stack
-                    OUT << (resultSize == 2 ? "pushw AX\n" : "push AL\n");
-                    scope.addPlaceholder(resultSize);
+                    pushValue(ir, scope, regA, resultSize);
                     resultType = resultTypes[0];
                     break;
                 }
@@ -476,21 +984,22 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                     const std::string labelZero = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
                     const std::string labelMerge = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
 
-                    OUT << "add " << regA << ", 0\n";
-                    OUT << "jz " << labelZero << '\n'; // zero, set to 1
-                    OUT << (regA[1] == 'X' ? "movw " : "mov ") << regA << ", 0\n"; // currently non-zero, set to 0
-                    OUT << "jmp " << labelMerge << '\n'; // reconvene branches
+                    ir.emit(IROpcode::ADD, regA, irImm(0));
+                    ir.emit(IROpcode::JZ, irLabel(labelZero)); // zero, set to 1
+                    ir.emit(getMoveOp(resultSize), regA, irImm(0)); // currently non-zero, set to 0
+                    ir.emit(IROpcode::JMP, irLabel(labelMerge)); // reconvene branches
 
-                    OUT << labelZero << ":\n"; // currently zero, set to 1
-                    OUT << (regA[1] == 'X' ? "movw " : "mov ") << regA << ", 1\n";
-                    OUT << labelMerge << ":\n"; // reconvene branches
+                    ir.label(labelZero); // currently zero, set to 1
+                    ir.emit(getMoveOp(resultSize), regA, irImm(1));
+                    ir.label(labelMerge); // reconvene branches
 
                     // push values to stack
-                    BIN_OP_RECORD_BOOL;
+                    pushValue(ir, scope, irReg("AL"), 1);
+                    resultType = Type(TokenType::TYPE_BOOL);
                     break;
                 }
                 case TokenType::ASTERISK: {
-                    OUT << "movw BP, AX\n"; // dereference ptr whose address is stored in AX
+                    ir.emit(IROpcode::MOVW, irReg("BP"), irReg("AX")); // dereference ptr whose address is stored in AX
 
                     // pass final result size
                     resultType = resultTypes[0];
@@ -500,12 +1009,11 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                     if (unaryOp.isLValue() ||
                         (resultType.isPointer() && resultType.getPointers().back() != TYPE_EMPTY_PTR)) {
                         // buffer to stack
-                        OUT << "pushw BP\n";
-                        scope.addPlaceholder(2);
+                        pushValue(ir, scope, irReg("BP"), 2);
                     } else {
                         // move that value to the stack
                         for (size_t k = 0; k < resultType.getSizeBytes(); ++k) {
-                            OUT << "push [BP+" << k << "]\n";
+                            ir.emit(IROpcode::PUSH, irPointer(k));
                             scope.addPlaceholder();
                         }
                     }
@@ -513,8 +1021,7 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                 }
                 case TokenType::AMPERSAND: {
                     // add layer of indirection by pushing/buffering the address
-                    OUT << "pushw AX\n";
-                    scope.addPlaceholder(2);
+                    pushValue(ir, scope, irReg("AX"), 2);
 
                     // update result type
                     resultType = resultTypes[0];
@@ -531,8 +1038,7 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                     }
 
                     // push the size of whatever the result on the stack is (as uint)
-                    OUT << "pushw " << resultSize << '\n';
-                    scope.addPlaceholder(2);
+                    pushValue(ir, scope, irImm(resultSize), 2);
                     resultType = MEM_ADDR_TYPE;
                     break;
                 }
@@ -540,8 +1046,7 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                     // handle typecast unary
                     if (unaryOp.getUnaryType() == ASTUnaryType::TYPE_CAST) {
                         // just use the value from the top of the stack (operand)
-                        OUT << (resultSize == 2 ? "pushw AX\n" : "push AL\n");
-                        scope.addPlaceholder(resultSize);
+                        pushValue(ir, scope, regA, resultSize);
                         resultType = resultTypes[0];
                         break;
                     }
@@ -571,34 +1076,46 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
             // pop in reverse (higher first, later first)
             if (dominantSize < 1 || dominantSize > 2) throw TSyntaxException(bodyNode.err);
 
-            if (resultTypes[1].getSizeBytes() == 2) { // pop to BX
-                OUT << "popw BX\n";
-                scope.pop();
-            } else { // pop to BL and zero BH
-                OUT << "pop BL\n";
-                OUT << "xor BH, BH\n";
-            }
-            scope.pop();
+            // strength reduce multiplication, division & modulo by a constant (the constant is never loaded)
+            if (opType == TokenType::ASTERISK || opType == TokenType::OP_DIV || opType == TokenType::OP_MOD) {
+                const bool isUnsigned = resultTypes[0].isUnsigned() || resultTypes[1].isUnsigned();
+                const bool isMul = opType == TokenType::ASTERISK;
+
+                // the constant can be either factor, but only the divisor
+                size_t constIndex;
+                unsigned int constant;
+                if (isRegOperand[1] && getRegisterLiteral(*binOp.right(), constant)) constIndex = 1;
+                else if (isMul && isRegOperand[0] && getRegisterLiteral(*binOp.left(), constant)) constIndex = 0;
+                else constIndex = 2;
+
+                inst_seq_t reducedSeq;
+                if (constIndex < 2 && (isMul ?
+                        reduceMulByConstant(reducedSeq, 'A', 'C', constant, dominantSize, !isUnsigned) :
+                        reduceDivByConstant(reducedSeq, constant, dominantSize, !isUnsigned, opType == TokenType::OP_MOD, nextJMPLabelID))) {
+                    // load the other operand into AX
+                    const size_t operandIndex = 1 - constIndex;
+                    if (isRegOperand[operandIndex]) {
+                        loadRegisterOperand(*binOp.at(operandIndex), ir, scope, 'A');
+                    } else if (resultTypes[operandIndex].getSizeBytes(SIZE_ARR_AS_PTR) == 2) {
+                        popValue(ir, scope, irReg("AX"), 2);
+                    } else {
+                        popValue(ir, scope, irReg("AL"), 1);
+                        ir.emit(IROpcode::XOR, irReg("AH"), irReg("AH"));
+                    }
 
-            // ignore popping to the AL/AX register if nothing was pushed from the stack (for assignments)
-            if (isTokenAssignOp(opType)) {
-                // force assignment to pop the address
-                OUT << "popw AX\n";
-                scope.pop(2);
-            } else {
-                if (resultTypes[0].getSizeBytes(SIZE_ARR_AS_PTR) == 2) { // pop to AX
-                    OUT << "popw AX\n";
-                    scope.pop(2);
-                } else { // pop to AL and zero AH
-                    OUT << "pop AL\n";
-                    OUT << "xor AH, AH\n";
-                    scope.pop();
+                    // the result is left in AX/AL
+                    ir.emitBlocks(reducedSeq);
+                    pushValue(ir, scope, irReg('A', dominantSize), dominantSize);
+                    resultType = dominantType;
+                    break;
                 }
             }
 
+            loadBinaryOperands(binOp, ir, scope, resultTypes, isRegOperand);
+
             // determine output registers
-            const std::string regA = dominantSize == 1 ? "AL" : "AX";
-            const std::string regB = dominantSize == 1 ? "BL" : "BX";
+            const IROperand regA = irReg('A', dominantSize);
+            const IROperand regB = irReg('B', dominantSize);
 
             switch (opType) {
                 case TokenType::OP_ADD: case TokenType::OP_SUB: { // add/sub AX/AL to/from BX/BL
@@ -610,42 +1127,37 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                         typeA.popPointer(); // get internal size, also removes forced ptr status for accurate size
                         const size_t chunkSize = typeA.getSizeBytes();
 
-                        // mul needs AX register, so move it temporarily (don't need to do scope.pop/addPlaceholder)
-                        if (chunkSize > 0) {
-                            OUT << "pushw AX\n";
-                            OUT << "movw AX, " << chunkSize << '\n';
-                            OUT << "mul BX\n"; // other operand is in BX already
-                            OUT << "movw BX, AX\n"; // save new operand
-                            OUT << "popw AX\n"; // move AX back
+                        // scale BX in place if possible, otherwise mul needs AX register, so move it temporarily
+                        // (don't need to do scope.pop/addPlaceholder)
+                        inst_seq_t scaleSeq;
+                        if (chunkSize > 0 && reduceMulByConstant(scaleSeq, 'B', 'C', chunkSize, MEM_ADDR_SIZE, false)) {
+                            ir.emitBlocks(scaleSeq);
+                        } else if (chunkSize > 0) {
+                            pushValue(ir, scope, irReg("AX"), 2);
+                            ir.emit(IROpcode::MOVW, irReg("AX"), irImm(chunkSize));
+                            ir.emit(IROpcode::MUL, irReg("BX")); // other operand is in BX already
+                            ir.emit(IROpcode::MOVW, irReg("BX"), irReg("AX")); // save new operand
+                            popValue(ir, scope, irReg("AX"), 2); // move AX back
                         }
                     } else if (typeB.isPointer()) {
                         typeB.popPointer(); // get internal size, also removes forced ptr status for accurate size
                         const size_t chunkSize = typeB.getSizeBytes();
 
-                        // operand already in AX; move chunk size into CX
-                        if (chunkSize > 0) {
-                            OUT << "movw CX, " << chunkSize << '\n';
-                            OUT << "mul CX\n"; // other operand is in BX already
+                        // operand already in AX; scale it in place or move chunk size into CX
+                        inst_seq_t scaleSeq;
+                        if (chunkSize > 0 && reduceMulByConstant(scaleSeq, 'A', 'C', chunkSize, MEM_ADDR_SIZE, false)) {
+                            ir.emitBlocks(scaleSeq);
+                        } else if (chunkSize > 0) {
+                            ir.emit(IROpcode::MOVW, irReg("CX"), irImm(chunkSize));
+                            ir.emit(IROpcode::MUL, irReg("CX")); // other operand is in BX already
                         }
                     }
 
                     // perform add or sub
-                    if (isUnsigned) {
-                        if (opType == TokenType::OP_ADD) OUT_BIN_OP_2(add);
-                        else OUT_BIN_OP_2(sub);
-                    } else {
-                        if (opType == TokenType::OP_ADD) OUT_BIN_OP_2(sadd);
-                        else OUT_BIN_OP_2(ssub);
-                    }
+                    ir.emit(opType == TokenType::OP_ADD ? IROpcode::ADD : IROpcode::SUB, regA, regB, !isUnsigned);
 
                     // push result to stack (lowest-first)
-                    if (opType == TokenType::OP_MOD) // uses AX as result and DX as remainder in 16-bit mode
-                        OUT << (dominantSize == 2 ? "pushw DX\n" : "push AH\n");
-                    else
-                        OUT << (dominantSize == 2 ? "pushw AX\n" : "push AL\n");
-
-                    // record push
-                    scope.addPlaceholder(dominantSize);
+                    pushValue(ir, scope, regA, dominantSize);
                     resultType = dominantType;
                     break;
                 }
@@ -654,237 +1166,127 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                     Type typeA = resultTypes[0], typeB = resultTypes[1];
                     const bool isUnsigned = typeA.isUnsigned() || typeB.isUnsigned();
 
-                    // all use similar/the same process, so combined them here
-                    if (isUnsigned) {
-                        switch (opType) {
-                            case TokenType::ASTERISK:   OUT_BIN_OP_1B(mul); break; // mul AX/AL by BX/BL
-                            case TokenType::OP_DIV:     OUT_BIN_OP_1B(div); break; // div AX/AL by BX/BL
-                            case TokenType::OP_MOD:     OUT_BIN_OP_1B(div); break; // mod AX/AL by BX/BL
-                            case TokenType::OP_BIT_OR:  OUT_BIN_OP_2(or); break; // bitwise or
-                            case TokenType::AMPERSAND:  OUT_BIN_OP_2(and); break; // bitwise and
-                            case TokenType::OP_BIT_XOR: OUT_BIN_OP_2(xor); break; // bitwise xor
-                            default: break; // doesn't get here
-                        }
-                    } else {
-                        switch (opType) {
-                            case TokenType::ASTERISK:   OUT_BIN_OP_1B(smul); break; // mul AX/AL by BX/BL
-                            case TokenType::OP_DIV:     OUT_BIN_OP_1B(sdiv); break; // div AX/AL by BX/BL
-                            case TokenType::OP_MOD:     OUT_BIN_OP_1B(sdiv); break; // mod AX/AL by BX/BL
-                            case TokenType::OP_BIT_OR:  OUT_BIN_OP_2(or); break; // bitwise or
-                            case TokenType::AMPERSAND:  OUT_BIN_OP_2(and); break; // bitwise and
-                            case TokenType::OP_BIT_XOR: OUT_BIN_OP_2(xor); break; // bitwise xor
-                            default: break; // doesn't get here
-                        }
+                    // all use similar/the same process, so combined them here (only mul & div have signed versions)
+                    switch (opType) {
+                        case TokenType::ASTERISK:   ir.emit(IROpcode::MUL, regB, IROperand(), !isUnsigned); break; // mul AX/AL by BX/BL
+                        case TokenType::OP_DIV:     ir.emit(IROpcode::DIV, regB, IROperand(), !isUnsigned); break; // div AX/AL by BX/BL
+                        case TokenType::OP_MOD:     ir.emit(IROpcode::DIV, regB, IROperand(), !isUnsigned); break; // mod AX/AL by BX/BL
+                        case TokenType::OP_BIT_OR:  ir.emit(IROpcode::OR, regA, regB); break; // bitwise or
+                        case TokenType::AMPERSAND:  ir.emit(IROpcode::AND, regA, regB); break; // bitwise and
+                        case TokenType::OP_BIT_XOR: ir.emit(IROpcode::XOR, regA, regB); break; // bitwise xor
+                        default: break; // doesn't get here
                     }
 
                     // push result to stack (lowest-first)
-                    if (opType == TokenType::OP_MOD) // uses AX as result and DX as remainder in 16-bit mode
-                        OUT << (dominantSize == 2 ? "pushw DX\n" : "push AH\n");
-                    else
-                        OUT << (dominantSize == 2 ? "pushw AX\n" : "push AL\n");
-
-                    // get the sign from DH for 16-bit mult
-                    if (opType == TokenType::ASTERISK && dominantSize == 2 && !isUnsigned) {
-                        // grab sign from DH
-                        OUT << "pop CH\n";
-                        OUT << "mov CL, DH\n";
-                        OUT << "and CL, 128\n";
-                        OUT << "or CH, CL\n";
-                        OUT << "push CH\n";
+                    if (opType == TokenType::OP_MOD) { // uses AX as result and DX as remainder in 16-bit mode
+                        pushValue(ir, scope, irReg(dominantSize == 2 ? "DX" : "AH"), dominantSize);
+                    } else if (opType == TokenType::ASTERISK && dominantSize == 2 && !isUnsigned) {
+                        // get the sign from DH for 16-bit mult
+                        ir.emit(IROpcode::MOV, irReg("CL"), irReg("DH"));
+                        ir.emit(IROpcode::AND, irReg("CL"), irImm(128));
+                        ir.emit(IROpcode::OR, irReg("AH"), irReg("CL"));
+                        pushValue(ir, scope, regA, dominantSize);
+                    } else {
+                        pushValue(ir, scope, regA, dominantSize);
                     }
-
-                    // record push
-                    scope.addPlaceholder(dominantSize);
                     resultType = dominantType;
                     break;
                 }
                 case TokenType::OP_BOOL_OR: {
-                    OUT_BIN_OP_2(or);
+                    ir.emit(IROpcode::OR, regA, regB);
 
                     // if ZF is cleared, expression is true (set to 1)
                     const std::string labelName = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    OUT << "jz " << labelName << '\n'; // skip over assignment to 1
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 1\n";
-                    else                OUT << "mov " << regA << ", 1\n";
-                    OUT << labelName << ":\n"; // reconvene with other branch
+                    ir.emit(IROpcode::JZ, irLabel(labelName)); // skip over assignment to 1
+                    ir.emit(getMoveOp(dominantSize), regA, irImm(1));
+                    ir.label(labelName); // reconvene with other branch
 
                     // push result to stack (lowest-first)
-                    BIN_OP_RECORD_BOOL;
+                    pushValue(ir, scope, irReg("AL"), 1);
+                    resultType = Type(TokenType::TYPE_BOOL);
                     break;
                 }
                 case TokenType::OP_BOOL_AND: { // if either one is zero, boolean and is false
                     // put 0 into regA if zero, 1 otherwise
                     // if ZF is set, set regA (non-zero -> 1)
                     std::string labelName = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    OUT << "or " << regA << ", 0\n"; // sets ZF if 0
-                    OUT << "jz " << labelName << '\n'; // skip over assignment to 1
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 1\n";
-                    else                OUT << "mov " << regA << ", 1\n";
-                    OUT << labelName << ":\n"; // reconvene with other branch
+                    ir.emit(IROpcode::OR, regA, irImm(0)); // sets ZF if 0
+                    ir.emit(IROpcode::JZ, irLabel(labelName)); // skip over assignment to 1
+                    ir.emit(getMoveOp(dominantSize), regA, irImm(1));
+                    ir.label(labelName); // reconvene with other branch
 
                     // put 0 into regB if zero, 1 otherwise
                     // if ZF is set, set regB (non-zero -> 1)
                     labelName = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    OUT << "or " << regB << ", 0\n"; // sets ZF if 0
-                    OUT << "jz " << labelName << '\n'; // skip over assignment to 1
-                    if (regB[1] == 'X')
-                        OUT << "movw " << regB << ", 1\n";
-                    else
-                        OUT << "mov " << regB << ", 1\n";
-                    OUT << labelName << ":\n"; // reconvene with other branch
+                    ir.emit(IROpcode::OR, regB, irImm(0)); // sets ZF if 0
+                    ir.emit(IROpcode::JZ, irLabel(labelName)); // skip over assignment to 1
+                    ir.emit(getMoveOp(dominantSize), regB, irImm(1));
+                    ir.label(labelName); // reconvene with other branch
 
                     // push regA & regB (0b0 & 0b1 or some combination)
-                    OUT << "and " << regA << ", " << regB << '\n';
-
-                    // push result to stack (lowest-first)
-                    BIN_OP_RECORD_BOOL;
-                    break;
-                }
-                case TokenType::OP_EQ: {
-                    // if ZF is set, equal
-                    const std::string labelEQ = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    const std::string labelMerger = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    OUT << "cmp " << regA << ", " << regB << '\n';
-
-                    OUT << "jz " << labelEQ << '\n';
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 0\n"; // non-zero becomes 0
-                    else                OUT << "mov " << regA << ", 0\n"; // non-zero becomes 0
-                    OUT << "jmp " << labelMerger << '\n'; // reconvene with other branch
-
-                    OUT << labelEQ << ":\n";
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 1\n"; // zero becomes 1
-                    else                OUT << "mov " << regA << ", 1\n"; // zero becomes 1
-                    OUT << labelMerger << ":\n"; // reconvene with other branch
-
-                    // push result to stack (lowest-first)
-                    BIN_OP_RECORD_BOOL;
-                    break;
-                }
-                case TokenType::OP_NEQ: {
-                    // if A ^ B is zero, equal (keep as 0)
-                    const std::string labelMerger = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-
-                    OUT << "xor " << regA << ", " << regB << '\n';
-                    OUT << "jz " << labelMerger << '\n';
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 1\n"; // non-zero becomes 1
-                    else                OUT << "mov " << regA << ", 1\n"; // non-zero becomes 1
-                    OUT << labelMerger << ":\n"; // reconvene with other branch
+                    ir.emit(IROpcode::AND, regA, regB);
 
                     // push result to stack (lowest-first)
-                    BIN_OP_RECORD_BOOL;
-                    break;
-                }
-                case TokenType::OP_LT: {
-                    // if A < B, CF will be set
-                    const bool isUnsigned = resultTypes[0].isUnsigned() || resultTypes[1].isUnsigned();
-                    OUT << (isUnsigned ? "cmp " : "scmp ") << regA << ", " << regB << '\n';
-
-                    const std::string labelGTE = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    const std::string labelMerger = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    OUT << "jnc " << labelGTE << '\n';
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 1\n"; // set regA to 1
-                    else                OUT << "mov " << regA << ", 1\n"; // set regA to 1
-                    OUT << "jmp " << labelMerger << '\n'; // reconvene with other branch
-
-                    OUT << labelGTE << ":\n"; // set regA to 0
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 0\n";
-                    else                OUT << "mov " << regA << ", 0\n";
-                    OUT << labelMerger << ":\n"; // reconvene with other branch
-
-                    /// push result to stack (lowest-first)
-                    BIN_OP_RECORD_BOOL;
-                    break;
-                }
-                case TokenType::OP_GT: {
-                    // if A > B, CF will be set
-                    const bool isUnsigned = resultTypes[0].isUnsigned() || resultTypes[1].isUnsigned();
-                    OUT << (isUnsigned ? "cmp " : "scmp ") << regB << ", " << regA << '\n';
-
-                    const std::string labelLTE = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    const std::string labelMerger = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    OUT << "jnc " << labelLTE << '\n';
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 1\n"; // set regA to 1
-                    else                OUT << "mov " << regA << ", 1\n"; // set regA to 1
-                    OUT << "jmp " << labelMerger << '\n'; // reconvene with other branch
-
-                    OUT << labelLTE << ":\n"; // set regA to 0
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 0\n";
-                    else                OUT << "mov " << regA << ", 0\n";
-                    OUT << labelMerger << ":\n"; // reconvene with other branch
-
-                    // push result to stack (lowest-first)
-                    BIN_OP_RECORD_BOOL;
-                    break;
-                }
-                case TokenType::OP_LTE: {
-                    // if A > B, CF will be set
-                    const bool isUnsigned = resultTypes[0].isUnsigned() || resultTypes[1].isUnsigned();
-                    OUT << (isUnsigned ? "cmp " : "scmp ") << regB << ", " << regA << '\n';
-
-                    const std::string labelLTE = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    const std::string labelMerger = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    OUT << "jnc " << labelLTE << '\n';
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 0\n"; // set regA to 0
-                    else                OUT << "mov " << regA << ", 0\n"; // set regA to 0
-                    OUT << "jmp " << labelMerger << '\n'; // reconvene with other branch
-
-                    OUT << labelLTE << ":\n"; // set regA to 1
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 1\n";
-                    else                OUT << "mov " << regA << ", 1\n";
-                    OUT << labelMerger << ":\n"; // reconvene with other branch
-
-                    // push result to stack (lowest-first)
-                    BIN_OP_RECORD_BOOL;
+                    pushValue(ir, scope, irReg("AL"), 1);
+                    resultType = Type(TokenType::TYPE_BOOL);
                     break;
                 }
+                case TokenType::OP_EQ:
+                case TokenType::OP_NEQ:
+                case TokenType::OP_LT:
+                case TokenType::OP_GT:
+                case TokenType::OP_LTE:
                 case TokenType::OP_GTE: {
-                    // if A < B, CF will be set
+                    // a single compare & jump over the assignment to 0 (mov doesn't touch the flags)
                     const bool isUnsigned = resultTypes[0].isUnsigned() || resultTypes[1].isUnsigned();
-                    OUT << (isUnsigned ? "cmp " : "scmp ") << regA << ", " << regB << '\n';
-
-                    const std::string labelGTE = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
                     const std::string labelMerger = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    OUT << "jnc " << labelGTE << '\n';
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 0\n"; // set regA to 0
-                    else                OUT << "mov " << regA << ", 0\n"; // set regA to 0
-                    OUT << "jmp " << labelMerger << '\n'; // reconvene with other branch
+                    ir.emit(IROpcode::CMP, regA, regB);
 
-                    OUT << labelGTE << ":\n"; // set regA to 1
-                    if (regA[1] == 'X') OUT << "movw " << regA << ", 1\n";
-                    else                OUT << "mov " << regA << ", 1\n";
-                    OUT << labelMerger << ":\n"; // reconvene with other branch
+                    ir.emit(getMoveOp(dominantSize), regA, irImm(1)); // assume true
+                    ir.emit(getCompareJump(opType, isUnsigned, true), irLabel(labelMerger));
+                    ir.emit(getMoveOp(dominantSize), regA, irImm(0)); // otherwise false
+                    ir.label(labelMerger); // reconvene with other branch
 
                     // push result to stack (lowest-first)
-                    BIN_OP_RECORD_BOOL;
+                    pushValue(ir, scope, irReg("AL"), 1);
+                    resultType = Type(TokenType::TYPE_BOOL);
                     break;
                 }
                 case TokenType::OP_LSHIFT:
                 case TokenType::OP_RSHIFT: {
                     // can only use 8-bit register for shift count
-                    OUT << (opType == TokenType::OP_LSHIFT ? "shl " : "shr ") << regA << ", BL\n";
+                    ir.emit(opType == TokenType::OP_LSHIFT ? IROpcode::SHL : IROpcode::SHR, regA, irReg("BL"));
 
                     // push result to stack (lowest-first)
-                    OUT << (dominantSize == 2 ? "pushw AX\n" : "push AL\n");
-                    scope.addPlaceholder(dominantSize);
+                    pushValue(ir, scope, regA, dominantSize);
                     resultType = dominantType;
                     break;
                 }
                 case TokenType::ASSIGN: {
-                    // take the address of the given lvalue from the stack and assign a value to it
-                    OUT << "movw BP, AX\n"; // move address to BP
-
-                    // move the rvalue to the lvalue's address
                     const size_t rvalueSize = resultTypes[1].getSizeBytes();
-                    if (rvalueSize == 2) {
-                        OUT << "mov [BP+0], BL" << '\n';
-                        OUT << "mov [BP+1], BH" << '\n';
+                    const std::pair<IROperand, Type>* pRegisterVar = isRegOperand[0] ? findRegisterVar(binOp.left()->id) : nullptr;
+                    if (pRegisterVar != nullptr) {
+                        // store the rvalue straight to the variable's register
+                        ir.emit(IROpcode::MOVW, pRegisterVar->first, irReg("BX"));
+                    } else if (isRegOperand[0]) {
+                        // store the rvalue straight to the variable
+                        ASTIdentifier& identifier = *static_cast<ASTIdentifier*>(binOp.left());
+                        const size_t stackOffset = scope.getOffset(identifier.id, identifier.err);
+                        ir.emit(IROpcode::MOV, irStack(stackOffset), irReg("BL"));
+                        if (rvalueSize == 2)
+                            ir.emit(IROpcode::MOV, irStack(stackOffset-1), irReg("BH"));
                     } else {
-                        OUT << "mov [BP+0], BL" << '\n';
+                        // take the address of the given lvalue from the stack and assign a value to it
+                        ir.emit(IROpcode::MOVW, irReg("BP"), irReg("AX")); // move address to BP
+
+                        // move the rvalue to the lvalue's address
+                        ir.emit(IROpcode::MOV, irPointer(0), irReg("BL"));
+                        if (rvalueSize == 2)
+                            ir.emit(IROpcode::MOV, irPointer(1), irReg("BH"));
                     }
 
                     // push the value of the variable onto the stack (lowest-first)
-                    OUT << (rvalueSize == 2 ? "pushw BX\n" : "push BL\n");
-                    scope.addPlaceholder(rvalueSize);
+                    pushValue(ir, scope, irReg('B', rvalueSize), rvalueSize);
                     resultType = resultTypes[1];
                     break;
                 }
@@ -898,8 +1300,7 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
             ASTIntLiteral* pLit = static_cast<ASTIntLiteral*>(&bodyNode);
             unsigned short value = pLit->val & 0xFFFF;
             resultType = Type(TokenType::TYPE_INT);
-            OUT << "pushw " << value << '\n';
-            scope.addPlaceholder(resultType.getSizeBytes());
+            pushValue(ir, scope, irImm(value), resultType.getSizeBytes());
             break;
         }
         case ASTNodeType::LIT_BOOL: {
@@ -907,8 +1308,7 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
             ASTBoolLiteral* pLit = static_cast<ASTBoolLiteral*>(&bodyNode);
             unsigned short value = pLit->val & 0xFF;
             resultType = Type(TokenType::TYPE_BOOL);
-            OUT << "push " << value << '\n';
-            scope.addPlaceholder(resultType.getSizeBytes());
+            pushValue(ir, scope, irImm(value), resultType.getSizeBytes());
             break;
         }
         case ASTNodeType::LIT_CHAR: {
@@ -916,72 +1316,76 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
             ASTCharLiteral* pLit = static_cast<ASTCharLiteral*>(&bodyNode);
             unsigned short value = pLit->val & 0xFF;
             resultType = Type(TokenType::TYPE_CHAR);
-            OUT << "push " << value << '\n';
-            scope.addPlaceholder(resultType.getSizeBytes());
+            pushValue(ir, scope, irImm(value), resultType.getSizeBytes());
             break;
         }
         case ASTNodeType::LIT_FLOAT: {
             throw TDevException("Float arithmetic not implemented yet!");
         }
         case ASTNodeType::IDENTIFIER: {
-            // lookup identifier
+            // lookup identifier (a variable kept in a register is only ever read here)
             ASTIdentifier& identifier = *static_cast<ASTIdentifier*>(&bodyNode);
-            size_t stackOffset = scope.getOffset(identifier.raw, identifier.err);
-            Type idenType = scope.getVariable(identifier.raw, identifier.err)->type;
+            const std::pair<IROperand, Type>* pRegisterVar = findRegisterVar(identifier.id);
+            if (pRegisterVar != nullptr) {
+                if (identifier.isLValue())
+                    throw TDevException("Variable kept in a register used as an address in assembleExpression!");
+                pushValue(ir, scope, pRegisterVar->first, 2);
+                resultType = pRegisterVar->second;
+                break;
+            }
+
+            size_t stackOffset = scope.getOffset(identifier.id, identifier.err);
+            Type idenType = scope.getVariable(identifier.id, identifier.err)->type;
 
             // if there aren't any subscripts, handle the value here
             if (identifier.getNumSubscripts() == 0) {
                 if (idenType.isPointer()) { // handle pointers
                     // push the address onto the stack
-                    OUT << "movw BP, SP\n"; // move SP into BP for manipulation w/o affecting the SP
-                    OUT << "sub BP, " << stackOffset << '\n';
-                    OUT << "pushw BP\n";
-                    scope.addPlaceholder(2);
+                    ir.emit(IROpcode::MOVW, irReg("BP"), irReg("SP")); // move SP into BP for manipulation w/o affecting the SP
+                    ir.emit(IROpcode::SUB, irReg("BP"), irImm(stackOffset));
+                    pushValue(ir, scope, irReg("BP"), 2);
 
                     // if this is a reference pointer (ie. array passed as an argument), dereference it
                     if (idenType.isReferencePointer()) {
                         // doesn't need to be a reference pointer anymore
-                        OUT << "popw BP\n"; // move address back into BP
+                        popValue(ir, scope, irReg("BP"), 2); // move address back into BP
                         idenType.setIsReferencePointer(false);
-                        scope.pop(2);
 
                         // push the referenced value
                         const size_t typeSize = idenType.getSizeBytes();
                         for (size_t k = 0; k < typeSize; ++k)
-                            OUT << "push [BP+" << k << "]\n";
+                            ir.emit(IROpcode::PUSH, irPointer(k));
                         scope.addPlaceholder(typeSize);
                     }
 
                     // if this is an lvalue, leave the address on the stack
                     if (!idenType.isArray() && !identifier.isLValue()) { // push the value of the pointer
                         const size_t typeSize = idenType.getSizeBytes();
-                        OUT << "popw BP\n"; // pop address back into BP
-                        scope.pop(2);
+                        popValue(ir, scope, irReg("BP"), 2); // pop address back into BP
 
                         for (size_t k = 0; k < typeSize; ++k)
-                            OUT << "push [BP+" << k << "]\n";
+                            ir.emit(IROpcode::PUSH, irPointer(k));
                         scope.addPlaceholder(typeSize);
                     }
                 } else { // handle primitives
                     // if this is an lvalue, pass the address
                     if (identifier.isLValue()) {
                         // push the address onto the stack
-                        OUT << "movw BP, SP\n"; // move SP into BP for manipulation w/o affecting the SP
-                        OUT << "sub BP, " << stackOffset << '\n';
-                        OUT << "pushw BP\n";
-                        scope.addPlaceholder(2);
+                        ir.emit(IROpcode::MOVW, irReg("BP"), irReg("SP")); // move SP into BP for manipulation w/o affecting the SP
+                        ir.emit(IROpcode::SUB, irReg("BP"), irImm(stackOffset));
+                        pushValue(ir, scope, irReg("BP"), 2);
                     } else { // this is an rvalue, push the value onto the stack
                         const size_t typeSize = idenType.getSizeBytes();
                         for (size_t j = 0; j < typeSize; ++j) {
-                            OUT << "push [SP-" << stackOffset << "]\n";
+                            ir.emit(IROpcode::PUSH, irStack(stackOffset));
                             scope.addPlaceholder();
                         }
                     }
                 }
             } else {
                 // push the address onto the stack
-                OUT << "movw BP, SP\n"; // store the SP in BP for manipulation w/o affecting SP directly
-                OUT << "sub BP, " << stackOffset << '\n';
+                ir.emit(IROpcode::MOVW, irReg("BP"), irReg("SP")); // store the SP in BP for manipulation w/o affecting SP directly
+                ir.emit(IROpcode::SUB, irReg("BP"), irImm(stackOffset));
 
                 // if this is a reference pointer (ie. array passed as an argument), dereference it
                 if (idenType.isReferencePointer()) {
@@ -991,12 +1395,11 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                     // push the referenced value
                     const size_t typeSize = idenType.getSizeBytes();
                     for (size_t k = 0; k < typeSize; ++k)
-                        OUT << "push [BP+" << k << "]\n";
+                        ir.emit(IROpcode::PUSH, irPointer(k));
                     scope.addPlaceholder(typeSize);
                 } else {
                     // not a reference pointer, push the address
-                    OUT << "pushw BP\n"; // push the address of this identifier
-                    scope.addPlaceholder(2);
+                    pushValue(ir, scope, irReg("BP"), 2); // push the address of this identifier
                 }
             }
 
@@ -1005,49 +1408,29 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
             break;
         }
         case ASTNodeType::FUNCTION_CALL: {
-            // lookup the function
+            // the function was looked up (& whether it's inlined decided) when its return bytes were allocated
             ASTFunctionCall& func = *static_cast<ASTFunctionCall*>(&bodyNode);
-            const std::string& funcName = func.raw;
-            if (labelMap.count(funcName) == 0) throw TUnknownIdentifierException(func.err);
-
-            // find function and verify parameters match
-            AssembledFunc* pDestFunc = nullptr;
             const size_t numParams = func.size();
-            auto [itr, end] = labelMap.equal_range(funcName);
-            for ((void)itr; itr != end; ++itr) {
-                // check if parameters match
-                const std::vector<Type>& paramTypes = itr->second.getParamTypes();
-                if (paramTypes.size() != func.size()) continue;
-
-                size_t j;
-                for (j = 0; j < numParams; ++j) {
-                    const Type& actualType = static_cast<ASTTypedNode*>(func.at(j))->getTypeRef();
-                    if (paramTypes[j].isParamMatch(actualType, func.at(j)->err) == TYPE_PARAM_MISMATCH) break;
-                }
-
-                // if broken prematurely, a type didn't match
-                if (j == numParams) {
-                    pDestFunc = &itr->second;
-                    break;
-                }
-            }
+            if (isInlineCall) assembleInlineCall(*pDestFunc, ir);
+            else              ir.emit(IROpcode::CALL, irLabel(pDestFunc->getStartLabel()));
 
-            if (pDestFunc == nullptr)
-                throw TUnknownIdentifierException(bodyNode.err);
-
-            // call the function
-            OUT << "call " << pDestFunc->getStartLabel() << '\n';
-
-            // pop args off stack after
+            // pop args off stack after, along with the register args a called function pushed to its frame
             size_t paramTotalSize = 0;
-            for (size_t j = 0; j < numParams; ++j) {
-                paramTotalSize += resultTypes[j].getSizeBytes();
+            for (size_t j = 0; j < numParams - (isInlineCall ? 0 : pDestFunc->getNumRegisterParams()); ++j) {
+                paramTotalSize += resultTypes[j].getSizeBytes(SIZE_ARR_AS_PTR); // arrays are passed as pointers
             }
-            if (paramTotalSize > 0) {
-                OUT << "sub SP, " << paramTotalSize << '\n';
+            const size_t frameSize = isInlineCall ? paramTotalSize : pDestFunc->getFrameParamSize();
+            if (frameSize > 0)
+                ir.emit(IROpcode::SUB, irReg("SP"), irImm(frameSize));
+            if (paramTotalSize > 0)
                 scope.pop(paramTotalSize);
-            }
             resultType = pDestFunc->getReturnType();
+
+            // push a fastcall result from AX/AL
+            const size_t returnSize = resultType.getSizeBytes();
+            if (pDestFunc->isFastcall() && returnSize > 0) {
+                pushValue(ir, scope, irReg('A', returnSize), returnSize);
+            }
             break;
         }
         case ASTNodeType::EXPR:
@@ -1066,14 +1449,13 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
             resultType = pStrLit->getTypeRef();
 
             // write label
-            OUT << "pushw " << STR_DATA_LABEL_PREFIX << nextStringDataID++ << '\n';
-            scope.addPlaceholder(2);
+            pushValue(ir, scope, irLabel(STR_DATA_LABEL_PREFIX + std::to_string(nextStringDataID++)), 2);
             break;
         }
         case ASTNodeType::ASM: {
             // paste inline assembly to file
             ASTInlineASM* pASM = static_cast<ASTInlineASM*>(&bodyNode);
-            OUT << pASM->getRaw() << '\n';
+            ir.emitAssembly(pASM->getRaw());
             resultType = pASM->getTypeRef();
             break;
         }
@@ -1093,7 +1475,7 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
 
                     // pad bytes
                     if (resultSize == 1) {
-                        OUT << "push 0\n";
+                        ir.emit(IROpcode::PUSH, irImm(0));
                         scope.addPlaceholder(1);
                     }
 
@@ -1102,8 +1484,7 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                                             instType == TokenType::ASM_LOAD_BX ? "BX" :
                                             instType == TokenType::ASM_LOAD_CX ? "CX" : "DX";
 
-                    OUT << "popw " << reg << '\n';
-                    scope.pop(2);
+                    popValue(ir, scope, irReg(reg), 2);
                     break;
                 }
                 case TokenType::ASM_READ_AX:
@@ -1115,8 +1496,7 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
                                             instType == TokenType::ASM_READ_BX ? "BX" :
                                             instType == TokenType::ASM_READ_CX ? "CX" : "DX";
 
-                    OUT << "pushw " << reg << '\n';
-                    scope.addPlaceholder(2);
+                    pushValue(ir, scope, irReg(reg), 2);
                     break;
                 }
                 default: throw TSyntaxException(pInst->err);
@@ -1138,7 +1518,7 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
 
         const size_t numPointers = resultType.getNumPointers();
         const size_t numSubscripts = pTypedBody->getNumSubscripts();
-        const std::vector<ASTArraySubscript*>& subscripts = pTypedBody->getSubscripts();
+        const ast_vector_t<ASTArraySubscript*>& subscripts = pTypedBody->getSubscripts();
         const bool isLValue = pTypedBody->isLValue();
 
         if (numSubscripts > numPointers)
@@ -1157,44 +1537,45 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
             // if this is a pointer (not an array), dereference and get its address
             if (lastPtrSize == TYPE_EMPTY_PTR && !isImplicitArrayHint) {
                 // pop address into BP
-                OUT << "popw BP\n";
-                OUT << "push [BP+0]\n";
-                OUT << "push [BP+1]\n";
+                ir.emit(IROpcode::POPW, irReg("BP"));
+                ir.emit(IROpcode::PUSH, irPointer(0));
+                ir.emit(IROpcode::PUSH, irPointer(1));
             }
 
             // assemble subscript (ast_nodes.cpp makes sure these are all implicitly converted to int)
-            assembleExpression(*pSub, outHandle, scope);
+            assembleExpression(*pSub, ir, scope);
 
-            OUT << "popw AX\n"; // pop subscript off stack
-            OUT << "popw CX\n"; // pop address back into CX
+            popValue(ir, scope, irReg("AX"), 2); // pop subscript off stack
+            popValue(ir, scope, irReg("CX"), 2); // pop address back into CX
 
             // if the chunk size isn't 1, scale subscript in AX by it
-            if (chunkSize > 1) {
-                OUT << "movw BX, " << chunkSize << '\n'; // move chunkSize into BX to force 16-bit
-                OUT << "mul BX\n"; // scale by chunk size
+            inst_seq_t scaleSeq;
+            if (chunkSize > 1 && reduceMulByConstant(scaleSeq, 'A', 'B', chunkSize, MEM_ADDR_SIZE, false)) {
+                ir.emitBlocks(scaleSeq);
+            } else if (chunkSize > 1) {
+                ir.emit(IROpcode::MOVW, irReg("BX"), irImm(chunkSize)); // move chunkSize into BX to force 16-bit
+                ir.emit(IROpcode::MUL, irReg("BX")); // scale by chunk size
             }
-            OUT << (resultType.isUnsigned() ? "add" : "sadd") << " CX, AX\n"; // add the chunk to the pointer
-            OUT << "pushw CX\n"; // put address back onto stack
-            scope.pop(2); // 4 pops - 2 pushes = 2 net pops
+            ir.emit(IROpcode::ADD, irReg("CX"), irReg("AX"), !resultType.isUnsigned()); // add the chunk to the pointer
+            pushValue(ir, scope, irReg("CX"), 2); // put address back onto stack
         }
 
         // if this isn't an array and isn't an lvalue, dereference the final address on the stack
         if (!isLValue && (resultType.getNumPointers() == 0 || resultType.getPointers().back() == TYPE_EMPTY_PTR)) {
             // dereference final address on stack
-            OUT << "popw BP\n"; // move address back into BP
-            scope.pop(2);
+            popValue(ir, scope, irReg("BP"), 2); // move address back into BP
 
             // push the referenced value
             const size_t typeSize = resultType.getSizeBytes();
             for (size_t k = 0; k < typeSize; ++k)
-                OUT << "push [BP+" << k << "]\n";
+                ir.emit(IROpcode::PUSH, irPointer(k));
             scope.addPlaceholder(typeSize);
         }
     }
 
     // implicit cast
     if (resultType != desiredType) {
-        implicitCast(outHandle, resultType, desiredType, scope, bodyNode.err);
+        implicitCast(ir, resultType, desiredType, scope, bodyNode.err);
         resultType = desiredType; // update type to match
     }
 
@@ -1205,8 +1586,108 @@ Type assembleExpression(ASTNode& bodyNode, std::ofstream& outHandle, Scope& scop
     return resultType;
 }
 
+// true if the condition only evaluates to 0 or 1 and can be branched on without materializing it
+static bool isBranchCondition(ASTNode& condNode) {
+    if (static_cast<ASTTypedNode*>(&condNode)->getNumSubscripts() > 0) return false;
+
+    switch (condNode.getNodeType()) {
+        case ASTNodeType::EXPR: return condNode.size() == 1 && isBranchCondition(*condNode.at(0));
+        case ASTNodeType::UNARY_OP: {
+            ASTOperator& unaryOp = *static_cast<ASTOperator*>(&condNode);
+            return !unaryOp.isNullified() && unaryOp.getUnaryType() != ASTUnaryType::TYPE_CAST &&
+                unaryOp.getOpTokenType() == TokenType::OP_BOOL_NOT;
+        }
+        case ASTNodeType::BIN_OP: {
+            ASTOperator& binOp = *static_cast<ASTOperator*>(&condNode);
+            if (binOp.isNullified()) return false;
+            switch (binOp.getOpTokenType()) {
+                case TokenType::OP_BOOL_AND: case TokenType::OP_BOOL_OR:
+                case TokenType::OP_EQ: case TokenType::OP_NEQ:
+                case TokenType::OP_LT: case TokenType::OP_GT:
+                case TokenType::OP_LTE: case TokenType::OP_GTE: return true;
+                default: return false;
+            }
+        }
+        default: return false;
+    }
+}
+
+// assembles a condition as control flow, jumping to the label if it's true (or false) and falling through otherwise
+void assembleBranch(ASTNode& condNode, IRBuilder& ir, Scope& scope, const std::string& label, const bool jumpIfTrue) {
+    // parentheses & the implicit cast to bool don't change whether a 0/1 value or a register operand is zero
+    ASTTypedNode& typedNode = *static_cast<ASTTypedNode*>(&condNode);
+    if (condNode.getNodeType() == ASTNodeType::EXPR && condNode.size() == 1 && typedNode.getNumSubscripts() == 0) {
+        ASTNode& child = *condNode.at(0);
+        if (isBranchCondition(child) || (typedNode.getTypeRef() == Type(TokenType::TYPE_BOOL) && isRegisterOperand(child, scope))) {
+            assembleBranch(child, ir, scope, label, jumpIfTrue);
+            return;
+        }
+    }
+
+    // constant conditions either always jump or never do
+    unsigned int constant;
+    if (isRegisterOperand(condNode, scope) && getRegisterLiteral(condNode, constant)) {
+        if ((constant != 0) == jumpIfTrue) ir.emit(IROpcode::JMP, irLabel(label));
+        condNode.isAssembled = true;
+        return;
+    }
+
+    // anything else is evaluated and tested for zero
+    if (!isBranchCondition(condNode)) {
+        size_t resultSize;
+        if (isRegisterOperand(condNode, scope)) { // load straight to AX
+            resultSize = loadRegisterOperand(condNode, ir, scope, 'A').getSizeBytes();
+            condNode.isAssembled = true;
+        } else {
+            resultSize = assembleExpression(condNode, ir, scope).getSizeBytes(SIZE_ARR_AS_PTR);
+            popValue(ir, scope, irReg('A', resultSize), resultSize);
+        }
+
+        ir.emit(IROpcode::BUF, irReg('A', resultSize)); // set ZF if false
+        ir.emit(jumpIfTrue ? IROpcode::JNZ : IROpcode::JZ, irLabel(label));
+        return;
+    }
+
+    ASTOperator& op = *static_cast<ASTOperator*>(&condNode);
+    const TokenType opType = op.getOpTokenType();
+    if (opType == TokenType::OP_BOOL_NOT) {
+        assembleBranch(*op.at(0), ir, scope, label, !jumpIfTrue);
+        return;
+    }
+
+    // short-circuit boolean operators, skipping the right side once the result is known
+    if (opType == TokenType::OP_BOOL_AND || opType == TokenType::OP_BOOL_OR) {
+        if ((opType == TokenType::OP_BOOL_AND) != jumpIfTrue) {
+            // both sides jump to the label on the same outcome (false for &&, true for ||)
+            assembleBranch(*op.left(), ir, scope, label, jumpIfTrue);
+            assembleBranch(*op.right(), ir, scope, label, jumpIfTrue);
+        } else {
+            // the left side decides the result on its own if it's false (&&) or true (||)
+            const std::string skipLabel = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
+            assembleBranch(*op.left(), ir, scope, skipLabel, !jumpIfTrue);
+            assembleBranch(*op.right(), ir, scope, label, jumpIfTrue);
+            ir.label(skipLabel);
+        }
+        return;
+    }
+
+    // comparisons, move both arguments into AX & BX
+    std::vector<Type> resultTypes;
+    std::vector<bool> isRegOperand;
+    assembleOperands(op, ir, scope, true, resultTypes, isRegOperand);
+
+    const size_t dominantSize = getDominantType(resultTypes[0], resultTypes[1]).getSizeBytes(SIZE_ARR_AS_PTR);
+    if (dominantSize < 1 || dominantSize > 2) throw TSyntaxException(condNode.err);
+    loadBinaryOperands(op, ir, scope, resultTypes, isRegOperand);
+
+    const bool isUnsigned = resultTypes[0].isUnsigned() || resultTypes[1].isUnsigned();
+
+    ir.emit(IROpcode::CMP, irReg('A', dominantSize), irReg('B', dominantSize));
+    ir.emit(getCompareJump(opType, isUnsigned, jumpIfTrue), irLabel(label));
+}
+
 // implicitly converts a value pushed to the top of the stack to the given type
-void implicitCast(std::ofstream& outHandle, Type resultType, Type desiredType, Scope& scope, const ErrInfo err) {
+void implicitCast(IRBuilder& ir, Type resultType, Type desiredType, Scope& scope, const ErrInfo err) {
     if (resultType.isVoidNonPtr() && !desiredType.isVoidNonPtr()) throw TIllegalVoidUseException(err);
 
     // most importantly, if the two types are equal just return
@@ -1216,7 +1697,7 @@ void implicitCast(std::ofstream& outHandle, Type resultType, Type desiredType, S
     if (desiredType.isVoidNonPtr()) {
         size_t resultSize = resultType.getSizeBytes();
         if (resultSize > 0) {
-            OUT << "sub SP, " << resultSize << '\n';
+            ir.emit(IROpcode::SUB, irReg("SP"), irImm(resultSize));
             scope.pop(resultSize);
         }
         return;
@@ -1266,57 +1747,58 @@ void implicitCast(std::ofstream& outHandle, Type resultType, Type desiredType, S
 
             if (primB == TokenType::TYPE_BOOL) {
                 // if casting to a bool, enforce 1 or 0
-                const std::string regA = startSize == 2 ? "AX" : "AL";
-                OUT << (startSize == 2 ? "popw AX" : "pop AL") << '\n';
+                const IROperand regA = irReg('A', startSize);
+                popValue(ir, scope, regA, startSize);
 
                 // buffer value
-                OUT << "buf " << regA << '\n';
+                ir.emit(IROpcode::BUF, regA);
 
                 // if non-zero, set to 1
                 const std::string mergeLabel = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                OUT << "jz " << mergeLabel << '\n';
-                OUT << (startSize == 2 ? "movw AX" : "mov AL") << ", 1\n";
-                OUT << mergeLabel << ":\n";
-                OUT << (startSize == 2 ? "pushw AX" : "push AL") << '\n';
+                ir.emit(IROpcode::JZ, irLabel(mergeLabel));
+                ir.emit(getMoveOp(startSize), regA, irImm(1));
+                ir.label(mergeLabel);
+                ir.emit(getPushOp(startSize), regA);
+                scope.addPlaceholder(startSize);
             }
 
             // preserve sign bit in AL
             if (!resultType.isUnsigned()) {
-                OUT << "mov AL, [SP-1]\n";
-                OUT << "and AL, 0x80\n"; // get sign bit
+                ir.emit(IROpcode::MOV, irReg("AL"), irStack(1));
+                ir.emit(IROpcode::AND, irReg("AL"), irImm(0x80)); // get sign bit
             }
 
             if (startSize < endSize) { // pad bytes
                 // if signed and negative, push 0xFFFFs, otherwise push 0s
-                OUT << "movw CX, 0\n";
+                ir.emit(IROpcode::MOVW, irReg("CX"), irImm(0));
                 if (!resultType.isUnsigned()) {
                     const std::string mergeLabel = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
-                    OUT << "buf AL\n";
-                    OUT << "jz " << mergeLabel << '\n';
-                    OUT << "movw CX, 0xFFFF\n"; // set CX to 1
-                    OUT << mergeLabel << ":\n";
+                    ir.emit(IROpcode::BUF, irReg("AL"));
+                    ir.emit(IROpcode::JZ, irLabel(mergeLabel));
+                    ir.emit(IROpcode::MOVW, irReg("CX"), irImm(0xFFFF)); // set CX to 1
+                    ir.label(mergeLabel);
                 }
 
                 // add padding bytes
                 for (size_t i = startSize; i < endSize; ++i) {
                     if (i+1 < endSize) {
-                        OUT << "pushw CX\n";
+                        ir.emit(IROpcode::PUSHW, irReg("CX"));
                         ++i;
                     } else {
-                        OUT << "push CL\n";
+                        ir.emit(IROpcode::PUSH, irReg("CL"));
                     }
                 }
                 scope.addPlaceholder(endSize - startSize);
             } else if (startSize > endSize) { // pop bytes
-                OUT << "sub SP, " << (startSize - endSize) << '\n';
+                ir.emit(IROpcode::SUB, irReg("SP"), irImm(startSize - endSize));
                 scope.pop(startSize - endSize);
             }
 
             // re-add sign bit
             if (!resultType.isUnsigned()) {
-                OUT << "pop BL\n";
-                OUT << "or BL, AL\n";
-                OUT << "push BL\n";
+                ir.emit(IROpcode::POP, irReg("BL"));
+                ir.emit(IROpcode::OR, irReg("BL"), irReg("AL"));
+                ir.emit(IROpcode::PUSH, irReg("BL"));
             }
         }
 
@@ -1325,4 +1807,99 @@ void implicitCast(std::ofstream& outHandle, Type resultType, Type desiredType, S
 
     // base case, illegal cast
     throw TIllegalImplicitCastException(err);
-}
\ No newline at end of file
+}
+
+// true if the node is a leaf (literal or primitive variable) its operator can load straight into a register
+bool isRegisterOperand(ASTNode& node, Scope& scope) {
+    const ASTNodeType nodeType = node.getNodeType();
+    if (nodeType != ASTNodeType::LIT_INT && nodeType != ASTNodeType::LIT_CHAR &&
+        nodeType != ASTNodeType::LIT_BOOL && nodeType != ASTNodeType::IDENTIFIER) return false;
+
+    // anything subscripted or implicitly cast still goes through the stack
+    ASTTypedNode& typedNode = *static_cast<ASTTypedNode*>(&node);
+    if (typedNode.getNumSubscripts() > 0) return false;
+
+    // literals typed as their unsigned counterparts load the same bits
+    const Type& type = typedNode.getTypeRef();
+    switch (nodeType) {
+        case ASTNodeType::LIT_INT: return !type.isPointer() && type.getPrimType() == TokenType::TYPE_INT;
+        case ASTNodeType::LIT_CHAR: return !type.isPointer() && type.getPrimType() == TokenType::TYPE_CHAR;
+        case ASTNodeType::LIT_BOOL: return !type.isPointer() && type.getPrimType() == TokenType::TYPE_BOOL;
+        default: {
+            if (typedNode.isLValue()) return false;
+            const std::pair<IROperand, Type>* pRegisterVar = findRegisterVar(node.id);
+            if (pRegisterVar != nullptr) return pRegisterVar->second == typedNode.getType();
+            if (!scope.doesVarExist(node.id)) return false;
+
+            const Type& varType = scope.getVariable(node.id, node.err)->type;
+            const size_t typeSize = varType.getSizeBytes();
+            return !varType.isPointer() && (typeSize == 1 || typeSize == 2) && varType == typedNode.getType();
+        }
+    }
+}
+
+// true if the node is a primitive variable an assignment can store to directly (without pushing its address)
+bool isDirectStoreTarget(ASTNode& node, Scope& scope) {
+    if (node.getNodeType() != ASTNodeType::IDENTIFIER) return false;
+
+    ASTTypedNode& typedNode = *static_cast<ASTTypedNode*>(&node);
+    if (!typedNode.isLValue() || typedNode.getNumSubscripts() > 0) return false;
+    const std::pair<IROperand, Type>* pRegisterVar = findRegisterVar(node.id);
+    if (pRegisterVar != nullptr) return pRegisterVar->second == typedNode.getType();
+    if (!scope.doesVarExist(node.id)) return false;
+
+    const Type& varType = scope.getVariable(node.id, node.err)->type;
+    const size_t typeSize = varType.getSizeBytes();
+    return !varType.isPointer() && (typeSize == 1 || typeSize == 2) && varType == typedNode.getType();
+}
+
+// loads a register operand into AX or BX (by the register's letter), returning its type
+Type loadRegisterOperand(ASTNode& node, IRBuilder& ir, Scope& scope, const char reg) {
+    const IROperand reg16 = irReg(std::string(1, reg) + 'X');
+    const IROperand regL = irReg(std::string(1, reg) + 'L');
+    const IROperand regH = irReg(std::string(1, reg) + 'H');
+
+    switch (node.getNodeType()) {
+        case ASTNodeType::LIT_INT: {
+            ir.emit(IROpcode::MOVW, reg16, irImm(static_cast<ASTIntLiteral*>(&node)->val & 0xFFFF));
+            return Type(TokenType::TYPE_INT);
+        }
+        case ASTNodeType::LIT_CHAR: {
+            ir.emit(IROpcode::MOVW, reg16, irImm(static_cast<ASTCharLiteral*>(&node)->val & 0xFF));
+            return Type(TokenType::TYPE_CHAR);
+        }
+        case ASTNodeType::LIT_BOOL: {
+            ir.emit(IROpcode::MOVW, reg16, irImm(static_cast<ASTBoolLiteral*>(&node)->val & 0xFF));
+            return Type(TokenType::TYPE_BOOL);
+        }
+        case ASTNodeType::IDENTIFIER: {
+            // read the variable from its register, or in place (lowest byte first)
+            const std::pair<IROperand, Type>* pRegisterVar = findRegisterVar(node.id);
+            if (pRegisterVar != nullptr) {
+                ir.emit(IROpcode::MOVW, reg16, pRegisterVar->first);
+                return pRegisterVar->second;
+            }
+
+            const size_t stackOffset = scope.getOffset(node.id, node.err);
+            const Type varType = scope.getVariable(node.id, node.err)->type;
+
+            ir.emit(IROpcode::MOV, regL, irStack(stackOffset));
+            if (varType.getSizeBytes() == 2)
+                ir.emit(IROpcode::MOV, regH, irStack(stackOffset-1));
+            else
+                ir.emit(IROpcode::XOR, regH, regH);
+            return varType;
+        }
+        default: throw TDevException("Invalid register operand in loadRegisterOperand!");
+    }
+}
+
+// if the node is a literal register operand, writes the value it's loaded into a register as and returns true
+bool getRegisterLiteral(ASTNode& node, unsigned int& value) {
+    switch (node.getNodeType()) {
+        case ASTNodeType::LIT_INT: value = static_cast<ASTIntLiteral*>(&node)->val & 0xFFFF; return true;
+        case ASTNodeType::LIT_CHAR: value = static_cast<ASTCharLiteral*>(&node)->val & 0xFF; return true;
+        case ASTNodeType::LIT_BOOL: value = static_cast<ASTBoolLiteral*>(&node)->val & 0xFF; return true;
+        default: return false;
+    }
+}
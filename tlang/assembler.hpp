@@ -2,8 +2,9 @@
 #define __ASSEMBLER_HPP
 
 #include <fstream>
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "util/scope.hpp"
@@ -11,34 +12,40 @@
 #include "util/t_exception.hpp"
 #include "ast/ast.hpp"
 #include "ast/ast_nodes.hpp"
-
-// shorthand used throughout assembler to write with an indent
-#define OUT outHandle << TAB
-
-// shorthand used by most binary expressions in assembleExpression
-#define OUT_BIN_OP_1A(inst) OUT << #inst << ' ' << regA << '\n'
-#define OUT_BIN_OP_1B(inst) OUT << #inst << ' ' << regB << '\n'
-#define OUT_BIN_OP_2(inst) OUT << #inst << ' ' << regA << ", " << regB << '\n'
-
-// shorthand used in all boolean returns for assembleExpression
-#define BIN_OP_RECORD_BOOL OUT << "push AL\n"; scope.addPlaceholder(); resultType = Type(TokenType::TYPE_BOOL)
+#include "ir/builder.hpp"
 
 class AssembledFunc {
     public:
-        AssembledFunc(const std::string& funcName, const ASTFunction& func);
+        AssembledFunc(const std::string& funcName, ASTFunction& func);
+        AssembledFunc(const AssembledFunc& func, const std::string& endLabel); // an inlined copy with its own end label (& all its params in the frame)
 
         const std::string& getName() const { return funcName; };
         const std::string& getStartLabel() const { return startLabel; };
         const std::string& getEndLabel() const { return endLabel; };
         const Type& getReturnType() const { return returnType; };
         const std::vector<Type>& getParamTypes() const { return paramTypes; };
+
+        ASTFunction& getFuncNode() const { return *pFuncNode; };
+        bool isInlinable() const { return _isInlinable; };
+        bool isFastcall() const { return _isFastcall; };
+        bool isAddressTaken(symbol_t name) const { return addressTakenVars.count(name) > 0; };
+        bool hasAddressTakenVars() const { return addressTakenVars.size() > 0; };
+        size_t getNumRegisterParams() const { return numRegisterParams; };
+        const std::string& getParamRegister(size_t i) const { return paramRegisters[i]; };
+        size_t getFrameParamSize() const;
     private:
         std::string funcName, startLabel, endLabel;
         Type returnType;
         std::vector<Type> paramTypes;
+        ASTFunction* pFuncNode;
+        bool _isInlinable;
+        bool _isFastcall; // returns in AX/AL instead of through return bytes the caller reserves below the args
+        std::unordered_set<symbol_t> addressTakenVars; // variables that may be referenced through a pointer (their slots can't be reused)
+        size_t numRegisterParams; // the last params, which are passed in CX & DX instead of pushed (fastcall only)
+        std::vector<std::string> paramRegisters; // the register each param is kept in instead of the frame, or empty if it isn't
 };
 
-typedef std::multimap<std::string, AssembledFunc> label_map_t;
+typedef std::unordered_map<symbol_t, std::vector<AssembledFunc>> label_map_t; // overloads in the order they're assembled
 
 // data element class for elements in the .data section
 class DataElem {
@@ -50,19 +57,56 @@ class DataElem {
 };
 
 // generate TPU assembly code from the AST
-void generateAssembly(AST&, std::ofstream&);
+void generateAssembly(AST&, std::ostream&);
+
+// writes the IR pass counters
+void printPassStats(std::ostream&);
 
 // for assembling functions
-void assembleFunction(ASTFunction&, std::ofstream&);
+void assembleFunction(ASTFunction&, std::ostream&);
 
 // for assembling body content that may or may not have its own scope
 // returns true if the current body has returned (really only matters in function scopes)
-bool assembleBody(ASTNode*, std::ofstream&, Scope&, const AssembledFunc&, const bool=false);
+bool assembleBody(ASTNode*, IRBuilder&, Scope&, const AssembledFunc&, const bool=false);
+
+// compiles `return f(...);` as a jump to f that reuses the current frame, returns false if the call isn't eligible
+bool assembleTailCall(ASTReturn&, IRBuilder&, Scope&, const AssembledFunc&);
+
+// finds the overload of a called function whose parameters match the call's arguments, preferring an exact match (throws if none does)
+AssembledFunc* findFunction(ASTFunctionCall&);
+
+// substitutes a function's body at a call site, where its return bytes & args are already on the stack
+void assembleInlineCall(const AssembledFunc&, IRBuilder&);
 
 // assembles an expression, returning the type of the value pushed to the stack
-Type assembleExpression(ASTNode&, std::ofstream&, Scope&);
+Type assembleExpression(ASTNode&, IRBuilder&, Scope&);
+
+// pushes a call's args, converting each to the size of its parameter (arrays are passed as pointers),
+// then moves the callee's register params off the top of the stack into CX & DX unless it's being inlined
+void assembleArguments(ASTFunctionCall&, const AssembledFunc&, IRBuilder&, Scope&, std::vector<Type>&, const bool);
+
+// assembles an operator's operands bottom-up, leaving register operands to be loaded by the operator itself
+void assembleOperands(ASTNode&, IRBuilder&, Scope&, const bool, std::vector<Type>&, std::vector<bool>&);
+
+// moves a binary operator's assembled operands into AX/AL & BX/BL (popping them in reverse, higher first)
+void loadBinaryOperands(ASTOperator&, IRBuilder&, Scope&, const std::vector<Type>&, const std::vector<bool>&);
+
+// assembles a condition as control flow, jumping to the label if it's true (or false) and falling through otherwise
+void assembleBranch(ASTNode&, IRBuilder&, Scope&, const std::string&, const bool);
 
 // implicitly converts a value pushed to the top of the stack to the given type
-void implicitCast(std::ofstream&, Type, Type, Scope&, const ErrInfo);
+void implicitCast(IRBuilder&, Type, Type, Scope&, const ErrInfo);
+
+// true if the node is a leaf (literal or primitive variable) its operator can load straight into a register
+bool isRegisterOperand(ASTNode&, Scope&);
+
+// true if the node is a primitive variable an assignment can store to directly (without pushing its address)
+bool isDirectStoreTarget(ASTNode&, Scope&);
+
+// loads a register operand into AX or BX (by the register's letter), returning its type
+Type loadRegisterOperand(ASTNode&, IRBuilder&, Scope&, const char);
+
+// if the node is a literal register operand, writes the value it's loaded into a register as and returns true
+bool getRegisterLiteral(ASTNode&, unsigned int&);
 
 #endif
\ No newline at end of file
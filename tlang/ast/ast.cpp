@@ -1,5 +1,13 @@
 #include "ast.hpp"
 
+// destroys every node, then frees the arena they were all allocated from in one go
+AST::~AST() {
+    for (ASTNode* pNode : children)
+        delete pNode;
+
+    getASTArena().release();
+}
+
 void AST::removeByAddress(void* addr) {
     for (size_t i = 0; i < children.size(); ++i) {
         if (children[i] == addr) {
@@ -15,15 +15,15 @@
 
 class AST {
     public:
-        ~AST() { for (ASTNode* pNode : children) delete pNode; }
+        ~AST();
 
         void push(ASTNode* pNode) { children.push_back(pNode); }
-        std::vector<ASTNode*>& getChildren() { return children; }
+        ast_vector_t<ASTNode*>& getChildren() { return children; }
         size_t size() const { return children.size(); }
         
         void removeByAddress(void*);
     private:
-        std::vector<ASTNode*> children;
+        ast_vector_t<ASTNode*> children;
 };
 
 #endif
\ No newline at end of file
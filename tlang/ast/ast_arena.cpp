@@ -0,0 +1,39 @@
+#include <new>
+
+#include "ast_arena.hpp"
+
+void* ASTArena::allocate(size_t size) {
+    // keep every allocation aligned for any type
+    constexpr size_t align = alignof(std::max_align_t);
+    size = (size + align - 1) & ~(align - 1);
+
+    // oversized allocations get a block of their own (placed before the current one to keep filling it)
+    if (size > AST_ARENA_CHUNK_SIZE) {
+        char* pBlock = static_cast<char*>(::operator new(size));
+        blocks.insert(blocks.end() - (blocks.size() > 0 ? 1 : 0), pBlock);
+        return pBlock;
+    }
+
+    // start a new block once the current one is full
+    if (blockUsed + size > AST_ARENA_CHUNK_SIZE) {
+        blocks.push_back(static_cast<char*>(::operator new(AST_ARENA_CHUNK_SIZE)));
+        blockUsed = 0;
+    }
+
+    void* pMem = blocks.back() + blockUsed;
+    blockUsed += size;
+    return pMem;
+}
+
+void ASTArena::release() {
+    for (char* pBlock : blocks)
+        ::operator delete(pBlock);
+
+    blocks.clear();
+    blockUsed = AST_ARENA_CHUNK_SIZE;
+}
+
+ASTArena& getASTArena() {
+    static ASTArena arena;
+    return arena;
+}
@@ -0,0 +1,43 @@
+#ifndef __AST_ARENA_HPP
+#define __AST_ARENA_HPP
+
+#include <cstddef>
+#include <vector>
+
+#define AST_ARENA_CHUNK_SIZE (64 * 1024) // bytes per block nodes are carved out of
+
+// bump allocator for AST nodes & their child arrays, which are only ever freed all at once with the AST
+class ASTArena {
+    public:
+        ~ASTArena() { release(); }
+
+        void* allocate(size_t);
+        void release(); // frees every block (anything still allocated from the arena is left dangling)
+    private:
+        std::vector<char*> blocks;
+        size_t blockUsed = AST_ARENA_CHUNK_SIZE; // bytes used in the last block
+};
+
+// the arena for the AST being compiled
+ASTArena& getASTArena();
+
+// STL allocator drawing from the AST arena (deallocation is a no-op until the arena is released)
+template <typename T>
+class ASTArenaAllocator {
+    public:
+        typedef T value_type;
+
+        ASTArenaAllocator() = default;
+        template <typename U> ASTArenaAllocator(const ASTArenaAllocator<U>&) {};
+
+        T* allocate(size_t n) { return static_cast<T*>(getASTArena().allocate(n * sizeof(T))); };
+        void deallocate(T*, size_t) {};
+
+        template <typename U> bool operator==(const ASTArenaAllocator<U>&) const { return true; };
+        template <typename U> bool operator!=(const ASTArenaAllocator<U>&) const { return false; };
+};
+
+template <typename T>
+using ast_vector_t = std::vector<T, ASTArenaAllocator<T>>;
+
+#endif
@@ -215,14 +215,16 @@ void ASTTypedNode::inferChildTypes(scope_stack_t& scopeStack) {
         if (pNode->getNodeType() == ASTNodeType::EXPR) {
             this->removeChild(i);
 
+            // splice the wrapped children in where the wrapper was, so operands keep their order
+            size_t numUnwrapped = 0;
             while (pNode->size() > 0) {
-                this->push( pNode->at(0) );
+                this->insert( pNode->at(0), i + numUnwrapped++ );
                 pNode->removeChild(0);
             }
 
             // copy subscripts to last child
             ASTTypedNode* pTypedNode = static_cast<ASTTypedNode*>(pNode);
-            ASTTypedNode* pLastChild = static_cast<ASTTypedNode*>(this->lastChild());
+            ASTTypedNode* pLastChild = static_cast<ASTTypedNode*>(this->at(i + numUnwrapped - 1));
             while (pTypedNode->getNumSubscripts() > 0) {
                 pLastChild->addSubscript( pTypedNode->subscripts[0] );
                 pTypedNode->subscripts.erase(pTypedNode->subscripts.begin()+0);
@@ -545,7 +547,7 @@ void ASTFunctionCall::inferType(scope_stack_t& scopeStack) {
         paramTypes.push_back(static_cast<ASTTypedNode*>(pChild)->getTypeRef());
 
     int status;
-    ParserFunction* pParserFunc = lookupParserFunction(scopeStack, this->raw, this->err, paramTypes, status);
+    ParserFunction* pParserFunc = lookupParserFunction(scopeStack, this->id, this->err, paramTypes, status);
 
     // if this is a partial match, update own types
     if (status == TYPE_PARAM_IMPLICIT_MATCH) {
@@ -609,7 +611,7 @@ void ASMProtectedInstruction::inferType(scope_stack_t& scopeStack) {
 
 void ASTIdentifier::inferType(scope_stack_t& scopeStack) {
     // lookup the variable from the scope
-    Type type = lookupParserVariable(scopeStack, this->raw, this->err)->type;
+    Type type = lookupParserVariable(scopeStack, this->id, this->err)->type;
 
     // infer subscripts
     size_t numSubscripts = this->subscripts.size();
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 
+#include "ast_arena.hpp"
 #include "../util/token.hpp"
 #include "../util/scope_stack.hpp"
 
@@ -29,8 +30,13 @@ enum class ASTUnaryType {
 // base class for all AST node types
 class ASTNode {
     public:
-        ASTNode(const Token& token) : err(token.err), raw(token.raw) {};
+        ASTNode(const Token& token) : err(token.err), id(token.id), raw(token.raw) {};
         virtual ~ASTNode();
+
+        // nodes live in the AST arena, so deleting one only runs its destructor (the memory is freed with the AST)
+        static void* operator new(size_t size) { return getASTArena().allocate(size); };
+        static void operator delete(void*) {};
+
         void push(ASTNode* pNode) { children.push_back(pNode); };
         ASTNode* removeChild(size_t i);
         void removeByAddress(void* addr);
@@ -45,10 +51,11 @@ class ASTNode {
 
         // for error reporting
         ErrInfo err;
-        const std::string raw;
+        symbol_t id; // the interned text of the token
+        const std::string& raw;
         bool isAssembled = false;
     protected:
-        std::vector<ASTNode*> children;
+        ast_vector_t<ASTNode*> children;
 };
 
 class ASTReturn : public ASTNode {
@@ -132,10 +139,10 @@ class ASTTypedNode : public ASTNode {
 
         // subscripts for array accessing
         void addSubscript(ASTArraySubscript* pSub) { this->subscripts.push_back(pSub); };
-        const std::vector<ASTArraySubscript*>& getSubscripts() { return subscripts; };
+        const ast_vector_t<ASTArraySubscript*>& getSubscripts() { return subscripts; };
         size_t getNumSubscripts() const { return subscripts.size(); };
     protected:
-        std::vector<ASTArraySubscript*> subscripts;
+        ast_vector_t<ASTArraySubscript*> subscripts;
     private:
         Type type;
         bool _isLValue = false;
@@ -205,8 +212,9 @@ class ASTArraySubscript : public ASTTypedNode {
 
 class ASTFuncParam {
     public:
-        ASTFuncParam(const std::string& name, Type type) : name(name), type(type) {};
-        std::string name;
+        ASTFuncParam(const Token& token, Type type) : id(token.id), name(token.raw), type(type) {};
+        symbol_t id; // the interned name
+        const std::string& name;
         Type type;
 };
 
@@ -226,9 +234,13 @@ class ASTFunction : public ASTNode {
         void loadParamTypes(std::vector<Type>&) const;
 
         bool isMainFunction() const;
+
+        void setIsInline(bool i) { _isInline = i; };
+        bool isInline() const { return _isInline; };
     private:
         std::string name; // name of function
         Type type; // return type
+        bool _isInline = false; // forces call sites to substitute the body
         std::vector<ASTFuncParam*> params; // parameters {name, type}
 };
 
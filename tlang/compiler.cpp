@@ -1,6 +1,7 @@
 #include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <stack>
 #include <vector>
 
@@ -8,9 +9,11 @@
 #include "preprocessor.hpp"
 #include "lexer.hpp"
 #include "parser/parser.hpp"
+#include "strength_reduction.hpp"
 #include "util/config.hpp"
 #include "util/t_exception.hpp"
 #include "util/toolbox.hpp"
+#include "../postprocessor/postprocessor.hpp"
 
 /**
  * Compiles .t files to .tpu assembly files.
@@ -41,7 +44,14 @@ int main(int argc, char* argv[]) {
     // extract any extra arguments
     bool forceOverwrite = false;
     bool skipPostprocessor = false;
+    std::string timingPath;
     DELETE_UNUSED_VARIABLES = DELETE_UNUSED_FUNCTIONS = true;
+    RUN_IR_PASSES = true;
+    PRINT_PASS_STATS = false;
+    INLINE_FUNCTIONS = true;
+    USE_FASTCALL = true;
+    TAIL_CALLS = true;
+    ALLOCATE_REGISTERS = true;
 
     for (int i = 2; i < argc; ++i) {
         std::string arg( argv[i] );
@@ -51,11 +61,40 @@ int main(int argc, char* argv[]) {
             skipPostprocessor = true;
         } else if (arg == "-keep-unused") {
             DELETE_UNUSED_VARIABLES = DELETE_UNUSED_FUNCTIONS = false;
+        } else if (arg == "-skip-passes") {
+            RUN_IR_PASSES = false;
+        } else if (arg == "-pass-stats") {
+            PRINT_PASS_STATS = true;
+        } else if (arg == "-no-inline") {
+            INLINE_FUNCTIONS = false;
+        } else if (arg == "-no-fastcall") {
+            USE_FASTCALL = false;
+        } else if (arg == "-no-tail-calls") {
+            TAIL_CALLS = false;
+        } else if (arg == "-no-regalloc") {
+            ALLOCATE_REGISTERS = false;
+        } else if (arg == "-timing") {
+            if (i+1 == argc) {
+                std::cerr << "Error: Invalid usage, profile file must be specified after \"-timing\" flag.\n";
+                exit(1);
+            }
+            timingPath = std::string(argv[++i]);
         } else {
             std::cout << "Warning: Skipping invalid argument: " << arg << '\n';
         }
     }
 
+    // load the instruction timings used to pick cheaper instruction sequences
+    if (timingPath.size() > 0) {
+        try {
+            loadCycleProfile(timingPath);
+        } catch (std::invalid_argument& e) {
+            std::cerr << e.what() << std::endl;
+            inHandle.close();
+            exit(1);
+        }
+    }
+
     // verify output file doesn't exist
     if (doesFileExist(outPath)) {
         if (forceOverwrite) { // remove by force
@@ -86,37 +125,37 @@ int main(int argc, char* argv[]) {
 
         // 1. tokenize file
         std::vector<Token> tokens;
-        tokenize(inHandle, tokens, cwdStack, inPathAbs.filename().string());
         inHandle.close();
+        if (!tokenize(inPathAbs, tokens, cwdStack, inPathAbs.filename().string())) {
+            std::cerr << "Failed to read input file: " << inPath << std::endl;
+            outHandle.close();
+            std::filesystem::remove(outPath);
+            exit(1);
+        }
 
         // 2. parse to AST & syntax checking (semantic analysis)
         pAST = parseToAST(tokens);
 
         // 3. translate AST to TPU assembly code
-        generateAssembly(*pAST, outHandle);
+        std::stringstream asmBuffer;
+        generateAssembly(*pAST, asmBuffer);
+        if (PRINT_PASS_STATS) printPassStats(std::cout);
 
-        // close files and free AST
-        outHandle.close();
+        // free AST
         delete pAST;
+        pAST = nullptr;
 
         // 4. run through post processor (optional) to reduce redundant expressions more easily than in the assembler
         if (!skipPostprocessor) {
-            // grab CWD to find postproc symlink
-            const std::string postprocPath = (std::filesystem::canonical("/proc/self/exe").parent_path() / "postproc").string();
-
-            const std::string tempPath = outPath + "_tmp";
-            const std::string cmd( '"' + postprocPath + "\" " + outPath + " -o " + tempPath );
-            std::system(cmd.c_str());
-
-            // remove original tpu file and replace with tmp file
-            if (!std::filesystem::exists(tempPath)) {
-                std::cerr << "Failed to invoke post processor.\n";
-                std::filesystem::remove(outPath); // remove regardless
-            } else {
-                std::filesystem::remove(outPath); // remove old
-                std::filesystem::rename(tempPath, outPath); // rename buffer to outPath
-            }
+            std::vector<std::string> asmLines;
+            splitLines(asmBuffer.str(), asmLines);
+            std::vector<post_rule_stats_t> postStats;
+            const bool isFixpoint = postprocess(asmLines, outHandle, post_process_opts(), &postStats);
+            if (PRINT_PASS_STATS) printPostprocessStats(postStats, isFixpoint, std::cout);
+        } else {
+            outHandle << asmBuffer.rdbuf();
         }
+        outHandle.close();
     } catch (TException& e) {
         std::cerr << e.toString() << '\n';
 
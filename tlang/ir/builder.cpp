@@ -0,0 +1,34 @@
+#include <sstream>
+
+#include "builder.hpp"
+
+void IRBuilder::emit(const IRInst& inst) {
+    if (func.blocks.size() == 0 || isBlockEnded) func.blocks.push_back(IRBlock());
+    func.blocks.back().insts.push_back(inst);
+    isBlockEnded = inst.isJump() || inst.isTerminator();
+}
+
+// starts a new block with the label
+void IRBuilder::label(const std::string& name) {
+    func.blocks.push_back(IRBlock(name));
+    isBlockEnded = false;
+}
+
+// appends a sequence of blocks, continuing the current block with the first one if it's unlabeled
+void IRBuilder::emitBlocks(const std::vector<IRBlock>& blocks) {
+    for (const IRBlock& block : blocks) {
+        if (block.label.size() > 0) label(block.label);
+        for (const IRInst& inst : block.insts) emit(inst);
+    }
+}
+
+// appends raw TPU assembly (ex. inline asm), one instruction or label per line
+void IRBuilder::emitAssembly(const std::string& raw) {
+    std::stringstream lines(raw);
+    std::string line, labelName;
+    IRInst inst;
+    while (std::getline(lines, line)) {
+        if (parseIRInst(line, inst, labelName)) emit(inst);
+        else if (labelName.size() > 0) label(labelName);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef __IR_BUILDER_HPP
+#define __IR_BUILDER_HPP
+
+#include <string>
+#include <vector>
+
+#include "ir.hpp"
+
+/**
+ * Appends instructions to a function as the assembler walks the AST. Labels start a new block, and jumps,
+ * returns & halts end the current one (whatever follows them starts an unlabeled block).
+ */
+class IRBuilder {
+    public:
+        IRBuilder(IRFunction& func) : func(func) {};
+
+        void emit(const IRInst&);
+        void emit(IROpcode op, const IROperand& a=IROperand(), const IROperand& b=IROperand(), bool isSigned=false) {
+            emit(IRInst(op, a, b, isSigned));
+        };
+
+        // starts a new block with the label
+        void label(const std::string&);
+
+        // appends a sequence of blocks, continuing the current block with the first one if it's unlabeled
+        void emitBlocks(const std::vector<IRBlock>&);
+
+        // appends raw TPU assembly (ex. inline asm), one instruction or label per line
+        void emitAssembly(const std::string&);
+
+        // returns a new virtual register of the given width in bits
+        IROperand makeVReg(u8 width) { return IROperand::makeVReg(func.numVRegs++, width); };
+    private:
+        IRFunction& func;
+        bool isBlockEnded = false; // the last instruction ended the current block
+};
+
+#endif
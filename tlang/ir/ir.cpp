@@ -0,0 +1,461 @@
+#include <stdexcept>
+
+#include "ir.hpp"
+
+/****************************************************/
+/*                     operands                     */
+/****************************************************/
+
+// returns the width of a register in bits, or 0 if this isn't a register
+static u8 getRegisterWidth(const std::string& name) {
+    if (name == "AX" || name == "BX" || name == "CX" || name == "DX" || name == "SP" || name == "BP" ||
+        name == "SI" || name == "DI" || name == "IP" || name == "CP" || name == "ES" || name == "FLAGS") return 16;
+    if (name == "AL" || name == "AH" || name == "BL" || name == "BH" ||
+        name == "CL" || name == "CH" || name == "DL" || name == "DH") return 8;
+    return 0;
+}
+
+// parses a numeric literal (decimal, 0x, 0b, 0d or a character), returns false if not a number
+static bool parseNumber(const std::string& str, int& value) {
+    if (str.size() == 0) return false;
+
+    // characters (escapes follow the emulator's asm loader, not the T lexer)
+    if (str[0] == '\'') {
+        if (str.size() == 3 && str[2] == '\'') {
+            value = (u8)str[1];
+            return true;
+        } else if (str.size() == 4 && str[1] == '\\' && str[3] == '\'') {
+            switch (str[2]) {
+                case 'a': value = '\a'; break;
+                case 'b': value = '\b'; break;
+                case 't': value = '\t'; break;
+                case 'n': value = '\n'; break;
+                case 'v': value = '\v'; break;
+                case 'f': value = '\f'; break;
+                case 'r': value = '\r'; break;
+                case 'e': value = 0x1B; break;
+                default: value = (u8)str[2]; break;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // determine base
+    int base = 10;
+    size_t start = str[0] == '-' ? 1 : 0;
+    if (str.size() > start+2 && str[start] == '0' && (str[start+1] == 'x' || str[start+1] == 'b' || str[start+1] == 'd')) {
+        base = str[start+1] == 'x' ? 16 : str[start+1] == 'b' ? 2 : 10;
+        start += 2;
+    }
+
+    try {
+        size_t end;
+        const long num = std::stol(str.substr(start), &end, base);
+        if (end != str.size() - start) return false;
+        value = str[0] == '-' ? -num : num;
+        return true;
+    } catch (std::logic_error&) {
+        return false;
+    }
+}
+
+IROperand IROperand::makeReg(const std::string& reg) {
+    IROperand operand;
+    operand.type = IROperandType::REG;
+    operand.name = reg;
+    operand.width = getRegisterWidth(reg);
+    return operand;
+}
+
+IROperand IROperand::makeVReg(int id, u8 width) {
+    IROperand operand;
+    operand.type = IROperandType::VREG;
+    operand.value = id;
+    operand.width = width;
+    return operand;
+}
+
+IROperand IROperand::makeImm(int value) {
+    IROperand operand;
+    operand.type = IROperandType::IMM;
+    operand.value = value;
+    return operand;
+}
+
+IROperand IROperand::makeOffset(const std::string& reg, int offset) {
+    IROperand operand;
+    operand.type = IROperandType::OFFSET;
+    operand.name = reg;
+    operand.value = offset;
+    return operand;
+}
+
+IROperand IROperand::makeLabel(const std::string& label) {
+    IROperand operand;
+    operand.type = IROperandType::LABEL;
+    operand.name = label;
+    return operand;
+}
+
+bool IROperand::operator==(const IROperand& o) const {
+    if (type == IROperandType::IMM) return o.type == IROperandType::IMM && value == o.value;
+    return type == o.type && name == o.name && value == o.value;
+}
+
+std::string IROperand::toString() const {
+    switch (type) {
+        case IROperandType::REG: case IROperandType::LABEL: return name;
+        case IROperandType::VREG: return "%v" + std::to_string(value);
+        case IROperandType::IMM: return name.size() > 0 ? name : std::to_string(value);
+        case IROperandType::ADDR: return '@' + std::to_string(value);
+        case IROperandType::OFFSET: return '[' + name + (value < 0 ? '-' : '+') + std::to_string(value < 0 ? -value : value) + ']';
+        default: return "";
+    }
+}
+
+// parses a single operand, returns false if it's malformed
+static bool parseOperand(std::string str, IROperand& operand) {
+    trimString(str);
+    if (str.size() == 0) return false;
+
+    // [reg+offset] or [reg-offset]
+    if (str[0] == '[') {
+        if (str.size() < 6 || str.back() != ']') return false;
+        const size_t signIndex = str.find_first_of("+-");
+        if (signIndex == std::string::npos) return false;
+
+        int offset;
+        if (!parseNumber(str.substr(signIndex+1, str.size() - signIndex - 2), offset)) return false;
+        operand = IROperand::makeOffset(str.substr(1, signIndex-1), str[signIndex] == '-' ? -offset : offset);
+        return getRegisterWidth(operand.name) == 16;
+    }
+
+    // @addr
+    if (str[0] == '@') {
+        operand.type = IROperandType::ADDR;
+        return parseNumber(str.substr(1), operand.value);
+    }
+
+    // registers
+    if (getRegisterWidth(str) > 0) {
+        operand = IROperand::makeReg(str);
+        return true;
+    }
+
+    // immediates
+    int value;
+    if (parseNumber(str, value)) {
+        operand = IROperand::makeImm(value);
+        if (str[0] == '\'') operand.name = str; // keep character literals readable
+        return true;
+    }
+
+    // otherwise, treat as a label
+    operand = IROperand::makeLabel(str);
+    return true;
+}
+
+/****************************************************/
+/*                   instructions                   */
+/****************************************************/
+
+typedef struct ir_mnemonic_t {
+    const char* mnemonic;
+    IROpcode op;
+    bool isSigned;
+} ir_mnemonic_t;
+
+static const ir_mnemonic_t MNEMONICS[] = {
+    {"nop", IROpcode::NOP, false},      {"hlt", IROpcode::HLT, false},      {"syscall", IROpcode::SYSCALL, false},
+    {"call", IROpcode::CALL, false},    {"ret", IROpcode::RET, false},
+    {"jmp", IROpcode::JMP, false},      {"jz", IROpcode::JZ, false},        {"jnz", IROpcode::JNZ, false},
+    {"jc", IROpcode::JC, false},        {"jnc", IROpcode::JNC, false},
+    {"jl", IROpcode::JL, false},        {"jle", IROpcode::JLE, false},      {"jg", IROpcode::JG, false},
+    {"jge", IROpcode::JGE, false},      {"jb", IROpcode::JB, false},        {"jbe", IROpcode::JBE, false},
+    {"ja", IROpcode::JA, false},        {"jae", IROpcode::JAE, false},      {"js", IROpcode::JS, false},
+    {"jns", IROpcode::JNS, false},      {"jo", IROpcode::JO, false},        {"jno", IROpcode::JNO, false},
+    {"mov", IROpcode::MOV, false},      {"movw", IROpcode::MOVW, false},
+    {"push", IROpcode::PUSH, false},    {"pushw", IROpcode::PUSHW, false},
+    {"pop", IROpcode::POP, false},      {"popw", IROpcode::POPW, false},
+    {"add", IROpcode::ADD, false},      {"sadd", IROpcode::ADD, true},
+    {"sub", IROpcode::SUB, false},      {"ssub", IROpcode::SUB, true},
+    {"mul", IROpcode::MUL, false},      {"smul", IROpcode::MUL, true},
+    {"div", IROpcode::DIV, false},      {"sdiv", IROpcode::DIV, true},
+    {"cmp", IROpcode::CMP, false},      {"scmp", IROpcode::CMP, true},
+    {"buf", IROpcode::BUF, false},      {"and", IROpcode::AND, false},
+    {"or", IROpcode::OR, false},        {"xor", IROpcode::XOR, false},      {"not", IROpcode::NOT, false},
+    {"shl", IROpcode::SHL, false},      {"sshl", IROpcode::SHL, true},
+    {"shr", IROpcode::SHR, false},      {"sshr", IROpcode::SHR, true}
+};
+
+static const char* getMnemonic(IROpcode op, bool isSigned) {
+    for (const ir_mnemonic_t& entry : MNEMONICS)
+        if (entry.op == op && entry.isSigned == isSigned) return entry.mnemonic;
+    return "nop";
+}
+
+IRInst::IRInst(IROpcode op, const IROperand& a, const IROperand& b, bool isSigned) : op(op), isSigned(isSigned), a(a), b(b) {
+    // determine the operation width from the mnemonic or the first register operand
+    if (op == IROpcode::MOVW || op == IROpcode::PUSHW || op == IROpcode::POPW) width = 16;
+    else if (op == IROpcode::MOV || op == IROpcode::PUSH || op == IROpcode::POP) width = 8;
+    else if (a.type == IROperandType::REG || a.type == IROperandType::VREG) width = a.width;
+}
+
+std::string IRInst::toString() const {
+    if (op == IROpcode::RAW) return raw;
+
+    std::string str = getMnemonic(op, isSigned);
+    if (a.type != IROperandType::NONE) str += ' ' + a.toString();
+    if (b.type != IROperandType::NONE) str += ", " + b.toString();
+    return str;
+}
+
+// splits instruction arguments on commas (ignoring commas in character literals)
+static void splitArgs(const std::string& str, std::vector<std::string>& args) {
+    std::string buf;
+    bool inChar = false;
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (inChar && str[i] == '\\') {
+            buf += str[i++];
+        } else if (str[i] == '\'') {
+            inChar = !inChar;
+        } else if (!inChar && str[i] == ',') {
+            args.push_back(buf);
+            buf.clear();
+            continue;
+        }
+
+        if (i < str.size()) buf += str[i];
+    }
+    args.push_back(buf);
+}
+
+// parses a single line of TPU assembly into an instruction, returns false if the line is blank or a label (written to labelOut)
+bool parseIRInst(const std::string& line, IRInst& inst, std::string& labelOut) {
+    labelOut.clear();
+
+    // strip comments (outside of character literals)
+    std::string str;
+    bool inChar = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (line[i] == '\'') inChar = !inChar;
+        else if (inChar && line[i] == '\\' && i+1 < line.size()) str += line[i++];
+        else if (!inChar && line[i] == ';') break;
+        str += line[i];
+    }
+    trimString(str);
+    if (str.size() == 0) return false;
+
+    // labels
+    const size_t spaceIndex = str.find(' ');
+    if (spaceIndex == std::string::npos && str.back() == ':') {
+        labelOut = str.substr(0, str.size()-1);
+        return false;
+    }
+
+    // find the mnemonic
+    const std::string mnemonic = str.substr(0, spaceIndex);
+    const ir_mnemonic_t* pEntry = nullptr;
+    for (const ir_mnemonic_t& entry : MNEMONICS)
+        if (mnemonic == entry.mnemonic) pEntry = &entry;
+
+    // pass through anything unrecognized
+    inst = IRInst();
+    inst.op = IROpcode::RAW;
+    inst.raw = str;
+    if (pEntry == nullptr) return true;
+
+    // parse arguments
+    std::vector<std::string> args;
+    if (spaceIndex != std::string::npos) splitArgs(str.substr(spaceIndex+1), args);
+    if (args.size() > 2) return true;
+
+    IROperand a, b;
+    if (args.size() > 0 && !parseOperand(args[0], a)) return true;
+    if (args.size() > 1 && !parseOperand(args[1], b)) return true;
+
+    inst = IRInst(pEntry->op, a, b, pEntry->isSigned);
+    return true;
+}
+
+/****************************************************/
+/*                     effects                      */
+/****************************************************/
+
+const char* const BYTE_REGISTERS[8] = {"AL", "AH", "BL", "BH", "CL", "CH", "DL", "DH"};
+
+// returns the registers an operand names, or false if it isn't a register the passes keep track of
+bool getRegisterSet(const std::string& name, reg_set_t& regs) {
+    for (size_t i = 0; i < 8; ++i) {
+        if (name == BYTE_REGISTERS[i]) {
+            regs = 1 << i;
+            return true;
+        }
+    }
+
+    if (name == "AX") regs = REGS_AX;
+    else if (name == "BX") regs = REGS_BX;
+    else if (name == "CX") regs = REGS_CX;
+    else if (name == "DX") regs = REGS_DX;
+    else if (name == "BP") regs = REGS_BP;
+    else if (name == "SI") regs = REGS_SI;
+    else if (name == "DI") regs = REGS_DI;
+    else if (name == "SP") regs = REGS_SP;
+    else return false;
+    return true;
+}
+
+static void addOperandEffects(const IROperand& operand, const bool isWritten, inst_effects_t& effects) {
+    reg_set_t regs = 0;
+    switch (operand.type) {
+        case IROperandType::REG:
+            if (!getRegisterSet(operand.name, regs)) {
+                effects.isBarrier = true;
+            } else if (isWritten) {
+                effects.defs |= regs;
+                effects.clobbers |= regs;
+            } else {
+                effects.uses |= regs;
+            }
+            break;
+        case IROperandType::OFFSET:
+            if (!getRegisterSet(operand.name, regs)) effects.isBarrier = true;
+            effects.uses |= regs;
+            (isWritten ? effects.writesMemory : effects.readsMemory) = true;
+            break;
+        case IROperandType::ADDR:
+            (isWritten ? effects.writesMemory : effects.readsMemory) = true;
+            break;
+        default: break;
+    }
+}
+
+// returns what an instruction reads & writes
+inst_effects_t getEffects(const IRInst& inst) {
+    inst_effects_t effects;
+    switch (inst.op) {
+        case IROpcode::NOP: break;
+        case IROpcode::MOV: case IROpcode::MOVW:
+            addOperandEffects(inst.a, true, effects);
+            addOperandEffects(inst.b, false, effects);
+            break;
+        case IROpcode::PUSH: case IROpcode::PUSHW:
+            addOperandEffects(inst.a, false, effects);
+            effects.uses |= REGS_SP;
+            effects.defs |= REGS_SP;
+            effects.clobbers |= REGS_SP;
+            effects.writesMemory = true;
+            break;
+        case IROpcode::POP: case IROpcode::POPW:
+            addOperandEffects(inst.a, true, effects);
+            effects.uses |= REGS_SP;
+            effects.defs |= REGS_SP;
+            effects.clobbers |= REGS_SP;
+            effects.readsMemory = true;
+            break;
+        case IROpcode::ADD: case IROpcode::SUB: case IROpcode::CMP: case IROpcode::BUF:
+            addOperandEffects(inst.a, false, effects);
+            if (inst.op != IROpcode::CMP && inst.op != IROpcode::BUF) addOperandEffects(inst.a, true, effects);
+            addOperandEffects(inst.b, false, effects);
+            effects.defs |= REGS_FLAGS;
+            effects.clobbers |= REGS_FLAGS;
+            break;
+        case IROpcode::AND: case IROpcode::OR: case IROpcode::XOR: case IROpcode::NOT:
+        case IROpcode::SHL: case IROpcode::SHR:
+            // these only set some of the flags, so the others pass through
+            addOperandEffects(inst.a, false, effects);
+            addOperandEffects(inst.a, true, effects);
+            addOperandEffects(inst.b, false, effects);
+            effects.uses |= REGS_FLAGS;
+            effects.clobbers |= REGS_FLAGS;
+            break;
+        case IROpcode::MUL: case IROpcode::DIV: {
+            // 8-bit operands use AL -> AX, 16-bit ones AX -> AX & DX (immediates could be either)
+            addOperandEffects(inst.a, false, effects);
+            const u8 width = inst.a.type == IROperandType::REG ? inst.a.width : 0;
+            effects.uses |= width == 8 ? REGS_AX : REGS_AX | REGS_DX;
+            effects.defs |= (width == 16 ? REGS_AX | REGS_DX : REGS_AX) | REGS_FLAGS;
+            effects.clobbers |= REGS_FLAGS | (width == 8 ? REGS_AX : REGS_AX | REGS_DX);
+            break;
+        }
+        default: // jumps, calls, returns, syscalls, hlt & anything unparsed
+            effects.isBarrier = true;
+            break;
+    }
+
+    // anything that isn't a valid form of the instruction is left alone
+    for (const IROperand* pOperand : {&inst.a, &inst.b}) {
+        const bool isMemory = pOperand->type == IROperandType::OFFSET || pOperand->type == IROperandType::ADDR;
+        if (isMemory && inst.op != IROpcode::MOV && inst.op != IROpcode::PUSH) effects.isBarrier = true;
+        if (pOperand->type == IROperandType::REG && inst.op >= IROpcode::MOV && inst.op <= IROpcode::POPW &&
+            pOperand->width != inst.width) effects.isBarrier = true;
+    }
+    if (inst.a.type != IROperandType::REG && inst.op >= IROpcode::ADD && inst.op <= IROpcode::SHR &&
+        inst.op != IROpcode::MUL && inst.op != IROpcode::DIV) effects.isBarrier = true;
+    return effects;
+}
+
+// true if the operand is memory at an offset from the SP
+bool isStackOffset(const IROperand& operand) {
+    return operand.type == IROperandType::OFFSET && operand.name == "SP";
+}
+
+// returns the change in SP of a push, pop or add/sub with the SP, or false if the instruction uses the SP otherwise
+bool getStackDelta(const IRInst& inst, const inst_effects_t& effects, int& delta) {
+    delta = 0;
+    if (inst.op == IROpcode::PUSH || inst.op == IROpcode::PUSHW) {
+        delta = inst.op == IROpcode::PUSHW ? 2 : 1;
+        return inst.a.type != IROperandType::REG || inst.a.name != "SP";
+    } else if (inst.op == IROpcode::POP || inst.op == IROpcode::POPW) {
+        delta = inst.op == IROpcode::POPW ? -2 : -1;
+        return inst.a.type != IROperandType::REG || inst.a.name != "SP";
+    } else if ((inst.op == IROpcode::ADD || inst.op == IROpcode::SUB) && inst.a.name == "SP" && inst.a.type == IROperandType::REG) {
+        if (inst.b.type != IROperandType::IMM) return false;
+        delta = inst.op == IROpcode::ADD ? inst.b.value : -inst.b.value;
+        return true;
+    }
+
+    // SP-relative memory operands are fine, anything else reading or writing the SP isn't
+    reg_set_t regs = 0;
+    if (inst.a.type == IROperandType::REG && getRegisterSet(inst.a.name, regs) && (regs & REGS_SP)) return false;
+    if (inst.b.type == IROperandType::REG && getRegisterSet(inst.b.name, regs) && (regs & REGS_SP)) return false;
+    return !(effects.clobbers & REGS_SP);
+}
+
+/****************************************************/
+/*                    functions                     */
+/****************************************************/
+
+size_t IRFunction::size() const {
+    size_t total = 0;
+    for (const IRBlock& block : blocks)
+        total += block.insts.size();
+    return total;
+}
+
+int IRFunction::findBlock(const std::string& label) const {
+    for (size_t i = 0; i < blocks.size(); ++i)
+        if (blocks[i].label == label) return i;
+    return -1;
+}
+
+// returns the push writing a virtual register or the pop reading it back, or the instruction if it has none
+static IRInst spillVReg(const IRInst& inst) {
+    const bool isWord = inst.op == IROpcode::MOVW;
+    if (inst.a.type == IROperandType::VREG) return IRInst(isWord ? IROpcode::PUSHW : IROpcode::PUSH, inst.b);
+    if (inst.b.type == IROperandType::VREG) return IRInst(isWord ? IROpcode::POPW : IROpcode::POP, inst.a);
+    return inst;
+}
+
+// writes a function back out as TPU assembly (virtual registers are pushed & popped)
+void lowerIRFunction(const IRFunction& func, std::ostream& outHandle) {
+    for (const IRBlock& block : func.blocks) {
+        // only the function's start label is unindented
+        if (block.label.size() > 0)
+            outHandle << (block.label == func.name ? "" : TAB) << block.label << ":\n";
+
+        for (const IRInst& inst : block.insts)
+            outHandle << TAB << spillVReg(inst).toString() << '\n';
+    }
+}
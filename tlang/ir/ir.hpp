@@ -0,0 +1,147 @@
+#ifndef __IR_HPP
+#define __IR_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../../util/globals.hpp"
+
+/**
+ * TCC's mid-level IR, which sits between the assembler and the final .tpu output.
+ *
+ * Each function is split into basic blocks of typed instructions (opcode, signedness, 8/16-bit width and
+ * structured operands) so optimization passes can reason about registers, immediates and memory operands
+ * directly instead of matching assembly text. Memory is only touched through explicit operands (@addr and
+ * [reg+offset]) or the stack instructions, so loads and stores are always visible to a pass.
+ *
+ * The assembler builds this directly from the AST (see builder.hpp). Expression temporaries are virtual
+ * registers, each written once (mov v, src) and read at most once (mov dest, v) in stack order; any that are
+ * still virtual when the function is lowered live on the stack, as a push and the pop reading it back.
+ */
+
+enum class IROpcode {
+    NOP, HLT, SYSCALL, CALL, RET,
+    JMP, JZ, JNZ, JC, JNC,
+    JL, JLE, JG, JGE, JB, JBE, JA, JAE, JS, JNS, JO, JNO,
+    MOV, MOVW, PUSH, PUSHW, POP, POPW,
+    ADD, SUB, MUL, DIV, CMP, BUF,
+    AND, OR, XOR, NOT, SHL, SHR,
+    RAW // anything that couldn't be parsed (ex. unusual inline asm), passed through untouched
+};
+
+enum class IROperandType {
+    NONE,
+    REG,    // register (AX, BL, SP, ...)
+    VREG,   // virtual register (an expression temporary)
+    IMM,    // immediate value
+    ADDR,   // absolute memory address (@addr)
+    OFFSET, // memory at an offset from a pointer register ([SP-2], [BP+0])
+    LABEL   // label name (jump/call targets, data labels)
+};
+
+class IROperand {
+    public:
+        IROperand() {};
+
+        // constructors for each operand type
+        static IROperand makeReg(const std::string& reg);
+        static IROperand makeVReg(int id, u8 width);
+        static IROperand makeImm(int value);
+        static IROperand makeOffset(const std::string& reg, int offset);
+        static IROperand makeLabel(const std::string& label);
+
+        bool operator==(const IROperand&) const;
+        bool operator!=(const IROperand& o) const { return !(*this == o); };
+
+        std::string toString() const;
+
+        IROperandType type = IROperandType::NONE;
+        std::string name; // register name (REG & OFFSET), label name (LABEL) or original character literal (IMM)
+        int value = 0; // immediate (IMM), address (ADDR), offset (OFFSET) or virtual register id (VREG)
+        u8 width = 0; // register width in bits (REG & VREG only)
+};
+
+class IRInst {
+    public:
+        IRInst() {};
+        IRInst(IROpcode op, const IROperand& a=IROperand(), const IROperand& b=IROperand(), bool isSigned=false);
+
+        bool isJump() const { return op >= IROpcode::JMP && op <= IROpcode::JNO; };
+        bool isConditionalJump() const { return op > IROpcode::JMP && op <= IROpcode::JNO; };
+        bool isTerminator() const { return op == IROpcode::JMP || op == IROpcode::RET || op == IROpcode::HLT; };
+
+        std::string toString() const;
+
+        IROpcode op = IROpcode::NOP;
+        bool isSigned = false; // sadd, ssub, smul, sdiv, scmp, sshl & sshr
+        u8 width = 0; // operation width in bits (8 or 16), or 0 if it doesn't apply
+        IROperand a, b;
+        std::string raw; // original text for RAW instructions
+};
+
+class IRBlock {
+    public:
+        IRBlock() {};
+        IRBlock(const std::string& label) : label(label) {};
+
+        std::string label; // empty for blocks that are only reached by falling through
+        std::vector<IRInst> insts;
+};
+
+class IRFunction {
+    public:
+        size_t size() const; // the total number of instructions
+        int findBlock(const std::string& label) const; // returns the index of a label's block, or -1
+
+        std::string name; // the function's start label
+        std::vector<IRBlock> blocks;
+        int numVRegs = 0; // virtual registers are numbered from 0
+};
+
+// parses a single line of TPU assembly into an instruction, returns false if the line is blank or a label (written to labelOut)
+bool parseIRInst(const std::string& line, IRInst& inst, std::string& labelOut);
+
+// writes a function back out as TPU assembly (virtual registers are pushed & popped)
+void lowerIRFunction(const IRFunction&, std::ostream&);
+
+// a set of registers (and the flags), one bit per byte register & 16-bit pointer/index register
+typedef u16 reg_set_t;
+
+#define REGS_AX    0x0003
+#define REGS_BX    0x000C
+#define REGS_CX    0x0030
+#define REGS_DX    0x00C0
+#define REGS_BP    0x0100
+#define REGS_SI    0x0200
+#define REGS_DI    0x0400
+#define REGS_SP    0x0800
+#define REGS_FLAGS 0x1000
+#define REGS_ALL   0x1FFF
+
+// the byte registers in the same order as their bits
+extern const char* const BYTE_REGISTERS[8];
+
+// what an instruction reads & writes
+typedef struct inst_effects_t {
+    reg_set_t uses = 0;         // registers read, including pointer registers of memory operands
+    reg_set_t defs = 0;         // registers always overwritten
+    reg_set_t clobbers = 0;     // registers that may be changed (includes defs)
+    bool readsMemory = false;
+    bool writesMemory = false;
+    bool isBarrier = false;     // control flow or anything else the passes can't reason about
+} inst_effects_t;
+
+// returns the registers an operand names, or false if it isn't a register the passes keep track of
+bool getRegisterSet(const std::string&, reg_set_t&);
+
+// returns what an instruction reads & writes (virtual registers aren't included)
+inst_effects_t getEffects(const IRInst&);
+
+// true if the operand is memory at an offset from the SP
+bool isStackOffset(const IROperand&);
+
+// returns the change in SP of a push, pop or add/sub with the SP, or false if the instruction uses the SP otherwise
+bool getStackDelta(const IRInst&, const inst_effects_t&, int&);
+
+#endif
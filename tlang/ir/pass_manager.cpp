@@ -0,0 +1,44 @@
+#include <chrono>
+#include <iomanip>
+
+#include "pass_manager.hpp"
+
+void PassManager::addPass(const std::string& name, ir_pass_fn pass) {
+    ir_pass_entry_t entry;
+    entry.name = name;
+    entry.pass = pass;
+    passes.push_back(entry);
+}
+
+void PassManager::run(IRFunction& func) {
+    bool hasChanged = true;
+    for (size_t i = 0; i < IR_MAX_PIPELINE_ITERATIONS && hasChanged; ++i) {
+        hasChanged = false;
+        for (ir_pass_entry_t& entry : passes) {
+            const size_t startSize = func.size();
+            const auto startTime = std::chrono::steady_clock::now();
+
+            const bool didChange = entry.pass(func);
+
+            const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - startTime;
+            entry.stats.micros += elapsed.count();
+            entry.stats.runs++;
+            entry.stats.instsRemoved += (long)startSize - (long)func.size();
+            if (didChange) {
+                entry.stats.changes++;
+                hasChanged = true;
+            }
+        }
+    }
+}
+
+void PassManager::printStats(std::ostream& outHandle) const {
+    outHandle << std::left << std::setw(24) << "pass" << std::right << std::setw(8) << "runs" << std::setw(10) << "changed"
+              << std::setw(10) << "removed" << std::setw(12) << "time (us)" << '\n';
+
+    for (const ir_pass_entry_t& entry : passes) {
+        outHandle << std::left << std::setw(24) << entry.name << std::right << std::setw(8) << entry.stats.runs
+                  << std::setw(10) << entry.stats.changes << std::setw(10) << entry.stats.instsRemoved
+                  << std::setw(12) << std::fixed << std::setprecision(1) << entry.stats.micros << '\n';
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef __PASS_MANAGER_HPP
+#define __PASS_MANAGER_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ir.hpp"
+
+// an optimization pass over a single function, returns true if anything changed
+typedef bool (*ir_pass_fn)(IRFunction&);
+
+// the per-pass counters reported with -pass-stats
+typedef struct ir_pass_stats_t {
+    size_t runs = 0;        // the number of times the pass was run
+    size_t changes = 0;     // the number of runs that changed the function
+    long instsRemoved = 0;  // the net number of instructions removed
+    double micros = 0;      // total time spent in the pass
+} ir_pass_stats_t;
+
+/**
+ * Runs a pipeline of passes over each function until none of them make any further changes
+ * (or IR_MAX_PIPELINE_ITERATIONS is reached), keeping counters for each pass.
+ */
+class PassManager {
+    public:
+        void addPass(const std::string& name, ir_pass_fn pass);
+        void run(IRFunction&);
+        void printStats(std::ostream&) const;
+    private:
+        typedef struct ir_pass_entry_t {
+            std::string name;
+            ir_pass_fn pass;
+            ir_pass_stats_t stats;
+        } ir_pass_entry_t;
+
+        std::vector<ir_pass_entry_t> passes;
+};
+
+#define IR_MAX_PIPELINE_ITERATIONS 8
+
+#endif
@@ -0,0 +1,95 @@
+#include <set>
+
+#include "passes.hpp"
+
+// adds the default optimization pipeline to a pass manager
+void addDefaultPasses(PassManager& passManager) {
+    passManager.addPass("thread-jumps", threadJumps);
+    passManager.addPass("remove-fallthrough-jumps", removeFallthroughJumps);
+    passManager.addPass("remove-unreachable", removeUnreachableBlocks);
+}
+
+// true if control can fall through the end of a block into the next one
+static bool canFallThrough(const IRBlock& block) {
+    return block.insts.size() == 0 || !block.insts.back().isTerminator();
+}
+
+// removes blocks that can't be reached (not fallen into and not jumped to)
+bool removeUnreachableBlocks(IRFunction& func) {
+    // collect every label that's referenced (including by passed-through inline asm)
+    std::set<std::string> referencedLabels;
+    std::vector<const std::string*> rawInsts;
+    for (const IRBlock& block : func.blocks) {
+        for (const IRInst& inst : block.insts) {
+            if (inst.a.type == IROperandType::LABEL) referencedLabels.insert(inst.a.name);
+            if (inst.b.type == IROperandType::LABEL) referencedLabels.insert(inst.b.name);
+            if (inst.op == IROpcode::RAW) rawInsts.push_back(&inst.raw);
+        }
+    }
+
+    bool hasChanged = false;
+    for (size_t i = 1; i < func.blocks.size(); ++i) {
+        const IRBlock& block = func.blocks[i];
+        if (canFallThrough(func.blocks[i-1])) continue;
+
+        // only local jump labels are known to not be referenced from elsewhere
+        if (block.label.size() > 0) {
+            if (block.label.find(JMP_LABEL_PREFIX) != 0 || referencedLabels.count(block.label) > 0) continue;
+
+            bool isInRaw = false;
+            for (const std::string* pRaw : rawInsts)
+                isInRaw |= pRaw->find(block.label) != std::string::npos;
+            if (isInRaw) continue;
+        }
+
+        func.blocks.erase(func.blocks.begin() + i--);
+        hasChanged = true;
+    }
+    return hasChanged;
+}
+
+// retargets jumps to blocks that only jump elsewhere
+bool threadJumps(IRFunction& func) {
+    bool hasChanged = false;
+    for (IRBlock& block : func.blocks) {
+        for (IRInst& inst : block.insts) {
+            if (!inst.isJump() || inst.a.type != IROperandType::LABEL) continue;
+
+            // find the destination & check if it starts with an unconditional jump
+            const int destIndex = func.findBlock(inst.a.name);
+            if (destIndex == -1) continue;
+
+            const IRBlock& dest = func.blocks[destIndex];
+            if (dest.insts.size() == 0 || dest.insts[0].op != IROpcode::JMP) continue;
+
+            const IROperand& finalDest = dest.insts[0].a;
+            if (finalDest.type != IROperandType::LABEL || finalDest.name == inst.a.name) continue;
+
+            inst.a = finalDest;
+            hasChanged = true;
+        }
+    }
+    return hasChanged;
+}
+
+// removes jumps to the block immediately after them
+bool removeFallthroughJumps(IRFunction& func) {
+    bool hasChanged = false;
+    for (size_t i = 0; i+1 < func.blocks.size(); ++i) {
+        IRBlock& block = func.blocks[i];
+        if (block.insts.size() == 0) continue;
+
+        // find the next block with a label or instructions
+        size_t nextIndex = i+1;
+        while (nextIndex+1 < func.blocks.size() && func.blocks[nextIndex].label.size() == 0 && func.blocks[nextIndex].insts.size() == 0)
+            ++nextIndex;
+
+        // jumps don't modify flags, so conditional jumps to the next block can go as well
+        const IRInst& last = block.insts.back();
+        if (last.isJump() && last.a.type == IROperandType::LABEL && last.a.name == func.blocks[nextIndex].label) {
+            block.insts.pop_back();
+            hasChanged = true;
+        }
+    }
+    return hasChanged;
+}
@@ -0,0 +1,19 @@
+#ifndef __PASSES_HPP
+#define __PASSES_HPP
+
+#include "ir.hpp"
+#include "pass_manager.hpp"
+
+// adds the default optimization pipeline to a pass manager
+void addDefaultPasses(PassManager&);
+
+// removes blocks that can't be reached (not fallen into and not jumped to)
+bool removeUnreachableBlocks(IRFunction&);
+
+// retargets jumps to blocks that only jump elsewhere
+bool threadJumps(IRFunction&);
+
+// removes jumps to the block immediately after them
+bool removeFallthroughJumps(IRFunction&);
+
+#endif
@@ -0,0 +1,205 @@
+#include "regalloc.hpp"
+
+// the registers temporaries can be given, in the order they're tried
+static const char* const WORD_CANDIDATES[] = {"SI", "DI", "CX", "DX"};
+static const char* const BYTE_CANDIDATES[] = {"CL", "CH", "DL", "DH"};
+
+// where a virtual register is written & read back
+typedef struct vreg_range_t {
+    int block = -1;
+    size_t def = 0, use = 0;
+    size_t numDefs = 0, numUses = 0;
+    bool isSplit = false; // written & read in different blocks
+} vreg_range_t;
+
+// the registers an instruction reads & overwrites for liveness, assuming the worst of control flow leaving the function
+static void getLiveEffects(const IRFunction& func, const IRInst& inst, reg_set_t& uses, reg_set_t& defs) {
+    uses = defs = 0;
+    switch (inst.op) {
+        case IROpcode::CALL: uses = REGS_CX | REGS_DX; defs = REGS_ALL; return; // args are passed in CX & DX, nothing is kept across
+        case IROpcode::RET: uses = REGS_AX; return; // fastcall results
+        case IROpcode::HLT: return;
+        case IROpcode::SYSCALL: case IROpcode::RAW: uses = REGS_ALL; return;
+        default: break;
+    }
+
+    if (inst.isJump()) {
+        // jumps out of the function (ex. tail calls) might read anything
+        if (inst.a.type != IROperandType::LABEL || func.findBlock(inst.a.name) == -1) uses = REGS_ALL;
+        else if (inst.isConditionalJump()) uses = REGS_FLAGS;
+        return;
+    }
+
+    const inst_effects_t effects = getEffects(inst);
+    if (effects.isBarrier) {
+        uses = REGS_ALL;
+    } else {
+        uses = effects.uses;
+        defs = effects.defs;
+    }
+}
+
+// returns the registers live after the last instruction of each block
+static void findLiveOut(const IRFunction& func, std::vector<reg_set_t>& liveOut) {
+    const size_t numBlocks = func.blocks.size();
+    std::vector<reg_set_t> liveIn(numBlocks, 0);
+    liveOut.assign(numBlocks, 0);
+
+    bool hasChanged = true;
+    while (hasChanged) {
+        hasChanged = false;
+        for (size_t i = numBlocks; i-- > 0;) {
+            const IRBlock& block = func.blocks[i];
+
+            // everything a successor reads is live out of this block
+            reg_set_t live = 0;
+            const IRInst* pLast = block.insts.size() > 0 ? &block.insts.back() : nullptr;
+            if (pLast != nullptr && pLast->isJump() && pLast->a.type == IROperandType::LABEL) {
+                const int dest = func.findBlock(pLast->a.name);
+                if (dest != -1) live |= liveIn[dest];
+            }
+            if ((pLast == nullptr || !pLast->isTerminator()) && i+1 < numBlocks) live |= liveIn[i+1];
+            liveOut[i] = live;
+
+            for (size_t j = block.insts.size(); j-- > 0;) {
+                reg_set_t uses, defs;
+                getLiveEffects(func, block.insts[j], uses, defs);
+                live = (live & ~defs) | uses;
+            }
+            if (live != liveIn[i]) {
+                liveIn[i] = live;
+                hasChanged = true;
+            }
+        }
+    }
+}
+
+// checks that a slot of the given size pushed at def & popped at use can be removed, collecting the SP-relative
+// accesses in between that reach below it; returns false if something else uses the SP or touches the slot
+static bool findStackAccesses(std::vector<IRInst>& insts, const size_t def, const size_t use, const int size,
+                              std::vector<IROperand*>& belowSlot) {
+    int above = 0; // bytes pushed above the slot
+    for (size_t i = def+1; i < use; ++i) {
+        IRInst& inst = insts[i];
+        const inst_effects_t effects = getEffects(inst);
+        if (effects.isBarrier) return false;
+
+        // virtual registers still on the stack are pushed & popped
+        int delta;
+        if (inst.a.type == IROperandType::VREG) delta = inst.a.width / 8;
+        else if (inst.b.type == IROperandType::VREG) delta = -(inst.b.width / 8);
+        else if (!getStackDelta(inst, effects, delta)) return false;
+
+        for (IROperand* pOperand : {&inst.a, &inst.b}) {
+            if (!isStackOffset(*pOperand)) continue;
+
+            const int offset = pOperand->value;
+            if (offset >= -above) continue; // above the slot
+            if (offset >= -above - size) return false; // reads/writes the slot
+            belowSlot.push_back(pOperand);
+        }
+
+        above += delta;
+        if (above < 0) return false;
+    }
+    return above == 0;
+}
+
+// allocates registers to the function's virtual registers, returns the number allocated
+size_t allocateRegisters(IRFunction& func) {
+    if (func.numVRegs == 0) return 0;
+
+    // find where each virtual register is written & read
+    std::vector<vreg_range_t> ranges(func.numVRegs);
+    for (size_t i = 0; i < func.blocks.size(); ++i) {
+        const std::vector<IRInst>& insts = func.blocks[i].insts;
+        for (size_t j = 0; j < insts.size(); ++j) {
+            if (insts[j].a.type == IROperandType::VREG) {
+                vreg_range_t& range = ranges[insts[j].a.value];
+                range.block = i;
+                range.def = j;
+                ++range.numDefs;
+            }
+            if (insts[j].b.type == IROperandType::VREG) {
+                vreg_range_t& range = ranges[insts[j].b.value];
+                range.isSplit |= range.block != (int)i;
+                range.use = j;
+                ++range.numUses;
+            }
+        }
+    }
+
+    // a temporary's register is only written & read inside its block, so the liveness between blocks doesn't change
+    std::vector<reg_set_t> liveOut;
+    findLiveOut(func, liveOut);
+
+    size_t numAllocated = 0;
+    for (const vreg_range_t& range : ranges) {
+        if (range.numDefs != 1 || range.numUses != 1 || range.isSplit || range.use < range.def) continue;
+
+        std::vector<IRInst>& insts = func.blocks[range.block].insts;
+        const u8 width = insts[range.def].a.width;
+        std::vector<IROperand*> belowSlot;
+        if (!findStackAccesses(insts, range.def, range.use, width / 8, belowSlot)) continue;
+
+        // registers changed & touched at all while the slot holds the value
+        reg_set_t clobbered = 0, busy = 0;
+        for (size_t j = range.def+1; j < range.use; ++j) {
+            const inst_effects_t effects = getEffects(insts[j]);
+            clobbered |= effects.clobbers;
+            busy |= effects.uses | effects.clobbers;
+        }
+
+        IRInst& defInst = insts[range.def];
+        IRInst& useInst = insts[range.use];
+        reg_set_t sourceRegs = 0, destRegs = 0;
+        const bool isSourceReg = defInst.b.type == IROperandType::REG && getRegisterSet(defInst.b.name, sourceRegs);
+        const bool isDestReg = useInst.a.type == IROperandType::REG && getRegisterSet(useInst.a.name, destRegs);
+        bool isAllocated = true;
+        if (defInst.b.type == IROperandType::IMM || defInst.b.type == IROperandType::LABEL ||
+            (isSourceReg && !(clobbered & sourceRegs))) {
+            // the source is still intact when it's read, so move it straight there
+            useInst.b = defInst.b;
+            defInst = IRInst();
+        } else if (isDestReg && !(busy & destRegs)) {
+            // nothing in between needs the destination, so move the value there early
+            defInst.a = useInst.a;
+            useInst = IRInst();
+        } else {
+            // otherwise hold it in a register that isn't touched in between or read after
+            reg_set_t live = liveOut[range.block];
+            for (size_t j = insts.size(); j-- > range.use+1;) {
+                reg_set_t uses, defs;
+                getLiveEffects(func, insts[j], uses, defs);
+                live = (live & ~defs) | uses;
+            }
+
+            isAllocated = false;
+            const char* const* candidates = width == 16 ? WORD_CANDIDATES : BYTE_CANDIDATES;
+            for (size_t i = 0; i < 4 && !isAllocated; ++i) {
+                reg_set_t regs = 0;
+                getRegisterSet(candidates[i], regs);
+                if ((busy | live) & regs) continue;
+
+                const IROperand reg = IROperand::makeReg(candidates[i]);
+                defInst.a = reg;
+                useInst.b = reg;
+                isAllocated = true;
+            }
+        }
+        if (!isAllocated) continue;
+
+        // close the slot's gap in the stack
+        for (IROperand* pOperand : belowSlot)
+            pOperand->value += width / 8;
+        ++numAllocated;
+    }
+
+    // drop the moves that were folded away
+    for (IRBlock& block : func.blocks) {
+        std::vector<IRInst>& insts = block.insts;
+        for (size_t i = 0; i < insts.size(); ++i)
+            if (insts[i].op == IROpcode::NOP) insts.erase(insts.begin() + i--);
+    }
+    return numAllocated;
+}
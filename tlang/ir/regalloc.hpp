@@ -0,0 +1,18 @@
+#ifndef __REGALLOC_HPP
+#define __REGALLOC_HPP
+
+#include "ir.hpp"
+
+/**
+ * Gives virtual registers (expression temporaries) a free register instead of a stack slot.
+ *
+ * A linear scan over each virtual register written & read back in the same block, in the order they're
+ * written. One gets a register if nothing between the write and the read touches that register, uses the SP
+ * other than pushing & popping, or reaches into its slot, and the register isn't live after the read. Any
+ * SP-relative access in between that reaches below the slot is moved up to match. The rest stay on the stack.
+ */
+
+// allocates registers to the function's virtual registers, returns the number allocated
+size_t allocateRegisters(IRFunction&);
+
+#endif
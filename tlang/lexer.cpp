@@ -1,4 +1,8 @@
-#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <vector>
 
 #include "lexer.hpp"
@@ -9,40 +13,170 @@
 #include "util/t_exception.hpp"
 
 static bool isInMultilineComment = false;
-static macrodef_map macrodefMap;
+static macrodef_map macrodefMap = getPredefinedMacrodefs();
+
+/********************************************************/
+/*                   KEYWORD LOOKUP                     */
+/********************************************************/
+
+#define KEYWORD_TABLE_SIZE 64
+#define KEYWORD_MIN_LENGTH 2
+#define KEYWORD_MAX_LENGTH 9
+
+struct Keyword {
+    std::string_view kwd;
+    TokenType type;
+};
+
+static constexpr Keyword KEYWORDS[] = {
+    {"true", TokenType::LIT_BOOL}, {"false", TokenType::LIT_BOOL}, {"void", TokenType::VOID},
+    {"sizeof", TokenType::SIZEOF}, {"asm", TokenType::ASM},
+    {"__load_AX", TokenType::ASM_LOAD_AX}, {"__load_BX", TokenType::ASM_LOAD_BX},
+    {"__load_CX", TokenType::ASM_LOAD_CX}, {"__load_DX", TokenType::ASM_LOAD_DX},
+    {"__read_AX", TokenType::ASM_READ_AX}, {"__read_BX", TokenType::ASM_READ_BX},
+    {"__read_CX", TokenType::ASM_READ_CX}, {"__read_DX", TokenType::ASM_READ_DX},
+    {"const", TokenType::CONST}, {"inline", TokenType::INLINE},
+    {"unsigned", TokenType::UNSIGNED}, {"signed", TokenType::SIGNED},
+    {"return", TokenType::RETURN}, {"if", TokenType::IF}, {"else", TokenType::ELSE},
+    {"while", TokenType::WHILE}, {"for", TokenType::FOR},
+    {"int", TokenType::TYPE_INT}, {"double", TokenType::TYPE_FLOAT},
+    {"char", TokenType::TYPE_CHAR}, {"bool", TokenType::TYPE_BOOL}
+};
+
+// perfect hash over a few characters of each keyword (length must be in [KEYWORD_MIN_LENGTH, KEYWORD_MAX_LENGTH])
+static constexpr size_t hashKeyword(std::string_view word) {
+    const size_t len = word.size();
+    return ((unsigned char)word[0] + (unsigned char)word[len > 2 ? 2 : 1] +
+            9 * (unsigned char)word[len-2] + (unsigned char)word[len-1]) & (KEYWORD_TABLE_SIZE-1);
+}
+
+struct KeywordTable {
+    Keyword slots[KEYWORD_TABLE_SIZE];
+};
+
+static constexpr KeywordTable buildKeywordTable() {
+    KeywordTable table{};
+    for (const Keyword& keyword : KEYWORDS)
+        table.slots[hashKeyword(keyword.kwd)] = keyword;
+    return table;
+}
+
+static constexpr bool isKeywordHashPerfect() {
+    bool isUsed[KEYWORD_TABLE_SIZE] = {};
+    for (const Keyword& keyword : KEYWORDS) {
+        const size_t len = keyword.kwd.size();
+        if (len < KEYWORD_MIN_LENGTH || len > KEYWORD_MAX_LENGTH) return false;
+
+        const size_t hash = hashKeyword(keyword.kwd);
+        if (isUsed[hash]) return false;
+        isUsed[hash] = true;
+    }
+    return true;
+}
+
+static_assert(isKeywordHashPerfect(), "Keyword hash has collisions, update hashKeyword");
+
+static constexpr KeywordTable KEYWORD_TABLE = buildKeywordTable();
+
+// returns the keyword matching the identifier, or nullptr if it's a regular identifier
+static const Keyword* lookupKeyword(std::string_view word) {
+    if (word.size() < KEYWORD_MIN_LENGTH || word.size() > KEYWORD_MAX_LENGTH) return nullptr;
 
-// returns true if the keyword is present and is not part of an identifier
-bool isKwdPresent(const std::string& kwd, const std::string& line, size_t offset) {
-    if (line.find(kwd, offset) != offset) return false; // not present
+    const Keyword& keyword = KEYWORD_TABLE.slots[hashKeyword(word)];
+    return keyword.kwd == word ? &keyword : nullptr;
+}
+
+/********************************************************/
+/*                    FILE MAPPING                      */
+/********************************************************/
+
+// a read-only view of an entire file, mapped into memory for the lifetime of the object
+class MappedFile {
+    public:
+        MappedFile(const std::filesystem::path&);
+        ~MappedFile();
+
+        bool isOpen() const { return _isOpen; };
+        std::string_view view() const { return std::string_view((const char*)pData, size); };
+    private:
+        void* pData = nullptr;
+        size_t size = 0;
+        bool _isOpen = false;
+};
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) return;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1 || !S_ISREG(fileStat.st_mode)) {
+        close(fd);
+        return;
+    }
+
+    // empty files can't be mapped but are still valid documents
+    size = fileStat.st_size;
+    if (size > 0) {
+        pData = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pData == MAP_FAILED) {
+            pData = nullptr;
+            size = 0;
+            close(fd);
+            return;
+        }
+    }
+
+    close(fd); // the mapping outlives the descriptor
+    _isOpen = true;
+}
 
-    // verify no identifier tacked onto the end
-    const size_t end = offset + kwd.size();
-    return end == line.size() || !isCharValidIdentifier(line[end]);
+MappedFile::~MappedFile() {
+    if (pData != nullptr) munmap(pData, size);
 }
 
-// tokenize a document to a vector of Tokens
-void tokenize(std::ifstream& inHandle, std::vector<Token>& tokens, cwd_stack& cwdStack, const std::string& filename, const bool isStdlib) {
-    // continuously read in the entire document, adding tokens
-    std::string line;
+/********************************************************/
+/*                       LEXER                          */
+/********************************************************/
+
+// tokenize a document to a vector of Tokens, returns false if the file can't be opened
+bool tokenize(const std::filesystem::path& inPath, std::vector<Token>& tokens, cwd_stack& cwdStack, const std::string& filename, const bool isStdlib) {
+    MappedFile file(inPath);
+    if (!file.isOpen()) return false;
+
+    // walk over each line of the mapped document
+    const std::string_view document = file.view();
+    const symbol_t fileSymbol = internSymbol(filename);
 
     line_t lineNumber = 0;
-    while (std::getline(inHandle, line)) {
+    size_t lineStart = 0;
+    while (lineStart < document.size()) {
+        size_t lineEnd = document.find('\n', lineStart);
+        if (lineEnd == std::string_view::npos) lineEnd = document.size();
+
+        std::string_view line = document.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
         // remove trailing \r if present (CRLF for Windows systems)
-        if (*line.rbegin() == '\r') line.pop_back();
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
 
         // tokenize line
-        tokenizeLine(line, tokens, ++lineNumber, cwdStack, filename, isStdlib);
+        tokenizeLine(line, tokens, ++lineNumber, cwdStack, fileSymbol, isStdlib);
     }
+
+    // comments can't continue into the including file
+    if (isInMultilineComment)
+        throw TUnclosedCommentException(ErrInfo(lineNumber, 0, fileSymbol));
+    return true;
 }
 
 // tokenize a particular line
-void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumber, cwd_stack& cwdStack, const std::string& filename, const bool isStdlib) {
+void tokenizeLine(std::string_view line, std::vector<Token>& tokens, line_t lineNumber, cwd_stack& cwdStack, const symbol_t fileSymbol, const bool isStdlib) {
     if (line.size() == 0) return;
 
     // if in a multiline comment, look for closing char
     size_t i = 0;
     if (isInMultilineComment) {
-        if ((i = line.find("*/")) == std::string::npos) {
+        if ((i = line.find("*/")) == std::string_view::npos) {
             return;
         } else { // jump to closing comment
             i += 2;
@@ -50,17 +184,26 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
         }
     }
 
-    // replace any macro definitions
-    replaceMacrodefs(line, macrodefMap, i);
-
-    // run preprocessor for this line
-    if (!isInMultilineComment) {
-        bool hasPreprocessed = preprocessLine(line, macrodefMap, tokens, cwdStack, ErrInfo(lineNumber, 0, filename));
+    // run preprocessor for this line, only lines starting with a '#' can be directives
+    const ErrInfo lineErr(lineNumber, 0, fileSymbol);
+    const size_t firstChar = line.find_first_not_of(" \t\n\v\f\r");
+    if (firstChar != std::string_view::npos && line[firstChar] == '#') {
+        bool hasPreprocessed = preprocessLine(std::string(line), macrodefMap, tokens, cwdStack, lineErr);
 
         // skip lines used by the preprocessor
         if (hasPreprocessed) return;
     }
 
+    // expand any macro definitions (only copies the line when something is expanded)
+    std::string expandedLine;
+    if (!macrodefMap.empty() && expandMacrodefs(line, expandedLine, macrodefMap, lineErr, i))
+        line = expandedLine;
+
+    // true if the line continues with the given string at an offset
+    const auto isAt = [&line](size_t offset, std::string_view str) {
+        return line.compare(offset, str.size(), str) == 0;
+    };
+
     // iterate over all characters
     const size_t lineLen = line.size();
     std::string buffer; // mutable buffer cleared each iteration
@@ -69,18 +212,18 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
 
         // reset buffer & prepare error info object
         buffer.clear();
-        ErrInfo err(lineNumber, i+1, filename);
+        ErrInfo err(lineNumber, i+1, fileSymbol);
 
         // handle the current character
         // break on single line comments
-        if (line.find("//", i) == i) break;
+        if (isAt(i, "//")) break;
 
         // handle multiline comments
-        if (line.find("/*", i) == i) {
+        if (isAt(i, "/*")) {
             i++;
             // try to jump to closing comment
             size_t closeIndex;
-            if ((closeIndex = line.find("*/", i)) != std::string::npos) {
+            if ((closeIndex = line.find("*/", i)) != std::string_view::npos) {
                 i = closeIndex+1;
                 isInMultilineComment = false;
             } else {
@@ -91,11 +234,12 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
         }
 
         // int/float literals (cannot start with a decimal/period!!)
-        if (line.find("0x") == i || line.find("0b") == i) {
+        if (isAt(i, "0x") || isAt(i, "0b")) {
             const bool isHex = line[i+1] == 'x';
             // parse hex/binary literal
             TokenType tokenType = TokenType::LIT_INT;
             i += 2;
+            if (i == lineLen) throw TInvalidTokenException(err);
             buffer = line[i];
             while (++i < lineLen && std::isxdigit(line[i])) {
                 buffer.push_back(line[i]);
@@ -112,155 +256,38 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
             continue;
         } else if (std::isdigit(line[i])) {
             TokenType tokenType = TokenType::LIT_INT;
-            buffer = line[i]; // update buffer
+            const size_t start = i;
             while (++i < lineLen && (std::isdigit(line[i]) || line[i] == '.')) {
                 if (line[i] == '.') tokenType = TokenType::LIT_FLOAT; // set as double if encountering a decimal
-                buffer.push_back(line[i]);
             }
 
+            // add the token
+            tokens.push_back(Token(err, line.substr(start, i - start), tokenType));
+
             // rollback iterator if not at end
             if (i != lineLen) i--;
-
-            // add the token
-            tokens.push_back(Token(err, buffer, tokenType));
             continue;
         }
 
-        // character literals
-        if (line[i] == '\'') {
+        // character & string literals
+        if (line[i] == '\'' || line[i] == '"') {
             // look for closing quote
-            buffer = line[i];
+            const char quote = line[i];
+            const size_t start = i;
             while (++i < lineLen) {
-                buffer.push_back(line[i]); // add character
                 if (line[i] == '\\') { // check for escape characters and skip next character
                     if (i+1 == lineLen) throw TInvalidEscapeException(err);
-                    buffer.push_back(line[++i]); // add escaped character
-                } else if (line[i] == '\'') { // break on closing quote
+                    ++i;
+                } else if (line[i] == quote) { // break on closing quote
                     break;
                 }
             }
 
             // if reached the end of the line, unclosed quote (don't rollback, breaks when hitting quote)
             if (i == lineLen) throw TUnclosedQuoteException(err);
-            
-            // otherwise, add the token
-            tokens.push_back(Token(err, buffer, TokenType::LIT_CHAR));
-            continue;
-        }
-
-        // string literals
-        if (line[i] == '"') {
-            // look for closing quote
-            buffer = line[i];
-            while (++i < lineLen) {
-                buffer.push_back(line[i]); // add character
-                if (line[i] == '\\') { // check for escape characters and skip next character
-                    if (i+1 == lineLen) throw TInvalidEscapeException(err);
-                    buffer.push_back(line[++i]); // add escaped character
-                } else if (line[i] == '"') { // break on closing quote
-                    break;
-                }
-            }
 
-            // if reached the end of the line, unclosed quote (don't rollback, breaks when hitting quote)
-            if (i == lineLen) throw TUnclosedQuoteException(err);
-            
             // otherwise, add the token
-            tokens.push_back(Token(err, buffer, TokenType::LIT_STRING));
-            continue;
-        }
-        
-        // literal boolean
-        if (isKwdPresent("true", line, i)) {
-            i += 3; // offset by length of keyword - 1
-            tokens.push_back(Token(err, "true", TokenType::LIT_BOOL));
-            continue;
-        } else if (isKwdPresent("false", line, i)) {
-            i += 4; // offset by length of keyword - 1
-            tokens.push_back(Token(err, "false", TokenType::LIT_BOOL));
-            continue;
-        }
-
-        // literal void
-        if (isKwdPresent("void", line, i)) {
-            i += 3; // offset by length of keyword - 1
-            tokens.push_back(Token(err, "void", TokenType::VOID));
-            continue;
-        }
-
-        // sizeof keyword
-        if (isKwdPresent("sizeof", line, i)) {
-            i += 5; // offset by length of keyword - 1
-            tokens.push_back(Token(err, "sizeof", TokenType::SIZEOF));
-            continue;
-        }
-        
-        // asm keyword
-        if (isKwdPresent("asm", line, i)) {
-            i += 2; // offset by length of keyword - 1
-            tokens.push_back(Token(err, "asm", TokenType::ASM));
-            continue;
-        }
-
-        // protected assembly keywords
-        if (line.find("__load_", i) == i) {
-            if (isKwdPresent("__load_AX", line, i)) {
-                if (!isStdlib) throw TInvalidTokenException(err);
-                i += 8; // offset by length of keyword - 1
-                tokens.push_back(Token(err, "__load_AX", TokenType::ASM_LOAD_AX));
-                continue;
-            } else if (isKwdPresent("__load_BX", line, i)) {
-                if (!isStdlib) throw TInvalidTokenException(err);
-                i += 8; // offset by length of keyword - 1
-                tokens.push_back(Token(err, "__load_BX", TokenType::ASM_LOAD_BX));
-                continue;
-            } else if (isKwdPresent("__load_CX", line, i)) {
-                if (!isStdlib) throw TInvalidTokenException(err);
-                i += 8; // offset by length of keyword - 1
-                tokens.push_back(Token(err, "__load_CX", TokenType::ASM_LOAD_CX));
-                continue;
-            } else if (isKwdPresent("__load_DX", line, i)) {
-                if (!isStdlib) throw TInvalidTokenException(err);
-                i += 8; // offset by length of keyword - 1
-                tokens.push_back(Token(err, "__load_DX", TokenType::ASM_LOAD_DX));
-                continue;
-            }
-        } else if (line.find("__read_", i) == i) {
-            if (isKwdPresent("__read_AX", line, i)) {
-                if (!isStdlib) throw TInvalidTokenException(err);
-                i += 8; // offset by length of keyword - 1
-                tokens.push_back(Token(err, "__read_AX", TokenType::ASM_READ_AX));
-                continue;
-            } else if (isKwdPresent("__read_BX", line, i)) {
-                if (!isStdlib) throw TInvalidTokenException(err);
-                i += 8; // offset by length of keyword - 1
-                tokens.push_back(Token(err, "__read_BX", TokenType::ASM_READ_BX));
-                continue;
-            } else if (isKwdPresent("__read_CX", line, i)) {
-                if (!isStdlib) throw TInvalidTokenException(err);
-                i += 8; // offset by length of keyword - 1
-                tokens.push_back(Token(err, "__read_CX", TokenType::ASM_READ_CX));
-                continue;
-            } else if (isKwdPresent("__read_DX", line, i)) {
-                if (!isStdlib) throw TInvalidTokenException(err);
-                i += 8; // offset by length of keyword - 1
-                tokens.push_back(Token(err, "__read_DX", TokenType::ASM_READ_DX));
-                continue;
-            }
-        }
-
-        // unsigned, signed, and const keywords
-        if (isKwdPresent("const", line, i)) {
-            i += 4; // offset by length of keyword - 1
-            tokens.push_back(Token(err, "const", TokenType::CONST));
-            continue;
-        } else if (isKwdPresent("unsigned", line, i)) {
-            i += 7; // offset by length of keyword - 1
-            tokens.push_back(Token(err, "unsigned", TokenType::UNSIGNED));
-            continue;
-        } else if (isKwdPresent("signed", line, i)) {
-            i += 5; // offset by length of keyword - 1
-            tokens.push_back(Token(err, "signed", TokenType::SIGNED));
+            tokens.push_back(Token(err, line.substr(start, i - start + 1), quote == '"' ? TokenType::LIT_STRING : TokenType::LIT_CHAR));
             continue;
         }
 
@@ -284,68 +311,48 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
             case '%': ADD_SINGLE_CHAR_TOKEN(line[i], TokenType::OP_MOD)
         }
 
-        // check for keywords
-        if (isKwdPresent("return", line, i)) {
-            tokens.push_back(Token(err, "return", TokenType::RETURN));
-            i += 5; // offset by length of keyword - 1
-            continue;
-        } else if (isKwdPresent("if", line, i)) {
-            tokens.push_back(Token(err, "if", TokenType::IF));
-            i += 1; // offset by length of keyword - 1
-            continue;
-        } else if (isKwdPresent("else if", line, i)) {
-            tokens.push_back(Token(err, "else if", TokenType::ELSE_IF));
-            i += 6; // offset by length of keyword - 1
-            continue;
-        } else if (isKwdPresent("else", line, i)) {
-            tokens.push_back(Token(err, "else", TokenType::ELSE));
-            i += 3; // offset by length of keyword - 1
-            continue;
-        } else if (isKwdPresent("while", line, i)) {
-            tokens.push_back(Token(err, "while", TokenType::WHILE));
-            i += 4; // offset by length of keyword - 1
-            continue;
-        } else if (isKwdPresent("for", line, i)) {
-            tokens.push_back(Token(err, "for", TokenType::FOR));
-            i += 2; // offset by length of keyword - 1
-            continue;
-        } else if (isKwdPresent("int", line, i)) {
-            tokens.push_back(Token(err, "int", TokenType::TYPE_INT));
-            i += 2; // offset by length of keyword - 1
-            continue;
-        } else if (isKwdPresent("double", line, i)) {
-            tokens.push_back(Token(err, "double", TokenType::TYPE_FLOAT));
-            i += 5; // offset by length of keyword - 1
-            continue;
-        } else if (isKwdPresent("char", line, i)) {
-            tokens.push_back(Token(err, "char", TokenType::TYPE_CHAR));
-            i += 3; // offset by length of keyword - 1
-            continue;
-        } else if (isKwdPresent("bool", line, i)) {
-            tokens.push_back(Token(err, "bool", TokenType::TYPE_BOOL));
-            i += 3; // offset by length of keyword - 1
-            continue;
-        } else if (isCharValidIdentifierStart(line[i])) {
-            // handle identifier
-            buffer = line[i];
-            while (++i < lineLen && isCharValidIdentifier(line[i]))
-                buffer.push_back(line[i]);
+        // scan identifiers once, then classify any keywords
+        if (isCharValidIdentifierStart(line[i])) {
+            const size_t start = i;
+            while (++i < lineLen && isCharValidIdentifier(line[i]));
+            std::string_view word = line.substr(start, i - start);
+
+            const Keyword* pKeyword = lookupKeyword(word);
+            TokenType tokenType = pKeyword == nullptr ? TokenType::IDENTIFIER : pKeyword->type;
+            switch (tokenType) {
+                case TokenType::ASM_LOAD_AX: case TokenType::ASM_LOAD_BX:
+                case TokenType::ASM_LOAD_CX: case TokenType::ASM_LOAD_DX:
+                case TokenType::ASM_READ_AX: case TokenType::ASM_READ_BX:
+                case TokenType::ASM_READ_CX: case TokenType::ASM_READ_DX:
+                    // protected assembly keywords
+                    if (!isStdlib) throw TInvalidTokenException(err);
+                    break;
+                case TokenType::ELSE:
+                    // merge "else if" (separated by a single space) into one token
+                    if (isAt(i, " if") && (i+3 == lineLen || !isCharValidIdentifier(line[i+3]))) {
+                        tokenType = TokenType::ELSE_IF;
+                        i += 3;
+                        word = line.substr(start, i - start);
+                    }
+                    break;
+                default: break;
+            }
+
+            // add the token
+            tokens.push_back(Token(err, word, tokenType));
 
             // rollback iterator if not at end
             if (i != lineLen) i--;
-
-            // add the token
-            tokens.push_back(Token(err, buffer, TokenType::IDENTIFIER));
             continue;
         }
 
         // switch on more complex operators
         switch (line[i]) {
             case '<': {
-                if (line.find("<<", i) == i) {
+                if (isAt(i, "<<")) {
                     i++; // offset by length of keyword - 1
                     tokens.push_back(Token(err, "<<", TokenType::OP_LSHIFT));
-                } else if (line.find("<=", i) == i) {
+                } else if (isAt(i, "<=")) {
                     i++; // offset by length of keyword - 1
                     tokens.push_back(Token(err, "<=", TokenType::OP_LTE));
                 } else {
@@ -354,10 +361,10 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
                 continue;
             }
             case '>': {
-                if (line.find(">>", i) == i) {
+                if (isAt(i, ">>")) {
                     i++; // offset by length of keyword - 1
                     tokens.push_back(Token(err, ">>", TokenType::OP_RSHIFT));
-                } else if (line.find(">=", i) == i) {
+                } else if (isAt(i, ">=")) {
                     i++; // offset by length of keyword - 1
                     tokens.push_back(Token(err, ">=", TokenType::OP_GTE));
                 } else {
@@ -366,7 +373,7 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
                 continue;
             }
             case '&': {
-                if (line.find("&&", i) == i) {
+                if (isAt(i, "&&")) {
                     i++; // offset by length of keyword - 1
                     tokens.push_back(Token(err, "&&", TokenType::OP_BOOL_AND));
                 } else {
@@ -375,7 +382,7 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
                 continue;
             }
             case '|': {
-                if (line.find("||", i) == i) {
+                if (isAt(i, "||")) {
                     i++; // offset by length of keyword - 1
                     tokens.push_back(Token(err, "||", TokenType::OP_BOOL_OR));
                 } else {
@@ -384,7 +391,7 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
                 continue;
             }
             case '!': {
-                if (line.find("!=", i) == i) {
+                if (isAt(i, "!=")) {
                     i++; // offset by length of keyword - 1
                     tokens.push_back(Token(err, "!=", TokenType::OP_NEQ));
                 } else {
@@ -393,7 +400,7 @@ void tokenizeLine(std::string& line, std::vector<Token>& tokens, line_t lineNumb
                 continue;
             }
             case '=': {
-                if (line.find("==", i) == i) {
+                if (isAt(i, "==")) {
                     i++; // offset by length of keyword - 1
                     tokens.push_back(Token(err, "==", TokenType::OP_EQ));
                 } else {
@@ -2,18 +2,18 @@
 #define __LEXER_HPP
 
 #include <filesystem>
-#include <fstream>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "preprocessor.hpp"
 #include "util/token.hpp"
 
-// tokenize a document to a vector of Tokens
-void tokenize(std::ifstream&, std::vector<Token>&, cwd_stack&, const std::string&, const bool=false);
+// tokenize a document to a vector of Tokens, returns false if the file can't be opened
+bool tokenize(const std::filesystem::path&, std::vector<Token>&, cwd_stack&, const std::string&, const bool=false);
 
 // tokenize a particular line
-void tokenizeLine(std::string&, std::vector<Token>&, line_t, cwd_stack&, const std::string&, const bool=false);
+void tokenizeLine(std::string_view, std::vector<Token>&, line_t, cwd_stack&, const symbol_t, const bool=false);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <string>
+
+#include "constant_folding.hpp"
+
+#include "../util/token.hpp"
+#include "../util/toolbox.hpp"
+
+/************************ VALUE HELPERS ************************/
+
+// true if values of this type can be folded (non-pointer int, char or bool)
+static bool isFoldableType(const Type& type) {
+    if (type.isPointer()) return false;
+    const TokenType prim = type.getPrimType();
+    return prim == TokenType::TYPE_INT || prim == TokenType::TYPE_CHAR || prim == TokenType::TYPE_BOOL;
+}
+
+static unsigned int getSizeMask(size_t size) {  return size == 1 ? 0xFF : 0xFFFF;  }
+
+// reinterprets the lowest size bytes of a value as signed
+static int toSigned(unsigned int bits, size_t size) {
+    bits &= getSizeMask(size);
+    const unsigned int signBit = size == 1 ? 0x80 : 0x8000;
+    return (bits & signBit) ? (int)bits - (int)getSizeMask(size) - 1 : (int)bits;
+}
+
+// converts a value between integral types exactly like the assembler's implicitCast
+static unsigned int castValue(unsigned int bits, const Type& from, const Type& to) {
+    const size_t startSize = from.getSizeBytes(), endSize = to.getSizeBytes();
+    bits &= getSizeMask(startSize);
+
+    // same primitive type, signedness doesn't change the bits
+    if (from.getPrimType() == to.getPrimType()) return bits;
+
+    // casting to a bool enforces 1 or 0
+    if (to.getPrimType() == TokenType::TYPE_BOOL)
+        bits = bits != 0;
+
+    // the sign bit of the highest byte is preserved for signed values
+    const unsigned int signBit = from.isUnsigned() ? 0 : (bits >> (8 * (startSize-1))) & 0x80;
+
+    if (startSize < endSize) { // pad bytes
+        if (signBit) bits |= 0xFF00;
+    } else if (startSize > endSize) { // pop bytes
+        bits = (bits & 0xFF) | signBit;
+    }
+    return bits;
+}
+
+// gets the value of a literal node as its own type, returns false if this isn't a foldable literal
+static bool getLiteralBits(ASTNode* pNode, unsigned int& bits) {
+    ASTTypedNode* pTyped = static_cast<ASTTypedNode*>(pNode);
+    if (pTyped->getNumSubscripts() > 0 || !isFoldableType(pTyped->getTypeRef())) return false;
+
+    // literals are always pushed as their natural type, then cast to the node's type
+    Type naturalType;
+    switch (pNode->getNodeType()) {
+        case ASTNodeType::LIT_INT:
+            bits = static_cast<ASTIntLiteral*>(pNode)->val & 0xFFFF;
+            naturalType = Type(TokenType::TYPE_INT);
+            break;
+        case ASTNodeType::LIT_CHAR:
+            bits = static_cast<ASTCharLiteral*>(pNode)->val & 0xFF;
+            naturalType = Type(TokenType::TYPE_CHAR);
+            break;
+        case ASTNodeType::LIT_BOOL:
+            bits = static_cast<ASTBoolLiteral*>(pNode)->val & 0xFF;
+            naturalType = Type(TokenType::TYPE_BOOL);
+            break;
+        default: return false;
+    }
+
+    bits = castValue(bits, naturalType, pTyped->getTypeRef());
+    return true;
+}
+
+// creates a literal holding the given value for a node of the given type, or nullptr if it can't be represented
+static ASTTypedNode* makeLiteral(const Type& type, unsigned int bits, const ErrInfo& err) {
+    const size_t size = type.getSizeBytes();
+    const int value = type.isUnsigned() ? (int)(bits & getSizeMask(size)) : toSigned(bits, size);
+
+    ASTTypedNode* pLiteral;
+    switch (type.getPrimType()) {
+        case TokenType::TYPE_INT:
+            pLiteral = new ASTIntLiteral(value, Token(err, std::to_string(value), TokenType::LIT_INT));
+            break;
+        case TokenType::TYPE_CHAR:
+            pLiteral = new ASTCharLiteral(value, Token(err, std::to_string(value), TokenType::LIT_CHAR));
+            break;
+        case TokenType::TYPE_BOOL:
+            if (bits > 1) return nullptr; // (ex. true + true)
+            pLiteral = new ASTBoolLiteral(bits == 1, Token(err, bits == 1 ? "true" : "false", TokenType::LIT_BOOL));
+            break;
+        default: return nullptr;
+    }
+
+    pLiteral->setType(type);
+    return pLiteral;
+}
+
+/************************ OPERATORS ************************/
+
+// evaluates a unary operator on a literal, writing the raw result & its type
+static bool evalUnaryOp(ASTOperator& op, unsigned int& result, Type& resultType) {
+    unsigned int a;
+    if (op.size() != 1 || !getLiteralBits(op.at(0), a)) return false;
+
+    const Type& typeA = static_cast<ASTTypedNode*>(op.at(0))->getTypeRef();
+    const unsigned int mask = getSizeMask(typeA.getSizeBytes());
+    resultType = typeA;
+
+    // typecasts just pass the value through to be cast
+    if (op.getUnaryType() == ASTUnaryType::TYPE_CAST) {
+        result = a;
+        return true;
+    }
+
+    switch (op.getOpTokenType()) {
+        case TokenType::OP_ADD: result = a; return true;
+        case TokenType::OP_SUB: result = (~a + 1) & mask; return true;
+        case TokenType::OP_BIT_NOT: result = ~a & mask; return true;
+        case TokenType::OP_BOOL_NOT: {
+            result = (a & mask) == 0;
+            resultType = Type(TokenType::TYPE_BOOL);
+            return true;
+        }
+        default: return false;
+    }
+}
+
+// evaluates a binary operator on two literals, writing the raw result & its type
+static bool evalBinaryOp(ASTOperator& op, unsigned int& result, Type& resultType) {
+    unsigned int a, b;
+    if (op.size() != 2 || !getLiteralBits(op.left(), a) || !getLiteralBits(op.right(), b)) return false;
+
+    // operands are zero-extended into registers of the dominant size
+    const Type& typeA = static_cast<ASTTypedNode*>(op.left())->getTypeRef();
+    const Type& typeB = static_cast<ASTTypedNode*>(op.right())->getTypeRef();
+    const Type dominantType = getDominantType(typeA, typeB);
+    const size_t size = dominantType.getSizeBytes();
+    const unsigned int mask = getSizeMask(size);
+    const bool isUnsigned = typeA.isUnsigned() || typeB.isUnsigned();
+    a &= mask;
+    b &= mask;
+
+    const int sA = toSigned(a, size), sB = toSigned(b, size);
+    resultType = dominantType;
+
+    switch (op.getOpTokenType()) {
+        case TokenType::OP_ADD: result = (a + b) & mask; return true;
+        case TokenType::OP_SUB: result = (a - b) & mask; return true;
+        case TokenType::OP_BIT_OR: result = a | b; return true;
+        case TokenType::AMPERSAND: result = a & b; return true;
+        case TokenType::OP_BIT_XOR: result = a ^ b; return true;
+        case TokenType::ASTERISK: {
+            if (isUnsigned) {
+                result = (a * b) & mask;
+            } else if (size == 1) {
+                result = (unsigned int)(sA * sB) & mask;
+            } else { // 16-bit signed multiplication takes the sign from the upper half of the product
+                const unsigned int product = (unsigned int)(sA * sB);
+                result = (product & 0xFFFF) | ((product >> 16) & 0x8000);
+            }
+            return true;
+        }
+        case TokenType::OP_DIV: case TokenType::OP_MOD: {
+            if (b == 0) return false; // leave to runtime
+            if (op.getOpTokenType() == TokenType::OP_DIV)
+                result = (isUnsigned ? a / b : (unsigned int)(sA / sB)) & mask;
+            else
+                result = (isUnsigned ? a % b : (unsigned int)(sA % sB)) & mask;
+            return true;
+        }
+        case TokenType::OP_LSHIFT: case TokenType::OP_RSHIFT: {
+            const unsigned int numShifts = std::min(b, (unsigned int)size * 8);
+            result = (op.getOpTokenType() == TokenType::OP_LSHIFT ? a << numShifts : a >> numShifts) & mask;
+            return true;
+        }
+        default: break;
+    }
+
+    // comparisons & boolean operators result in a bool
+    resultType = Type(TokenType::TYPE_BOOL);
+    switch (op.getOpTokenType()) {
+        case TokenType::OP_EQ: result = a == b; return true;
+        case TokenType::OP_NEQ: result = a != b; return true;
+        case TokenType::OP_LT: result = isUnsigned ? a < b : sA < sB; return true;
+        case TokenType::OP_GT: result = isUnsigned ? a > b : sA > sB; return true;
+        case TokenType::OP_LTE: result = isUnsigned ? a <= b : sA <= sB; return true;
+        case TokenType::OP_GTE: result = isUnsigned ? a >= b : sA >= sB; return true;
+        case TokenType::OP_BOOL_OR: result = (a | b) != 0; return true;
+        case TokenType::OP_BOOL_AND: result = a != 0 && b != 0; return true;
+        default: return false;
+    }
+}
+
+/************************ FOLDING ************************/
+
+// folds a node's children (and subscripts) in place
+static void foldChildren(ASTNode*, scope_stack_t&);
+
+// returns a literal to replace the node with, or nullptr if it isn't constant
+static ASTNode* foldNode(ASTNode* pNode, scope_stack_t& scopeStack) {
+    // sizeof only cares about the type of its operand
+    const ASTNodeType astType = pNode->getNodeType();
+    if (astType == ASTNodeType::UNARY_OP && static_cast<ASTOperator*>(pNode)->getOpTokenType() == TokenType::SIZEOF)
+        return nullptr;
+
+    foldChildren(pNode, scopeStack);
+
+    ASTTypedNode* pTyped = static_cast<ASTTypedNode*>(pNode);
+    const Type& type = pTyped->getTypeRef();
+    if (pTyped->getNumSubscripts() > 0 || !isFoldableType(type)) return nullptr;
+
+    unsigned int result;
+    Type resultType;
+    switch (astType) {
+        case ASTNodeType::IDENTIFIER: {
+            // propagate const locals
+            ASTIdentifier* pIdentifier = static_cast<ASTIdentifier*>(pNode);
+            if (pIdentifier->isLValue() || pIdentifier->isInAssignExpr) return nullptr;
+
+            ParserVariable* pVar = lookupParserVariable(scopeStack, pIdentifier->id, pIdentifier->err);
+            if (!pVar->hasConstValue || !isFoldableType(pVar->type)) return nullptr;
+
+            result = pVar->constValue;
+            resultType = pVar->type;
+            break;
+        }
+        case ASTNodeType::UNARY_OP: case ASTNodeType::BIN_OP: {
+            // nullified operators are already free
+            ASTOperator* pOp = static_cast<ASTOperator*>(pNode);
+            if (pOp->isNullified()) return nullptr;
+
+            const bool isFolded = pOp->getIsUnary() ? evalUnaryOp(*pOp, result, resultType) : evalBinaryOp(*pOp, result, resultType);
+            if (!isFolded) return nullptr;
+            break;
+        }
+        default: return nullptr;
+    }
+
+    // cast the result to what this node was expected to produce
+    return makeLiteral(type, castValue(result, resultType, type), pNode->err);
+}
+
+static void foldChildren(ASTNode* pNode, scope_stack_t& scopeStack) {
+    for (size_t i = 0; i < pNode->size(); ++i) {
+        ASTNode* pFolded = foldNode(pNode->at(i), scopeStack);
+        if (pFolded != nullptr) {
+            delete pNode->removeChild(i);
+            pNode->insert(pFolded, i);
+        }
+    }
+
+    // fold subscripts (ex. arr[SIZE - 1])
+    for (ASTArraySubscript* pSub : static_cast<ASTTypedNode*>(pNode)->getSubscripts())
+        foldChildren(pSub, scopeStack);
+}
+
+// folds constant subexpressions of a parsed top-level expression in place
+void foldConstants(ASTNode* pExpr, scope_stack_t& scopeStack) {
+    foldChildren(pExpr, scopeStack);
+}
+
+// gets the value of an expression wrapping a single literal as the expression's own type
+static bool getExprBits(ASTNode* pNode, unsigned int& bits) {
+    if (pNode->getNodeType() != ASTNodeType::EXPR) return getLiteralBits(pNode, bits);
+    if (pNode->size() != 1 || !getExprBits(pNode->at(0), bits)) return false;
+
+    // the wrapper casts its child's value to its own type
+    bits = castValue(bits, static_cast<ASTTypedNode*>(pNode->at(0))->getTypeRef(), static_cast<ASTTypedNode*>(pNode)->getTypeRef());
+    return true;
+}
+
+// if the (already folded) expression is a literal, writes its value as the given type and returns true
+bool evalConstantExpr(ASTNode* pExpr, const Type& type, int& value) {
+    unsigned int bits;
+    if (!isFoldableType(type) || !getExprBits(pExpr, bits)) return false;
+    if (!isFoldableType(static_cast<ASTTypedNode*>(pExpr)->getTypeRef())) return false;
+
+    value = castValue(bits, static_cast<ASTTypedNode*>(pExpr)->getTypeRef(), type);
+    return true;
+}
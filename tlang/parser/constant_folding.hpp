@@ -0,0 +1,20 @@
+#ifndef __CONSTANT_FOLDING_HPP
+#define __CONSTANT_FOLDING_HPP
+
+#include "../util/type.hpp"
+#include "../util/scope_stack.hpp"
+#include "../ast/ast_nodes.hpp"
+
+/**
+ * Compile-time evaluation of operators whose operands are int/char/bool literals, and propagation of
+ * const locals with constant initializers. Results are computed with the same 8/16-bit widths, signedness
+ * and implicit casts the assembler would emit, so a folded expression always matches its runtime value.
+ */
+
+// folds constant subexpressions of a parsed top-level expression in place
+void foldConstants(ASTNode*, scope_stack_t&);
+
+// if the (already folded) expression is a literal, writes its value as the given type and returns true
+bool evalConstantExpr(ASTNode*, const Type&, int&);
+
+#endif
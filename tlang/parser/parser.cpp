@@ -4,6 +4,7 @@
 
 #include "parser.hpp"
 #include "parser_precedences.hpp"
+#include "constant_folding.hpp"
 
 #include "../util/token.hpp"
 #include "../util/toolbox.hpp"
@@ -28,6 +29,11 @@ AST* parseToAST(const std::vector<Token>& tokens) {
             // parse the next function
             size_t startIndex = i, endIndex = i;
 
+            // functions may be marked inline ahead of their return type
+            const bool isInline = tokens[i].type == TokenType::INLINE;
+            if (isInline && ++i == tokensLen)
+                throw TInvalidTokenException(tokens[i-1].err);
+
             // verify return type is specified
             if (!isTokenTypeKeyword(tokens[i].type))
                 throw TSyntaxException(tokens[i].err);
@@ -85,7 +91,9 @@ AST* parseToAST(const std::vector<Token>& tokens) {
 
             // all good to go
             endIndex = i;
-            pAST->push( parseFunction(tokens, startIndex, endIndex, scopeStack, pAST, type) );
+            ASTFunction* pFunc = static_cast<ASTFunction*>( parseFunction(tokens, startIndex, endIndex, scopeStack, pAST, type) );
+            pFunc->setIsInline(isInline);
+            pAST->push(pFunc);
         }
     } catch (TException& e) {
         while (scopeStack.size() > 0) // free ParserVar pointers
@@ -270,6 +278,7 @@ void parseBody(ASTNode* pHead, const std::vector<Token>& tokens, const size_t st
                 // append expression to pReturn
                 if (i+1 < endExpr) { // if there is an expression
                     pReturn->push( parseExpression(tokens, i+1, endExpr-1, scopeStack, true) );
+                    foldConstants(pReturn->lastChild(), scopeStack);
                 }
                 i = endExpr;
                 break;
@@ -380,7 +389,7 @@ void parseBody(ASTNode* pHead, const std::vector<Token>& tokens, const size_t st
 
                         // add variable to scopeStack
                         ParserVariable* pParserVar = new ParserVariable(type, pHead, pVarDec);
-                        declareParserVariable(scopeStack, tokens[idenStart].raw, pParserVar, tokens[idenStart].err);
+                        declareParserVariable(scopeStack, tokens[idenStart].id, pParserVar, tokens[idenStart].err);
                         break;
                     } else if (tokens[i].type != TokenType::ASSIGN) { // variable must be assigned
                         throw TInvalidTokenException(tokens[i].err);
@@ -397,6 +406,7 @@ void parseBody(ASTNode* pHead, const std::vector<Token>& tokens, const size_t st
                     // append expression (*always* returns an ASTExpr* as an ASTNode*)
                     ASTExpr* pExpr = static_cast<ASTExpr*>(parseExpression(tokens, i+1, endExpr-1, scopeStack, true));
                     pVarDec->pExpr = pExpr;
+                    foldConstants(pExpr, scopeStack);
                     i = endExpr; // update `i` to position of semicolon
 
                     // confirm assignment type matches
@@ -422,7 +432,11 @@ void parseBody(ASTNode* pHead, const std::vector<Token>& tokens, const size_t st
 
                     // add variable to scopeStack
                     ParserVariable* pParserVar = new ParserVariable(type, pHead, pVarDec);
-                    declareParserVariable(scopeStack, tokens[idenStart].raw, pParserVar, tokens[idenStart].err);
+                    declareParserVariable(scopeStack, tokens[idenStart].id, pParserVar, tokens[idenStart].err);
+
+                    // remember the values of constants so they can be propagated
+                    if (type.isConst())
+                        pParserVar->hasConstValue = evalConstantExpr(pExpr, type, pParserVar->constValue);
                     break;
                 }
 
@@ -434,6 +448,7 @@ void parseBody(ASTNode* pHead, const std::vector<Token>& tokens, const size_t st
                 // verify semicolon is present
                 if (endExpr > endIndex) throw TInvalidTokenException(tokens[i].err);
                 pHead->push( parseExpression(tokens, i, endExpr-1, scopeStack, true) );
+                foldConstants(pHead->lastChild(), scopeStack);
                 i = endExpr;
                 break;
             }
@@ -530,13 +545,12 @@ ASTNode* parseFunction(const std::vector<Token>& tokens, const size_t startIndex
             if (tokens[idenStart].type != TokenType::IDENTIFIER)
                 throw TInvalidTokenException(tokens[idenStart].err);
 
-            const std::string paramName = tokens[idenStart].raw;
-            ASTFuncParam* pParam = new ASTFuncParam(paramName, type);
+            ASTFuncParam* pParam = new ASTFuncParam(tokens[idenStart], type);
             pHead->appendParam(pParam); // append parameter
 
             // add argument to scopeStack
             ParserVariable* pParserVar = new ParserVariable(type);
-            declareParserVariable(scopeStack, tokens[idenStart].raw, pParserVar, tokens[idenStart].err);
+            declareParserVariable(scopeStack, tokens[idenStart].id, pParserVar, tokens[idenStart].err);
 
             if (tokens[i].type == TokenType::COMMA) i++; // skip next comma
         }
@@ -549,7 +563,7 @@ ASTNode* parseFunction(const std::vector<Token>& tokens, const size_t startIndex
         pHead->loadParamTypes(paramTypes);
 
         ParserFunction* pParserFunc = new ParserFunction(retType, isMainFunction, pAST, pHead, paramTypes);
-        declareParserFunction(scopeStack, name, pParserFunc, paramTypes, tokens[startIndex].err); // put into scope
+        declareParserFunction(scopeStack, tokens[startIndex].id, pParserFunc, paramTypes, tokens[startIndex].err); // put into scope
 
         // verify opening brace is next
         if (tokens[++i].type != TokenType::LBRACE)
@@ -574,21 +588,8 @@ ASTNode* parseExpression(const std::vector<Token>& tokens, const size_t startInd
 
     // iterate through expression
     try {
-        // parsing all tokens directly (recursive for subexpressions) -- (L -> R)
-        parsePrecedence1(tokens, startIndex, endIndex, pHead, scopeStack);
-        
-        parsePrecedence2(tokens, pHead); // combine unaries -- (R -> L)
-        parsePrecedence3(pHead); // combine mult/div/mod -- (L -> R)
-        parsePrecedence4(pHead); // combine add/sub -- (L -> R)
-        parsePrecedence5(pHead); // combine bitshifts -- (L -> R)
-        parsePrecedence6(pHead); // combine comparison GT/LT/GTE/LTE operators -- (L -> R)
-        parsePrecedence7(pHead); // combine equality comparison operators -- (L -> R)
-        parsePrecedence8(pHead); // combine bitwise and -- (L -> R)
-        parsePrecedence9(pHead); // combine bitwise xor -- (L -> R)
-        parsePrecedence10(pHead); // combine bitwise or -- (L -> R)
-        parsePrecedence11(pHead); // combine logical and -- (L -> R)
-        parsePrecedence12(pHead); // combine logical or -- (L -> R)
-        parsePrecedence14(pHead); // combine assignment operators -- (R -> L)
+        // parse all tokens in one pass (recursive for subexpressions) -- (L -> R)
+        parsePrecedences(tokens, startIndex, endIndex, pHead, scopeStack);
 
         // infer type recursively for all nodes
         pHead->inferType(scopeStack);
@@ -639,10 +640,12 @@ ASTNode* parseConditional(const std::vector<Token>& tokens, const std::vector<si
                 // append expression
                 if (startToken.type == TokenType::IF) {
                     ASTNode* pExpr = parseExpression(tokens, startIndex+2, openBrace-2, scopeStack, true);
+                    foldConstants(pExpr, scopeStack);
                     static_cast<ASTExpr*>(pExpr)->setType(Type(TokenType::TYPE_BOOL));
                     static_cast<ASTIfCondition*>(pNode)->pExpr = pExpr;
                 } else {
                     ASTNode* pExpr = parseExpression(tokens, startIndex+2, openBrace-2, scopeStack, true);
+                    foldConstants(pExpr, scopeStack);
                     static_cast<ASTExpr*>(pExpr)->setType(Type(TokenType::TYPE_BOOL));
                     static_cast<ASTElseIfCondition*>(pNode)->pExpr = pExpr;
                 }
@@ -685,6 +688,7 @@ ASTNode* parseWhileLoop(const std::vector<Token>& tokens, const size_t startInde
 
         // parse expression
         pHead->pExpr = parseExpression( tokens, startIndex+2, i-2, scopeStack, true ); // ignore parenthesis
+        foldConstants(pHead->pExpr, scopeStack);
 
         // force as bool
         static_cast<ASTExpr*>(pHead->pExpr)->setType(Type(TokenType::TYPE_BOOL));
@@ -732,6 +736,9 @@ ASTNode* parseForLoop(const std::vector<Token>& tokens, const size_t startIndex,
         pHead->pExprA = parseExpression( tokens, startIndex+2, semiA-1, scopeStack, true); // ignore opening parenthesis & semicolon
         pHead->pExprB = parseExpression( tokens, semiA+1, semiB-1, scopeStack, true); // ignore parenthesis & semicolon
         pHead->pExprC = parseExpression( tokens, semiB+1, i-2, scopeStack, true); // ignore closing parenthesis
+        foldConstants(pHead->pExprA, scopeStack);
+        foldConstants(pHead->pExprB, scopeStack);
+        foldConstants(pHead->pExprC, scopeStack);
 
         // force as bool
         static_cast<ASTExpr*>(pHead->pExprA)->setType(Type(TokenType::TYPE_BOOL));
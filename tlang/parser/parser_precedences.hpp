@@ -13,18 +13,11 @@
 // order of operations for expression parsing
 // operator precedence for C: https://en.cppreference.com/w/c/language/operator_precedence
 
-void parsePrecedence1(const std::vector<Token>&, size_t, size_t, ASTNode*, scope_stack_t&);
-void parsePrecedence2(const std::vector<Token>&, ASTNode*);
-void parsePrecedence3(ASTNode*);
-void parsePrecedence4(ASTNode*);
-void parsePrecedence5(ASTNode*);
-void parsePrecedence6(ASTNode*);
-void parsePrecedence7(ASTNode*);
-void parsePrecedence8(ASTNode*);
-void parsePrecedence9(ASTNode*);
-void parsePrecedence10(ASTNode*);
-void parsePrecedence11(ASTNode*);
-void parsePrecedence12(ASTNode*);
-void parsePrecedence14(ASTNode*);
+// the loosest binding C precedence level (assignment)
+#define LOWEST_PRECEDENCE 14
 
-#endif
\ No newline at end of file
+// parses the tokens of an expression into pHead in a single L -> R pass (precedence climbing),
+// subexpressions, function arguments and subscripts are parsed recursively as their own ASTExpr nodes
+void parsePrecedences(const std::vector<Token>&, size_t, size_t, ASTNode*, scope_stack_t&);
+
+#endif
@@ -1,5 +1,5 @@
+#include <algorithm>
 #include <filesystem>
-#include <fstream>
 #include <set>
 #include <sstream>
 #include <stack>
@@ -12,10 +12,36 @@
 #include "util/toolbox.hpp"
 #include "util/t_exception.hpp"
 
-#define STDLIB_DIR std::filesystem::canonical("/proc/self/exe").parent_path() / "stdlib/"
+#define WHITESPACE_CHARS " \t\n\v\f\r"
 
 static std::set<std::string> includedPaths;
 
+// the stdlib lives next to the tcc executable (resolved once)
+static const std::filesystem::path& getStdlibDir() {
+    static const std::filesystem::path stdlibDir = std::filesystem::canonical("/proc/self/exe").parent_path() / "stdlib/";
+    return stdlibDir;
+}
+
+// trims whitespace from both ends of a view
+static std::string_view trimView(std::string_view str) {
+    const size_t start = str.find_first_not_of(WHITESPACE_CHARS);
+    if (start == std::string_view::npos) return std::string_view();
+    return str.substr(start, str.find_last_not_of(WHITESPACE_CHARS) - start + 1);
+}
+
+macrodef_map getPredefinedMacrodefs() {
+    macrodef_map macroMap;
+
+    // TPU clock cycles per second, for clock()
+    // cast to unsigned since it doesn't fit a signed int (ex. CLOCKS_PER_SEC / 1000 would divide a negative value)
+    Macrodef clocksPerSec;
+    clocksPerSec.isFunctionLike = false;
+    clocksPerSec.body = "((unsigned int) " + std::to_string(CLOCK_FREQ_HZ) + ")";
+    macroMap[getSymbolName(internSymbol("CLOCKS_PER_SEC"))] = std::move(clocksPerSec);
+
+    return macroMap;
+}
+
 // break apart a string into its keywords from spaces
 void breakKeywords(const std::string& line, std::vector<std::string>& kwds) {
     // create stringstream from line
@@ -44,16 +70,49 @@ bool preprocessLine(std::string line, macrodef_map& macroMap, std::vector<Token>
     const std::string macroType = kwds[0].substr(1);
 
     if (macroType == "define") { // define something
-        if (kwds.size() < 3)
+        // read the macro name, a name directly followed by '(' is a function-like macro
+        const size_t nameStart = line.find_first_not_of(WHITESPACE_CHARS, kwds[0].size());
+        if (nameStart == std::string::npos || !isCharValidIdentifierStart(line[nameStart]))
             throw TIllegalMacroDefinitionException(err);
 
-        std::string defStr;
-        for (size_t i = 2; i < kwds.size(); i++) {
-            if (i != 2) defStr += ' ';
-            defStr += kwds[i];
+        size_t nameEnd = nameStart;
+        while (nameEnd < line.size() && isCharValidIdentifier(line[nameEnd])) nameEnd++;
+
+        Macrodef macro;
+        macro.isFunctionLike = nameEnd < line.size() && line[nameEnd] == '(';
+
+        size_t bodyStart = nameEnd;
+        if (macro.isFunctionLike) {
+            const size_t closeIndex = line.find(')', nameEnd);
+            if (closeIndex == std::string::npos)
+                throw TIllegalMacroDefinitionException(err);
+
+            // split the parameter names on commas
+            const std::string_view paramList = trimView(std::string_view(line).substr(nameEnd+1, closeIndex-nameEnd-1));
+            size_t paramStart = 0;
+            while (paramList.size() > 0) {
+                const size_t comma = std::min(paramList.find(',', paramStart), paramList.size());
+                const std::string_view param = trimView(paramList.substr(paramStart, comma - paramStart));
+                if (param.size() == 0 || !isCharValidIdentifierStart(param[0]) ||
+                    !std::all_of(param.begin(), param.end(), isCharValidIdentifier))
+                    throw TIllegalMacroDefinitionException(err);
+
+                macro.params.push_back(std::string(param));
+                if (comma == paramList.size()) break;
+                paramStart = comma + 1;
+            }
+            bodyStart = closeIndex + 1;
+        } else if (nameEnd < line.size() && !std::isspace(line[nameEnd])) {
+            throw TIllegalMacroDefinitionException(err);
         }
 
-        macroMap[kwds[1]] = defStr;
+        macro.body = trimView(std::string_view(line).substr(bodyStart));
+        if (macro.body.size() == 0)
+            throw TIllegalMacroDefinitionException(err);
+
+        // key on the interned name so the view outlives this line
+        const std::string& name = getSymbolName(internSymbol(std::string_view(line).substr(nameStart, nameEnd - nameStart)));
+        macroMap[name] = std::move(macro);
         return true;
     } else if (macroType == "include") { // include something
         if (kwds.size() != 2) throw TInvalidMacroIncludeException(err);
@@ -80,28 +139,24 @@ bool preprocessLine(std::string line, macrodef_map& macroMap, std::vector<Token>
             inPathAbs = cwdStack.top() / std::filesystem::path(inPath);
         } else {
             isStdlib = true;
-            inPathAbs = std::filesystem::path(STDLIB_DIR) / inPath;
+            inPathAbs = getStdlibDir() / inPath;
         }
 
         // prevent reincluding a file twice
         if (includedPaths.count(inPathAbs.string()) > 0) return true;
         includedPaths.insert(inPathAbs.string());
 
-        // load the file, tokenize
-        std::ifstream inHandle(inPathAbs);
-
-        if (!inHandle.is_open())
-            throw TInvalidMacroIncludeException(err);
-
         // set CWD
         cwdStack.push( std::filesystem::absolute(inPathAbs).parent_path() );
 
-        // tokenize
-        tokenize(inHandle, tokens, cwdStack, inPathAbs.filename().string(), isStdlib);
+        // load the file, tokenize
+        const bool isLoaded = tokenize(inPathAbs, tokens, cwdStack, inPathAbs.filename().string(), isStdlib);
 
-        // close file
+        // restore CWD
         cwdStack.pop();
-        inHandle.close();
+        if (!isLoaded)
+            throw TInvalidMacroIncludeException(err);
+
         return true;
     }
 
@@ -109,21 +164,157 @@ bool preprocessLine(std::string line, macrodef_map& macroMap, std::vector<Token>
     return false;
 }
 
-// replace all macro-defined matches
-void replaceMacrodefs(std::string& line, macrodef_map& macroMap, size_t offset) {
-    for (auto [oldStr, newStr] : macroMap) {
-        size_t i = offset;
-
-        while ((i = line.find(oldStr, i)) != std::string::npos) {
-            // verify this is its own word
-            size_t end = i + oldStr.size();
-            if ((i == 0 || !isCharValidIdentifier(line[i-1])) &&
-                (end == line.size() || std::isspace(line[end]) || !isCharValidIdentifier(line[end]))) {
-                line.erase(line.begin() + i, line.begin() + end);
-                line.insert(i, newStr);
-                i = end;
-            }
+// returns the index just past the quoted literal starting at i
+static size_t skipQuotedLiteral(std::string_view text, size_t i) {
+    const char quote = text[i];
+    while (++i < text.size()) {
+        if (text[i] == '\\') { // skip escaped characters
             ++i;
+        } else if (text[i] == quote) {
+            return i + 1;
+        }
+    }
+    return text.size();
+}
+
+// splits the arguments of a function-like macro invocation, returns the index just past its closing parenthesis
+static size_t splitMacroArgs(std::string_view text, size_t openIndex, std::vector<std::string_view>& args, const ErrInfo& err) {
+    size_t depth = 0;
+    size_t argStart = openIndex + 1;
+    for (size_t i = argStart; i < text.size(); i++) {
+        switch (text[i]) {
+            case '"': case '\'':
+                i = skipQuotedLiteral(text, i) - 1;
+                break;
+            case '(':
+                depth++;
+                break;
+            case ',':
+                if (depth > 0) break;
+                args.push_back(trimView(text.substr(argStart, i - argStart)));
+                argStart = i + 1;
+                break;
+            case ')':
+                if (depth-- > 0) break;
+                args.push_back(trimView(text.substr(argStart, i - argStart)));
+
+                // F() passes no arguments
+                if (args.size() == 1 && args[0].size() == 0) args.clear();
+                return i + 1;
+        }
+    }
+
+    // invocations must be closed on the same line
+    throw TInvalidMacroInvocationException(err);
+}
+
+// appends the body of a function-like macro with its parameters replaced by the arguments
+static void substituteMacroArgs(const Macrodef& macro, const std::vector<std::string>& args, std::string& out) {
+    const std::string_view body = macro.body;
+    size_t copyStart = 0;
+    size_t i = 0;
+    while (i < body.size()) {
+        if (body[i] == '"' || body[i] == '\'') {
+            i = skipQuotedLiteral(body, i);
+            continue;
+        } else if (!isCharValidIdentifier(body[i])) {
+            i++;
+            continue;
+        }
+
+        // scan the whole word, only identifiers can be parameters
+        const size_t start = i;
+        while (++i < body.size() && isCharValidIdentifier(body[i]));
+        if (std::isdigit(body[start])) continue;
+
+        const std::string_view word = body.substr(start, i - start);
+        for (size_t p = 0; p < macro.params.size(); p++) {
+            if (macro.params[p] != word) continue;
+
+            out.append(body.substr(copyStart, start - copyStart));
+            out.append(args[p]);
+            copyStart = i;
+            break;
+        }
+    }
+    out.append(body.substr(copyStart));
+}
+
+// appends text with macros expanded to the output, returns false (without appending) if nothing was expanded
+static bool expandText(std::string_view text, std::string& out, const macrodef_map& macroMap, std::vector<const Macrodef*>& activeMacros, const ErrInfo& err) {
+    bool hasExpanded = false;
+    size_t copyStart = 0; // start of the text not yet appended
+    size_t i = 0;
+    while (i < text.size()) {
+        // skip literals and comments
+        if (text[i] == '"' || text[i] == '\'') {
+            i = skipQuotedLiteral(text, i);
+            continue;
+        } else if (text.compare(i, 2, "//") == 0) {
+            break;
+        } else if (text.compare(i, 2, "/*") == 0) {
+            const size_t closeIndex = text.find("*/", i+2);
+            if (closeIndex == std::string_view::npos) break;
+            i = closeIndex + 2;
+            continue;
+        } else if (!isCharValidIdentifier(text[i])) {
+            i++;
+            continue;
         }
+
+        // scan each word once and look it up (words starting with a digit are literals)
+        const size_t start = i;
+        while (++i < text.size() && isCharValidIdentifier(text[i]));
+        if (std::isdigit(text[start])) continue;
+
+        auto macroIt = macroMap.find(text.substr(start, i - start));
+        if (macroIt == macroMap.end()) continue;
+
+        // a macro isn't expanded again inside its own expansion
+        const Macrodef& macro = macroIt->second;
+        if (std::find(activeMacros.begin(), activeMacros.end(), &macro) != activeMacros.end()) continue;
+
+        std::string substituted;
+        std::string_view replacement = macro.body;
+        size_t end = i;
+        if (macro.isFunctionLike) {
+            // a function-like macro's name on its own is left alone
+            const size_t openIndex = text.find_first_not_of(WHITESPACE_CHARS, i);
+            if (openIndex == std::string_view::npos || text[openIndex] != '(') continue;
+
+            std::vector<std::string_view> rawArgs;
+            end = splitMacroArgs(text, openIndex, rawArgs, err);
+            if (rawArgs.size() != macro.params.size())
+                throw TInvalidMacroInvocationException(err);
+
+            // arguments are fully expanded before they're substituted
+            std::vector<std::string> args(rawArgs.size());
+            for (size_t a = 0; a < rawArgs.size(); a++)
+                if (!expandText(rawArgs[a], args[a], macroMap, activeMacros, err))
+                    args[a] = rawArgs[a];
+
+            substituteMacroArgs(macro, args, substituted);
+            replacement = substituted;
+        }
+
+        // rescan the replacement for other macros
+        out.append(text.substr(copyStart, start - copyStart));
+        activeMacros.push_back(&macro);
+        if (!expandText(replacement, out, macroMap, activeMacros, err))
+            out.append(replacement);
+        activeMacros.pop_back();
+
+        copyStart = i = end;
+        hasExpanded = true;
     }
-}
\ No newline at end of file
+
+    if (hasExpanded) out.append(text.substr(copyStart));
+    return hasExpanded;
+}
+
+// expands macros in a line from the offset onward, returns false if there were none (the output is then meaningless)
+bool expandMacrodefs(std::string_view line, std::string& out, const macrodef_map& macroMap, const ErrInfo& err, size_t offset) {
+    std::vector<const Macrodef*> activeMacros;
+    out.assign(line.substr(0, offset));
+    return expandText(line.substr(offset), out, macroMap, activeMacros, err);
+}
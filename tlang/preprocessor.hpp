@@ -2,9 +2,10 @@
 #define __PREPROCESSOR_HPP
 
 #include <filesystem>
-#include <map>
 #include <stack>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "../util/globals.hpp"
@@ -12,12 +13,22 @@
 #include "util/token.hpp"
 #include "util/t_exception.hpp"
 
+// a #define, function-like macros substitute their arguments for the parameters in the body
+struct Macrodef {
+    std::vector<std::string> params;
+    std::string body;
+    bool isFunctionLike;
+};
+
 // preprocesses a given document
-typedef std::map<std::string, std::string> macrodef_map;
+typedef std::unordered_map<std::string_view, Macrodef> macrodef_map; // keyed on interned names
 typedef std::stack<std::filesystem::path> cwd_stack;
 
 bool preprocessLine(std::string, macrodef_map&, std::vector<Token>&, cwd_stack&, const ErrInfo);
 
-void replaceMacrodefs(std::string&, macrodef_map&, size_t=0);
+bool expandMacrodefs(std::string_view, std::string&, const macrodef_map&, const ErrInfo&, size_t=0);
+
+// the macros every document starts with, defined by the compiler from the emulator's settings
+macrodef_map getPredefinedMacrodefs();
 
 #endif
\ No newline at end of file
@@ -10,6 +10,9 @@
 #define EXIT_SUCCESS 0
 #define EXIT_FAILURE 1
 
+// CLOCKS_PER_SEC (TPU clock cycles per second) is predefined by TCC from the emulator's CLOCK_FREQ_HZ,
+// as an unsigned int since it's too large for a signed one
+
 // shorthand types
 #define uint_16 unsigned int
 #define int_16 signed int
@@ -41,6 +44,30 @@ void free(const void* addr) {
     asm("syscall");         // invoke kernel malloc function
 }
 
+/********* TIMING FUNCTIONS *********/
+
+// Returns the lower 16 bits of the number of clock cycles elapsed since the program started.
+unsigned int clock() {
+    asm("movw AX, 0x07");   // specify syscall type
+    asm("syscall");         // invoke kernel clock function (cycles in DX:AX)
+    return __read_AX();     // return the lower word
+}
+
+// Writes the full 32-bit clock cycle count to cycles (cycles[0] = lower word, cycles[1] = upper word).
+void clock32(unsigned int* cycles) {
+    asm("movw AX, 0x07");   // specify syscall type
+    asm("syscall");         // invoke kernel clock function (cycles in DX:AX)
+    unsigned int lower = __read_AX();
+    unsigned int upper = __read_DX();
+    cycles[0] = lower;
+    cycles[1] = upper;
+}
+
+// Returns the number of clock cycles elapsed since start, a previous value of clock() (spans must be under 65536 cycles).
+unsigned int clock_since(const unsigned int start) {
+    return clock() - start;
+}
+
 /********* CHAR-RELATED FUNCTIONS *********/
 
 int isspace(const char c) {
@@ -0,0 +1,279 @@
+#include "strength_reduction.hpp"
+#include "../cycle_table.hpp"
+#include "../tpu.hpp"
+
+// the emulator's instruction costs used to pick between sequences
+static CycleTable cycleTable;
+
+// an instruction sequence along with its estimated cost
+class CostedSeq {
+    public:
+        CostedSeq() : blocks(1) {};
+
+        void add(const IRInst& inst, const u8 opcode, const u16 mod) {
+            blocks.back().insts.push_back(inst);
+            cycles += cycleTable.getCost(opcode, mod);
+        };
+        void addLabel(const std::string& label) { blocks.push_back(IRBlock(label)); };
+        void append(const CostedSeq& seq) {
+            blocks.back().insts.insert(blocks.back().insts.end(), seq.blocks[0].insts.begin(), seq.blocks[0].insts.end());
+            blocks.insert(blocks.end(), seq.blocks.begin()+1, seq.blocks.end());
+            cycles += seq.cycles;
+        };
+
+        inst_seq_t blocks;
+        unsigned int cycles = 0;
+};
+
+// overrides the default instruction costs with an emulator cycle profile (throws std::invalid_argument)
+void loadCycleProfile(const std::string& path) {
+    cycleTable.loadProfile(path);
+}
+
+/************************ HELPERS ************************/
+
+// returns the 8 or 16-bit register for a register letter
+static IROperand getReg(const char reg, const size_t size) {
+    return IROperand::makeReg(std::string(1, reg) + (size == 2 ? 'X' : 'L'));
+}
+
+static IROperand getImm(const unsigned int value) {
+    return IROperand::makeImm(value);
+}
+
+// returns the MOD byte of a reg, imm (ex. add) or reg, reg (ex. add) ALU instruction
+static u16 getALUMod(const size_t size, const bool isRegOperand) {
+    return (isRegOperand ? 2 : 0) | (size == 2 ? 1 : 0);
+}
+
+// adds a register to register move
+static void addMove(CostedSeq& seq, const char dest, const char src, const size_t size) {
+    if (size == 2) seq.add(IRInst(IROpcode::MOVW, getReg(dest, 2), getReg(src, 2)), OPCode::MOVW, 1);
+    else           seq.add(IRInst(IROpcode::MOV, getReg(dest, 1), getReg(src, 1)), OPCode::MOV, 4);
+}
+
+// adds an 8/16-bit register to register or register to immediate ALU instruction
+static void addALU(CostedSeq& seq, const IROpcode op, const u8 opcode, const char reg, const IROperand& operand, const size_t size) {
+    const bool isRegOperand = operand.type == IROperandType::REG;
+    seq.add(IRInst(op, getReg(reg, size), operand), opcode, getALUMod(size, isRegOperand));
+}
+
+// returns the cost of loading a constant into a register and using MUL/DIV on it
+static unsigned int getMulDivCost(const u8 opcode, const size_t size, const bool isSigned) {
+    return cycleTable.getCost(OPCode::MOVW, 0) + cycleTable.getCost(opcode, (size == 2 ? 3 : 2) | (isSigned ? 8 : 0));
+}
+
+// returns log2 of a power of two, or -1 if the value isn't one
+static int getPowerOfTwo(const unsigned int value) {
+    if (value == 0 || (value & (value - 1)) != 0) return -1;
+
+    int power = 0;
+    while ((value >> power) != 1) ++power;
+    return power;
+}
+
+/************************ MULTIPLICATION ************************/
+
+// returns the binary or signed-digit (non-adjacent form) digits of a constant, lowest first
+static std::vector<int> getDigits(unsigned int constant, const bool isSignedDigits) {
+    std::vector<int> digits;
+    while (constant > 0) {
+        int digit = constant & 1;
+        if (isSignedDigits && digit) digit = 2 - (constant & 3); // ...01 is 1 & ...11 is -1
+        digits.push_back(digit);
+        constant = (constant - digit) >> 1;
+    }
+    return digits;
+}
+
+// builds reg *= constant from shifts & adds/subs (Horner's method over the digits), keeping the operand in scratchReg
+static CostedSeq buildShiftAdd(const std::vector<int>& digits, const char reg, const char scratchReg, const size_t size, bool keepOperand) {
+    const IROperand regOperand = getReg(reg, size);
+    const IROperand scratchOperand = getReg(scratchReg, size);
+    const u16 shiftMod = size == 2 ? 1 : 0;
+
+    size_t numNonzero = 0;
+    for (int digit : digits) numNonzero += digit != 0;
+
+    CostedSeq seq;
+    if (keepOperand || numNonzero > 1) addMove(seq, scratchReg, reg, size);
+
+    // the highest digit is always 1, so start from the operand itself
+    size_t numShifts = 0;
+    for (size_t i = digits.size()-1; i-- > 0;) {
+        ++numShifts;
+        if (digits[i] == 0) continue;
+
+        seq.add(IRInst(IROpcode::SHL, regOperand, getImm(numShifts)), OPCode::SHL, shiftMod);
+        if (digits[i] > 0) addALU(seq, IROpcode::ADD, OPCode::ADD, reg, scratchOperand, size);
+        else               addALU(seq, IROpcode::SUB, OPCode::SUB, reg, scratchOperand, size);
+        numShifts = 0;
+    }
+
+    if (numShifts > 0)
+        seq.add(IRInst(IROpcode::SHL, regOperand, getImm(numShifts)), OPCode::SHL, shiftMod);
+    return seq;
+}
+
+// builds the cheapest shift/add sequence for reg *= constant
+static CostedSeq buildMul(const unsigned int constant, const char reg, const char scratchReg, const size_t size, bool keepOperand) {
+    CostedSeq seq;
+    if (constant == 0) {
+        addALU(seq, IROpcode::XOR, OPCode::XOR, reg, getReg(reg, size), size);
+        return seq;
+    }
+
+    CostedSeq binarySeq = buildShiftAdd(getDigits(constant, false), reg, scratchReg, size, keepOperand);
+    CostedSeq signedSeq = buildShiftAdd(getDigits(constant, true), reg, scratchReg, size, keepOperand);
+    return signedSeq.cycles < binarySeq.cycles ? signedSeq : binarySeq;
+}
+
+// builds reg *= constant (8 or 16-bit) using the scratch register, returns false if MUL is cheaper
+bool reduceMulByConstant(inst_seq_t& insts, const char reg, const char scratchReg, unsigned int constant, const size_t size, const bool isSigned) {
+    constant &= size == 2 ? 0xFFFF : 0xFF;
+
+    // 16-bit smul sets the sign of the result from the full product (see assembleExpression), which only has a
+    // cheap equivalent for positive constants (the product's sign is then the operand's sign)
+    const bool hasSignFixup = isSigned && size == 2;
+    if (hasSignFixup && constant > 0x7FFF) return false;
+
+    unsigned int mulCost = getMulDivCost(OPCode::MUL, size, isSigned);
+    if (hasSignFixup) {
+        mulCost += cycleTable.getCost(OPCode::POP, 0) + cycleTable.getCost(OPCode::MOV, 4) + cycleTable.getCost(OPCode::AND, 0) +
+            cycleTable.getCost(OPCode::OR, 2) + cycleTable.getCost(OPCode::PUSH, 0);
+    }
+
+    CostedSeq seq = buildMul(constant, reg, scratchReg, size, hasSignFixup && constant > 1);
+    if (hasSignFixup && constant > 1) {
+        addALU(seq, IROpcode::AND, OPCode::AND, scratchReg, getImm(32768), size);
+        addALU(seq, IROpcode::OR, OPCode::OR, reg, getReg(scratchReg, size), size);
+    }
+
+    if (seq.cycles >= mulCost) return false;
+    insts = seq.blocks;
+    return true;
+}
+
+/************************ DIVISION ************************/
+
+// finds the magic multiplier & extra shift such that (n * multiplier) >> (bits + shift) == n / divisor for every n <= maxDividend
+static bool findMagicNumber(const unsigned int divisor, const size_t bits, const unsigned int maxDividend, unsigned int& multiplier, size_t& shift) {
+    for (shift = 0; shift <= bits; ++shift) {
+        const u64 scale = (u64)1 << (bits + shift);
+        const u64 magic = (scale + divisor - 1) / divisor;
+        if (magic >= ((u64)1 << bits)) return false; // only gets larger from here
+
+        bool isExact = true;
+        for (u64 n = 0; n <= maxDividend && isExact; ++n)
+            isExact = ((n * magic) >> (bits + shift)) == n / divisor;
+
+        if (isExact) {
+            multiplier = (unsigned int)magic;
+            return true;
+        }
+    }
+    return false;
+}
+
+// builds an unsigned AX/AL / constant from the high half of a multiplication (with the remainder via multiply & subtract)
+static bool buildMulHigh(CostedSeq& seq, const unsigned int constant, const size_t size, const bool isMod) {
+    const size_t bits = size * 8;
+    const unsigned int mask = size == 2 ? 0xFFFF : 0xFF;
+    const IROperand regA = getReg('A', size);
+
+    // divide out even factors with a shift first
+    size_t preShift = 0;
+    while (((constant >> preShift) & 1) == 0) ++preShift;
+
+    unsigned int multiplier;
+    size_t postShift;
+    if (!findMagicNumber(constant >> preShift, bits, mask >> preShift, multiplier, postShift)) return false;
+
+    // keep the dividend for the remainder
+    if (isMod) addMove(seq, 'C', 'A', size);
+    if (preShift > 0) seq.add(IRInst(IROpcode::SHR, regA, getImm(preShift)), OPCode::SHR, size == 2 ? 1 : 0);
+
+    // mul puts the high half in DX (16-bit) or AH (8-bit)
+    seq.add(IRInst(IROpcode::MOVW, getReg('B', 2), getImm(multiplier)), OPCode::MOVW, 0);
+    if (size == 2) {
+        seq.add(IRInst(IROpcode::MUL, getReg('B', 2)), OPCode::MUL, 3);
+        seq.add(IRInst(IROpcode::MOVW, getReg('A', 2), getReg('D', 2)), OPCode::MOVW, 1);
+        if (postShift > 0) seq.add(IRInst(IROpcode::SHR, getReg('A', 2), getImm(postShift)), OPCode::SHR, 1);
+    } else {
+        seq.add(IRInst(IROpcode::MUL, getReg('B', 1)), OPCode::MUL, 2);
+        seq.add(IRInst(IROpcode::SHR, getReg('A', 2), getImm(8 + postShift)), OPCode::SHR, 1);
+    }
+
+    // remainder = dividend - quotient * constant
+    if (isMod) {
+        CostedSeq mulSeq = buildMul(constant, 'A', 'B', size, false);
+        if (mulSeq.cycles >= getMulDivCost(OPCode::MUL, size, false)) {
+            mulSeq = CostedSeq();
+            mulSeq.add(IRInst(IROpcode::MOVW, getReg('B', 2), getImm(constant)), OPCode::MOVW, 0);
+            mulSeq.add(IRInst(IROpcode::MUL, getReg('B', size)), OPCode::MUL, size == 2 ? 3 : 2);
+        }
+        seq.append(mulSeq);
+        addALU(seq, IROpcode::SUB, OPCode::SUB, 'C', regA, size);
+        addMove(seq, 'A', 'C', size);
+    }
+    return true;
+}
+
+// builds a signed AX/AL / or % a power of two, which rounds towards zero like sdiv (operates on the magnitude)
+static void buildSignedPow2(CostedSeq& seq, const unsigned int constant, const size_t size, const bool isMod, size_t& nextJMPLabelID) {
+    const IROperand regA = getReg('A', size);
+    const u16 mod = size == 2 ? 1 : 0;
+    const std::string labelPositive = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
+    const std::string labelMerge = JMP_LABEL_PREFIX + std::to_string(nextJMPLabelID++);
+
+    CostedSeq opSeq;
+    if (isMod) addALU(opSeq, IROpcode::AND, OPCode::AND, 'A', getImm(constant - 1), size);
+    else       opSeq.add(IRInst(IROpcode::SHR, regA, getImm(getPowerOfTwo(constant))), OPCode::SHR, mod);
+
+    // check the sign bit
+    addMove(seq, 'C', 'A', size);
+    addALU(seq, IROpcode::AND, OPCode::AND, 'C', getImm(size == 2 ? 32768 : 128), size);
+    seq.add(IRInst(IROpcode::JZ, IROperand::makeLabel(labelPositive)), OPCode::JMP, 1);
+
+    // negative, so negate, operate & negate back
+    seq.add(IRInst(IROpcode::NOT, regA), OPCode::NOT, mod);
+    addALU(seq, IROpcode::ADD, OPCode::ADD, 'A', getImm(1), size);
+    seq.append(opSeq);
+    seq.add(IRInst(IROpcode::NOT, regA), OPCode::NOT, mod);
+    addALU(seq, IROpcode::ADD, OPCode::ADD, 'A', getImm(1), size);
+    seq.add(IRInst(IROpcode::JMP, IROperand::makeLabel(labelMerge)), OPCode::JMP, 0);
+
+    // positive
+    seq.addLabel(labelPositive);
+    seq.append(opSeq);
+    seq.addLabel(labelMerge);
+    seq.cycles += cycleTable.branchTakenCycles;
+}
+
+// builds AX/AL /= or %= constant (8 or 16-bit) using BX, CX & DX, returns false if DIV is cheaper
+bool reduceDivByConstant(inst_seq_t& insts, unsigned int constant, const size_t size, const bool isSigned, const bool isMod, size_t& nextJMPLabelID) {
+    const unsigned int signBit = size == 2 ? 0x8000 : 0x80;
+    constant &= size == 2 ? 0xFFFF : 0xFF;
+    if (constant == 0) return false; // leave the fault to runtime
+
+    const int power = getPowerOfTwo(constant);
+    const IROperand regA = getReg('A', size);
+
+    CostedSeq seq;
+    if (constant == 1) {
+        if (isMod) addALU(seq, IROpcode::XOR, OPCode::XOR, 'A', regA, size);
+    } else if (isSigned) {
+        // only positive powers of two
+        if (power == -1 || constant >= signBit) return false;
+        buildSignedPow2(seq, constant, size, isMod, nextJMPLabelID);
+    } else if (power != -1) {
+        if (isMod) addALU(seq, IROpcode::AND, OPCode::AND, 'A', getImm(constant - 1), size);
+        else       seq.add(IRInst(IROpcode::SHR, regA, getImm(power)), OPCode::SHR, size == 2 ? 1 : 0);
+    } else if (!buildMulHigh(seq, constant, size, isMod)) {
+        return false;
+    }
+
+    if (seq.cycles >= getMulDivCost(OPCode::DIV, size, isSigned)) return false;
+    insts = seq.blocks;
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef __STRENGTH_REDUCTION_HPP
+#define __STRENGTH_REDUCTION_HPP
+
+#include <string>
+#include <vector>
+
+#include "ir/ir.hpp"
+
+/**
+ * Lowers multiplication, division and modulo by constants into cheaper shift/add, AND and multiply-high
+ * sequences. Every sequence is costed with the emulator's cycle table and is only used when it beats the
+ * MUL/DIV it replaces, and always produces the exact same bits the MUL/DIV would.
+ *
+ * Operands are in AX (or AL with AH cleared) and sequences leave their result in that same register.
+ */
+
+// a sequence of instructions (split into blocks at its labels) that replaces a MUL/DIV
+typedef std::vector<IRBlock> inst_seq_t;
+
+// overrides the default instruction costs with an emulator cycle profile (throws std::invalid_argument)
+void loadCycleProfile(const std::string&);
+
+// builds reg *= constant (8 or 16-bit) using the scratch register, returns false if MUL is cheaper
+bool reduceMulByConstant(inst_seq_t&, const char reg, const char scratchReg, unsigned int constant, const size_t size, const bool isSigned);
+
+// builds AX/AL /= or %= constant (8 or 16-bit) using BX, CX & DX, returns false if DIV is cheaper
+bool reduceDivByConstant(inst_seq_t&, unsigned int constant, const size_t size, const bool isSigned, const bool isMod, size_t& nextJMPLabelID);
+
+#endif
@@ -3,8 +3,15 @@
 
 // constants for the entire program
 #define FUNC_MAIN_NAME "main"
+#define INLINE_NODE_BUDGET 16 // leaf functions with at most this many AST nodes are inlined without the inline keyword
 
 inline bool DELETE_UNUSED_VARIABLES;
 inline bool DELETE_UNUSED_FUNCTIONS;
+inline bool RUN_IR_PASSES;
+inline bool PRINT_PASS_STATS;
+inline bool INLINE_FUNCTIONS;
+inline bool USE_FASTCALL;
+inline bool TAIL_CALLS;
+inline bool ALLOCATE_REGISTERS;
 
 #endif
\ No newline at end of file
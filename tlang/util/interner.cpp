@@ -0,0 +1,31 @@
+#include <deque>
+#include <unordered_map>
+
+#include "interner.hpp"
+
+// strings are kept in a deque so the views used as keys (& references handed out) are never invalidated
+static std::deque<std::string>& getSymbolNames() {
+    static std::deque<std::string> names;
+    return names;
+}
+
+static std::unordered_map<std::string_view, symbol_t>& getSymbolTable() {
+    static std::unordered_map<std::string_view, symbol_t> table;
+    return table;
+}
+
+symbol_t internSymbol(std::string_view str) {
+    std::unordered_map<std::string_view, symbol_t>& table = getSymbolTable();
+    auto itr = table.find(str);
+    if (itr != table.end()) return itr->second;
+
+    std::deque<std::string>& names = getSymbolNames();
+    const symbol_t id = names.size();
+    names.emplace_back(str);
+    table.emplace(names.back(), id);
+    return id;
+}
+
+const std::string& getSymbolName(symbol_t id) {
+    return getSymbolNames()[id];
+}
@@ -0,0 +1,17 @@
+#ifndef __INTERNER_HPP
+#define __INTERNER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// a compilation-wide ID for an interned string (identifiers, keywords, literals & filenames)
+typedef uint32_t symbol_t;
+
+// returns the ID of a string, interning it the first time it's seen
+symbol_t internSymbol(std::string_view);
+
+// returns the interned text of an ID, which lives for the rest of the compilation
+const std::string& getSymbolName(symbol_t);
+
+#endif
@@ -1,28 +1,20 @@
 #include "scope.hpp"
 #include "t_exception.hpp"
 
-bool Scope::doesVarExist(const std::string& name) const {
-    for (ScopeAddr* pVar : this->children)
-        if (pVar->isAllocated && pVar->name == name) return true;
-
-    // base case, does not exist
-    return false;
-}
-
-size_t Scope::declareVariable(Type type, const std::string& name, ErrInfo err) {
+size_t Scope::declareVariable(Type type, symbol_t name, ErrInfo err) {
     if (this->doesVarExist(name))
         throw TIdentifierInUseException(err);
-    ScopeAddr* pVar = new ScopeAddr(type, name);
-    this->children.push_back(pVar);
+
+    symbols.emplace(name, slots.size());
+    slots.emplace_back(type, name, depth);
 
     size_t size = type.getSizeBytes();
-    for (size_t i = 0; i < size-1; i++) // add remaining placeholders
-        this->addPlaceholder();
+    depth += size;
     return size;
 }
 
 // handles any array as a pointer
-size_t Scope::declareFunctionParam(Type type, const std::string& name, ErrInfo err) {
+size_t Scope::declareFunctionParam(Type type, symbol_t name, ErrInfo err) {
     if (type.isArray()) {
         // force as reference
         type.setIsReferencePointer(true);
@@ -33,41 +25,46 @@ size_t Scope::declareFunctionParam(Type type, const std::string& name, ErrInfo e
     return declareVariable(type, name, err);
 }
 
-// pops the last variable off the stack's scope, returning the number of bytes freed
+// hands a variable's slot over to a new variable of the same size
+void Scope::renameVariable(symbol_t oldName, Type type, symbol_t newName, ErrInfo err) {
+    if (this->doesVarExist(newName))
+        throw TIdentifierInUseException(err);
+
+    ScopeAddr* pVar = this->getVariable(oldName, err);
+    symbols.emplace(newName, symbols.at(oldName));
+    symbols.erase(oldName);
+    pVar->name = newName;
+    pVar->type = type;
+}
+
+// pops the last byte off the stack's scope, returning the number of bytes freed
 size_t Scope::pop() {
-    delete *this->children.rbegin();
-    this->children.pop_back();
+    this->pop(1);
     return 1;
 }
 
+// pops bytes off the stack's scope, forgetting any variables that were in them
 void Scope::pop(size_t n) {
-    for (size_t i = 0; i < n; ++i)
-        pop();
+    depth -= n;
+    while (slots.size() > 0 && slots.back().index >= depth) {
+        symbols.erase(slots.back().name);
+        slots.pop_back();
+    }
 }
 
 // gets the offset address from the end with respect to the rest of the variables below it of a certain variable
-size_t Scope::getOffset(const std::string& name, ErrInfo err) const {
-    size_t offset = 0;
+size_t Scope::getOffset(symbol_t name, ErrInfo err) const {
+    auto itr = symbols.find(name);
+    if (itr == symbols.end())
+        throw TUnknownIdentifierException(err);
 
-    for (long i = children.size()-1; i >= 0; i--) {
-        ScopeAddr* pVar = children[i];
-        offset++;
-        if (pVar->isAllocated && pVar->name == name) return offset;
-    }
-
-    // base case, not found
-    throw TUnknownIdentifierException(err);
+    return depth - slots[itr->second].index;
 }
 
-ScopeAddr* Scope::getVariable(const std::string& name, ErrInfo err) const {
-    for (ScopeAddr* pVar : this->children)
-        if (pVar->isAllocated && pVar->name == name) return pVar;
+ScopeAddr* Scope::getVariable(symbol_t name, ErrInfo err) {
+    auto itr = symbols.find(name);
+    if (itr == symbols.end())
+        throw TUnknownIdentifierException(err);
 
-    // base case, not found
-    throw TUnknownIdentifierException(err);
+    return &slots[itr->second];
 }
-
-void Scope::addPlaceholder(size_t n) {
-    for (size_t i = 0; i < n; ++i)
-        children.push_back(new ScopeAddr());
-}
\ No newline at end of file
@@ -1,46 +1,44 @@
 #ifndef __SCOPE_HPP
 #define __SCOPE_HPP
 
-#include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "interner.hpp"
 #include "type.hpp"
 #include "t_exception.hpp"
 
-#define SCOPE_RETURN_START "0" // identifier cannot be named 0 so this is just a cheeky workaround
-
-// fwd declaration
-class Scope;
+#define SCOPE_RETURN_START internSymbol("0") // identifier cannot be named 0 so this is just a cheeky workaround
 
+// a named variable's slot on the stack
 class ScopeAddr {
     public:
-        friend Scope;
-
-        ScopeAddr() : name(""), type(), isAllocated(false) {};
-        ScopeAddr(Type type, const std::string& name) : name(name), type(type), isAllocated(true) {};
+        ScopeAddr(Type type, symbol_t name, size_t index) : name(name), type(type), index(index) {};
 
-        std::string name;
+        symbol_t name;
         Type type;
-        bool isAllocated; // true if taken by a variable, false otherwise (if a placeholder)
+        size_t index; // byte position of the variable's lowest byte from the bottom of the frame
 };
 
 // used to manage the addresses of assembled variables in the given scope
+// only the frame's depth in bytes is tracked for unnamed bytes (ie. expression results), variables are hashed by name
 class Scope {
     public:
-        ~Scope() { for (ScopeAddr* pVar : children) delete pVar; }
-
-        bool doesVarExist(const std::string&) const;
-        size_t declareVariable(Type, const std::string&, ErrInfo);
-        size_t declareFunctionParam(Type, const std::string&, ErrInfo);
+        bool doesVarExist(symbol_t name) const { return symbols.count(name) > 0; };
+        size_t declareVariable(Type, symbol_t, ErrInfo);
+        size_t declareFunctionParam(Type, symbol_t, ErrInfo);
+        void renameVariable(symbol_t, Type, symbol_t, ErrInfo);
         size_t pop();
         void pop(size_t);
-        size_t size() const { return children.size(); }
-        size_t getOffset(const std::string&, ErrInfo) const;
-        ScopeAddr* getVariable(const std::string&, ErrInfo) const;
+        size_t size() const { return depth; }
+        size_t getOffset(symbol_t, ErrInfo) const;
+        ScopeAddr* getVariable(symbol_t, ErrInfo); // valid until the next variable is declared
 
-        void addPlaceholder(size_t=1);
+        void addPlaceholder(size_t n=1) { depth += n; };
     private:
-        std::vector<ScopeAddr*> children;
+        size_t depth = 0;
+        std::vector<ScopeAddr> slots; // variables in the order they're declared (and so, by index)
+        std::unordered_map<symbol_t, size_t> symbols; // variable name to its position in slots
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -12,8 +12,9 @@ ParserScope::~ParserScope() {
     for (auto [name, pVar] : variables)
         delete pVar;
 
-    for (auto [name, pFunc] : functions)
-        delete pFunc;
+    for (auto& [name, overloads] : functions)
+        for (ParserFunction* pFunc : overloads)
+            delete pFunc;
 }
 
 // removes the current referenced node from the parent
@@ -48,7 +49,7 @@ int ParserFunction::doParamsMatch(const std::vector<Type>& paramsB, const ErrInf
 }
 
 // lookup variable from scope stack
-ParserVariable* lookupParserVariable(scope_stack_t& scopeStack, const std::string& name, ErrInfo err) {
+ParserVariable* lookupParserVariable(scope_stack_t& scopeStack, symbol_t name, ErrInfo err) {
     // look in the stack, up
     auto itr = scopeStack.rbegin();
     for ((void)itr; itr != scopeStack.rend(); ++itr) {
@@ -66,18 +67,19 @@ ParserVariable* lookupParserVariable(scope_stack_t& scopeStack, const std::strin
 }
 
 // lookup function from scope stack
-ParserFunction* lookupParserFunction(scope_stack_t& scopeStack, const std::string& name, ErrInfo err, const std::vector<Type>& paramTypes, int& status) {
+ParserFunction* lookupParserFunction(scope_stack_t& scopeStack, symbol_t name, ErrInfo err, const std::vector<Type>& paramTypes, int& status) {
     // look in global scope
     ParserScope* pScope = scopeStack[0];
 
+    // verify a function exists with that name
+    auto overloadsItr = pScope->functions.find(name);
+    if (overloadsItr == pScope->functions.end() || overloadsItr->second.size() == 0)
+        throw TUnknownFunctionException(err);
+
     // search functions in global scope
     std::vector<ParserFunction*> implicitMatches;
-    bool hasMatchingFunction = false;
-    auto range = pScope->functions.equal_range(name);
-    for (auto itr = range.first; itr != range.second; ++itr) {
+    for (ParserFunction* pParserFunc : overloadsItr->second) {
         // check parameters
-        hasMatchingFunction = true;
-        ParserFunction* pParserFunc = itr->second;
         int matchStatus = pParserFunc->doParamsMatch(paramTypes, err);
         if (matchStatus == TYPE_PARAM_EXACT_MATCH) {
             pParserFunc->isUnused = false;
@@ -89,10 +91,6 @@ ParserFunction* lookupParserFunction(scope_stack_t& scopeStack, const std::strin
         }
     }
 
-    // verify a function exists with that name
-    if (!hasMatchingFunction)
-        throw TUnknownFunctionException(err);
-
     // check for any implicit matches
     if (implicitMatches.size() == 0)
         throw TFunctionParameterMismatchException(err);
@@ -107,7 +105,7 @@ ParserFunction* lookupParserFunction(scope_stack_t& scopeStack, const std::strin
 }
 
 // declare a variable in the immediate scope
-void declareParserVariable(scope_stack_t& scopeStack, const std::string& name, ParserVariable* pParserVar, ErrInfo err) {
+void declareParserVariable(scope_stack_t& scopeStack, symbol_t name, ParserVariable* pParserVar, ErrInfo err) {
     // verify this variable isn't already defined in the immediate scope
     ParserScope* pScope = scopeStack.back();
     if (pScope->isVarNameTaken(name))
@@ -118,18 +116,18 @@ void declareParserVariable(scope_stack_t& scopeStack, const std::string& name, P
 }
 
 // declare a function in the immediate scope
-void declareParserFunction(scope_stack_t& scopeStack, const std::string& name, ParserFunction* pParserFunc, const std::vector<Type>& paramTypes, ErrInfo err) {
+void declareParserFunction(scope_stack_t& scopeStack, symbol_t name, ParserFunction* pParserFunc, const std::vector<Type>& paramTypes, ErrInfo err) {
     // verify this function isn't already defined in the global scope
     ParserScope* pScope = scopeStack[0];
 
     // search functions in global scope
-    auto range = pScope->functions.equal_range(name);
-    for (auto itr = range.first; itr != range.second; ++itr)
-        if (itr->second->doParamsMatch(paramTypes, err) == TYPE_PARAM_EXACT_MATCH) // check parameters
+    std::vector<ParserFunction*>& overloads = pScope->functions[name];
+    for (ParserFunction* pOverload : overloads)
+        if (pOverload->doParamsMatch(paramTypes, err) == TYPE_PARAM_EXACT_MATCH) // check parameters
             throw TIdentifierInUseException(err);
 
     // declare function
-    pScope->functions.insert({name, pParserFunc});
+    overloads.push_back(pParserFunc);
 }
 
 // used to pop off a scope stack
@@ -147,9 +145,10 @@ void popScopeStack(scope_stack_t& scopeStack) {
 
     // remove unused functions
     if (DELETE_UNUSED_FUNCTIONS) {
-        for (auto [name, pParserFunc] : pScope->functions) {
-            if (pParserFunc->isUnused)
-                pParserFunc->remove(); // remove from AST
+        for (auto& [name, overloads] : pScope->functions) {
+            for (ParserFunction* pParserFunc : overloads)
+                if (pParserFunc->isUnused)
+                    pParserFunc->remove(); // remove from AST
         }
     }
 
@@ -1,10 +1,10 @@
 #ifndef __SCOPE_STACK_HPP
 #define __SCOPE_STACK_HPP
 
-#include <map>
-#include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "interner.hpp"
 #include "type.hpp"
 #include "t_exception.hpp"
 
@@ -26,6 +26,10 @@ class ParserVariable {
         bool isUnused = true;
         ASTNode* pParent;
         void* pVarDecNode;
+
+        // for const variables with constant initializers (propagated by constant folding)
+        bool hasConstValue = false;
+        int constValue = 0;
 };
 
 class ParserFunction {
@@ -51,29 +55,32 @@ class ParserScope {
     public:
         ~ParserScope();
 
-        bool isNameTaken(const std::string& name) const { return functions.count(name) > 0 || isVarNameTaken(name); };
+        bool isNameTaken(symbol_t name) const { return functions.count(name) > 0 || isVarNameTaken(name); };
 
-        bool isVarNameTaken(const std::string& name) const { return variables.count(name) > 0; };
+        bool isVarNameTaken(symbol_t name) const { return variables.count(name) > 0; };
 
-        ParserVariable* getVariable(const std::string& name) { return isVarNameTaken(name) ? variables[name] : nullptr; };
+        ParserVariable* getVariable(symbol_t name) {
+            auto itr = variables.find(name);
+            return itr != variables.end() ? itr->second : nullptr;
+        };
 
-        std::map<std::string, ParserVariable*> variables;
-        std::multimap<std::string, ParserFunction*> functions;
+        std::unordered_map<symbol_t, ParserVariable*> variables;
+        std::unordered_map<symbol_t, std::vector<ParserFunction*>> functions; // overloads in the order they're declared
 };
 
 typedef std::vector<ParserScope*> scope_stack_t;
 
 // lookup variable from scope stack
-ParserVariable* lookupParserVariable(scope_stack_t&, const std::string&, ErrInfo);
+ParserVariable* lookupParserVariable(scope_stack_t&, symbol_t, ErrInfo);
 
 // lookup function from scope stack
-ParserFunction* lookupParserFunction(scope_stack_t&, const std::string&, ErrInfo, const std::vector<Type>&, int&);
+ParserFunction* lookupParserFunction(scope_stack_t&, symbol_t, ErrInfo, const std::vector<Type>&, int&);
 
 // declare a variable in the immediate scope
-void declareParserVariable(scope_stack_t&, const std::string&, ParserVariable*, ErrInfo);
+void declareParserVariable(scope_stack_t&, symbol_t, ParserVariable*, ErrInfo);
 
 // declare a function in the immediate scope
-void declareParserFunction(scope_stack_t&, const std::string&, ParserFunction*, const std::vector<Type>&, ErrInfo);
+void declareParserFunction(scope_stack_t&, symbol_t, ParserFunction*, const std::vector<Type>&, ErrInfo);
 
 // used to pop off a scope stack
 void popScopeStack(scope_stack_t&);
@@ -4,15 +4,18 @@
 #include <stdexcept>
 #include <string>
 
+#include "interner.hpp"
+
 // for error handling
 typedef unsigned long long line_t; // for line/col numbering
 
 // store where a token is from in its original file
 class ErrInfo {
     public:
-        ErrInfo(line_t line, line_t col, const std::string& file) : line(line), col(col), file(file) {};
+        ErrInfo(line_t line, line_t col, symbol_t file) : line(line), col(col), file(file) {};
+        ErrInfo(line_t line, line_t col, const std::string& file) : line(line), col(col), file(internSymbol(file)) {};
         line_t line, col;
-        const std::string file;
+        symbol_t file;
 };
 
 // shorthand for making exceptions
@@ -30,7 +33,7 @@ class TException {
         virtual const std::string& toString() const { return msg; };
         
         // to get line/col info
-        const std::string getTrace() const { return "\n  " + err.file + ":" + std::to_string(err.line) + ":" + std::to_string(err.col); };
+        const std::string getTrace() const { return "\n  " + getSymbolName(err.file) + ":" + std::to_string(err.line) + ":" + std::to_string(err.col); };
     protected:
         ErrInfo err;
         std::string msg;
@@ -56,6 +59,7 @@ MAKE_EXCEPTION(IllegalImplicitCast)
 MAKE_EXCEPTION(ExpressionEval)
 MAKE_EXCEPTION(IllegalMacroDefinition)
 MAKE_EXCEPTION(InvalidMacroInclude)
+MAKE_EXCEPTION(InvalidMacroInvocation)
 MAKE_EXCEPTION(IllegalVoidUse)
 MAKE_EXCEPTION(ConstQualifierMismatch)
 MAKE_EXCEPTION(ConstAssignment)
@@ -2,7 +2,9 @@
 #define __TOKEN_HPP
 
 #include <string>
+#include <string_view>
 
+#include "interner.hpp"
 #include "t_exception.hpp"
 
 // token types
@@ -14,7 +16,7 @@ enum TokenType {
     BLOCK_COMMENT_START, BLOCK_COMMENT_END,
     COMMA,
 
-    UNSIGNED, SIGNED, CONST,
+    UNSIGNED, SIGNED, CONST, INLINE,
 
     // operators
     OP_LT, OP_LTE, OP_GT, OP_GTE, // <, <=, >, >=
@@ -35,10 +37,11 @@ enum TokenType {
 // Token class for for lexer
 class Token {
     public:
-        Token(ErrInfo err, const std::string& raw, TokenType type): err(err), raw(raw), type(type) {};
-        Token(ErrInfo err, char raw, TokenType type): err(err), raw({raw}), type(type) {};
+        Token(ErrInfo err, std::string_view raw, TokenType type): err(err), id(internSymbol(raw)), raw(getSymbolName(id)), type(type) {};
+        Token(ErrInfo err, char raw, TokenType type): Token(err, std::string_view(&raw, 1), type) {};
         ErrInfo err;
-        const std::string raw;
+        symbol_t id; // the interned text
+        const std::string& raw;
         TokenType type;
 };
 
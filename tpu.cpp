@@ -6,6 +6,7 @@
 
 #include "tpu.hpp"
 #include "instructions.hpp"
+#include "tracer.hpp"
 
 Register getRegisterFromString(const std::string& str) {
     if (str == "AX") return Register::AX;
@@ -42,8 +43,9 @@ void TPU::reset() {
     // clear flags
     FLAGS = 0x0;
 
-    // reset halt flag
+    // reset halt flag & clock
     __hasSuspended = false;
+    cycles = 0;
 }
 
 Byte TPU::readByte(Memory& memory) {
@@ -121,18 +123,20 @@ Byte& TPU::readRegister8(Register reg) {
 void TPU::execute(Memory& memory) {
     // fetch instruction
     Byte instruction = this->readByte(memory);
+    unsigned short opCode = instruction.getValue();
 
-    // wait cycle since TPU has to process the instruction
-    this->sleep();
+    // look up the instruction cost before executing it (syscalls are indexed by code, others by MOD byte)
+    u16 mod = 0;
+    if (opCode == OPCode::SYSCALL) mod = AX.getValue();
+    else if (opCode >= OPCode::JMP) mod = memory[IP.getValue()].getValue();
+    const u16 cost = cycleTable.getCost(opCode, mod);
 
     #define caseInstruction(INST) case OPCode::INST: { \
         instructions::process##INST(*this, memory); \
-        this->sleep(); \
         break; \
     }
 
     // switch on instruction
-    unsigned short opCode = instruction.getValue();
     switch (opCode) {
         case OPCode::NOP: break;
         case OPCode::HLT: {
@@ -141,7 +145,6 @@ void TPU::execute(Memory& memory) {
         }
         case OPCode::SYSCALL: {
             instructions::executeSyscall(*this, memory);
-            this->sleep(); // wait since the TPU has just completed a syscall
             break;
         }
         caseInstruction(CALL)
@@ -168,24 +171,46 @@ void TPU::execute(Memory& memory) {
             throw std::invalid_argument("Invalid or unimplemented instruction code: " + opCode);
     }
 
+    // wait out the instruction's cycles
+    this->addCycles(cost);
+    this->throttle();
+
     // verify the SP is in bounds
     if (SP.getValue() < STACK_LOWER_ADDR || SP.getValue() > STACK_UPPER_ADDR) {
         throw std::runtime_error("Stack over/underflow");
     }
+
+    // record stack depth changes
+    if (isTracing() && SP.getValue() != __lastTracedSP) {
+        __lastTracedSP = SP.getValue();
+        traceRecord(TRACE_COUNTER_SP, cycles, __lastTracedSP - STACK_LOWER_ADDR);
+    }
 }
 
 // starts the clock and runs until a halt instruction is encountered
 void TPU::start(Memory& memory) {
+    __throttleAnchor = std::chrono::steady_clock::now();
+    __throttleAnchorCycles = cycles;
+
     while ( !this->__hasSuspended ) {
         // execute next instruction
         this->execute(memory);
     }
 }
 
-// thread sleep between cycles
-void TPU::sleep() const {
-    const long sleepTime = 1e+6 / this->clockFreq;
-    std::this_thread::sleep_for(std::chrono::microseconds( sleepTime ));
+// thread sleep until the wall clock catches up to the cycle count
+void TPU::throttle() {
+    const auto now = std::chrono::steady_clock::now();
+    const std::chrono::duration<double, std::micro> elapsed( (cycles - __throttleAnchorCycles) * 1e+6 / this->clockFreq );
+    const auto deadline = __throttleAnchor + std::chrono::duration_cast<std::chrono::steady_clock::duration>(elapsed);
+
+    if (now < deadline) {
+        std::this_thread::sleep_until(deadline);
+    } else if (now - deadline > std::chrono::milliseconds(TPU_MAX_CLOCK_DRIFT_MS)) {
+        // fell far behind (ex. blocked on STDIN), so re-anchor instead of bursting to catch up
+        __throttleAnchor = now;
+        __throttleAnchorCycles = cycles;
+    }
 }
 
 // update a specific flag
@@ -1,8 +1,11 @@
 #ifndef __TPU_HPP
 #define __TPU_HPP
 
+#include <chrono>
+
 #include "util/globals.hpp"
 #include "memory.hpp"
+#include "cycle_table.hpp"
 
 // flag macros
 // ref: https://www.geeksforgeeks.org/flag-register-8086-microprocessor/?ref=lbp
@@ -12,6 +15,9 @@
 #define SIGN 7      // set if the result of arithmetic or logical operation is negative
 #define OVERFLOW 11 // set if the result of arithmetic operation overflows/underflows
 
+// how far (in ms) the TPU may fall behind its clock before throttling gives up catching up
+#define TPU_MAX_CLOCK_DRIFT_MS 50
+
 // instruction set opcodes
 enum OPCode {
     NOP         = 0x00,
@@ -59,7 +65,7 @@ enum Register {
 enum Syscall {
     STDOUT      = 0x00,     STDERR      = 0x01,     STDIN       = 0x02,
     EXIT_STATUS = 0x03,     MALLOC      = 0x04,     REALLOC     = 0x05,
-    FREE        = 0x06
+    FREE        = 0x06,     CLOCK       = 0x07
 };
 
 constexpr Register getRegister16FromCode(unsigned short code) {
@@ -124,7 +130,8 @@ class TPU {
         void reset();
         void execute(Memory&);
         void start(Memory&); // for starting/running the clock
-        void sleep() const;
+        void addCycles(u32 n) { cycles += n; };
+        void throttle(); // waits until the host clock catches up to the elapsed cycles
         bool getFlag(u8 flag) const { return (FLAGS.getValue() & (1u << flag)) > 0; };
         void setFlag(u8, bool);
 
@@ -135,9 +142,18 @@ class TPU {
         Word& readRegister16(Register);
         Byte& readRegister8(Register);
         void setExitCode(u16 code) { this->ES = code; };
+        u64 getCycles() const { return cycles; };
+        CycleTable& getCycleTable() { return cycleTable; };
     private:
         int clockFreq;
+        u64 cycles = 0; // the number of clock cycles elapsed since the last reset
+        CycleTable cycleTable; // the cost of each instruction
+
+        // the host time & cycle count that throttling is measured from
+        std::chrono::steady_clock::time_point __throttleAnchor;
+        u64 __throttleAnchorCycles = 0;
         bool __hasSuspended = false; // true when a halt instruction is met
+        u16 __lastTracedSP = 0; // the last SP value sent to the tracer
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "tracer.hpp"
+#include "tpu.hpp"
+
+bool __isTracerRunning = false;
+
+static TraceRingBuffer* pRingBuffer = nullptr;
+static std::thread writerThread;
+static std::atomic<bool> isWriterDone{false};
+static u64 numDropped = 0; // records that didn't fit in the ring buffer (only touched by the emulator thread)
+
+static std::ofstream outHandle;
+static symbol_map_t symbolMap;
+static std::vector<bool> isFuncEntry; // by address, the entries of TCC functions
+static double cycleToMicros = 1; // microseconds per virtual clock cycle
+
+/****************************************************/
+/*                   ring buffer                    */
+/****************************************************/
+
+bool TraceRingBuffer::push(const trace_record_t& record) {
+    const size_t head = this->head.load(std::memory_order_relaxed);
+    if (head - this->tail.load(std::memory_order_acquire) == TRACE_BUFFER_SIZE)
+        return false; // full
+
+    records[head & (TRACE_BUFFER_SIZE-1)] = record;
+    this->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool TraceRingBuffer::pop(trace_record_t& record) {
+    const size_t tail = this->tail.load(std::memory_order_relaxed);
+    if (tail == this->head.load(std::memory_order_acquire))
+        return false; // empty
+
+    record = records[tail & (TRACE_BUFFER_SIZE-1)];
+    this->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+/****************************************************/
+/*                  writer thread                   */
+/****************************************************/
+
+// returns the label name for an address, or the hex address if unknown
+static std::string getSymbolName(u16 addr) {
+    auto it = symbolMap.find(addr);
+    if (it != symbolMap.end()) return it->second;
+
+    std::stringstream sstream;
+    sstream << "0x" << std::hex << std::setw(4) << std::setfill('0') << addr;
+    return sstream.str();
+}
+
+static const char* getSyscallName(u8 code) {
+    switch (code) {
+        case Syscall::STDOUT: return "STDOUT";
+        case Syscall::STDERR: return "STDERR";
+        case Syscall::STDIN: return "STDIN";
+        case Syscall::EXIT_STATUS: return "EXIT_STATUS";
+        case Syscall::MALLOC: return "MALLOC";
+        case Syscall::REALLOC: return "REALLOC";
+        case Syscall::FREE: return "FREE";
+        case Syscall::CLOCK: return "CLOCK";
+        default: return "UNKNOWN";
+    }
+}
+
+// formats a single record as a trace_event JSON object
+static void writeRecord(const trace_record_t& record, bool isFirst) {
+    const double ts = record.cycle * cycleToMicros;
+    if (!isFirst) outHandle << ",\n";
+
+    switch (record.type) {
+        case TRACE_CALL:
+            outHandle << "{\"name\":\"" << getSymbolName(record.a) << "\",\"cat\":\"call\",\"ph\":\"B\",\"ts\":" << ts
+                      << ",\"pid\":1,\"tid\":1,\"args\":{\"ret\":" << record.b << "}}";
+            break;
+        case TRACE_RET:
+            outHandle << "{\"ph\":\"E\",\"ts\":" << ts << ",\"pid\":1,\"tid\":1}";
+            break;
+        case TRACE_TAIL_CALL:
+            // the caller's frame is reused, so its span ends where the callee's begins (and the callee's RET ends that)
+            outHandle << "{\"ph\":\"E\",\"ts\":" << ts << ",\"pid\":1,\"tid\":1},\n";
+            outHandle << "{\"name\":\"" << getSymbolName(record.a) << "\",\"cat\":\"call\",\"ph\":\"B\",\"ts\":" << ts
+                      << ",\"pid\":1,\"tid\":1,\"args\":{\"tail\":true}}";
+            break;
+        case TRACE_SYSCALL: {
+            outHandle << "{\"name\":\"" << getSyscallName(record.code) << "\",\"cat\":\"syscall\",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << ts
+                      << ",\"pid\":1,\"tid\":1,\"args\":{";
+            switch (record.code) {
+                case Syscall::STDOUT: case Syscall::STDERR: case Syscall::STDIN:
+                    outHandle << "\"addr\":" << record.a << ",\"length\":" << record.b; break;
+                case Syscall::EXIT_STATUS:
+                    outHandle << "\"status\":" << (s16)record.a; break;
+                case Syscall::MALLOC:
+                    outHandle << "\"size\":" << record.a << ",\"addr\":" << record.b; break;
+                case Syscall::REALLOC:
+                    outHandle << "\"addr\":" << record.a << ",\"size\":" << record.b << ",\"newAddr\":" << record.c; break;
+                case Syscall::FREE:
+                    outHandle << "\"addr\":" << record.a; break;
+            }
+            outHandle << "}}";
+            break;
+        }
+        case TRACE_COUNTER_SP:
+            outHandle << "{\"name\":\"stack\",\"ph\":\"C\",\"ts\":" << ts << ",\"pid\":1,\"args\":{\"bytes\":" << record.a << "}}";
+            break;
+        case TRACE_COUNTER_HEAP:
+            outHandle << "{\"name\":\"heap\",\"ph\":\"C\",\"ts\":" << ts << ",\"pid\":1,\"args\":{\"bytes\":" << record.a << "}}";
+            break;
+    }
+}
+
+// drains the ring buffer to the output file until the tracer is stopped
+static void runWriter() {
+    trace_record_t record;
+    bool isFirst = true;
+    while (true) {
+        // check for completion before draining so no records are lost after stopping
+        const bool isDone = isWriterDone.load(std::memory_order_acquire);
+
+        while (pRingBuffer->pop(record)) {
+            writeRecord(record, isFirst);
+            isFirst = false;
+        }
+
+        if (isDone) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/****************************************************/
+/*                 tracer interface                 */
+/****************************************************/
+
+void startTracer(const std::string& outPath, const symbol_map_t& symbols, int clockFreq) {
+    if (__isTracerRunning) return;
+
+    outHandle.open(outPath);
+    if (!outHandle.is_open())
+        throw std::runtime_error("Failed to open trace output file: " + outPath);
+
+    symbolMap = symbols;
+    isFuncEntry.assign(0x10000, false);
+    for (auto& symbolPair : symbolMap) {
+        const std::string& name = symbolPair.second;
+        if (name.find(FUNC_LABEL_PREFIX) == 0 && name.back() != FUNC_END_LABEL_SUFFIX)
+            isFuncEntry[symbolPair.first] = true;
+    }
+
+    cycleToMicros = 1e+6 / clockFreq;
+
+    outHandle << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    pRingBuffer = new TraceRingBuffer();
+    numDropped = 0;
+    isWriterDone.store(false);
+    writerThread = std::thread(runWriter);
+    __isTracerRunning = true;
+}
+
+void stopTracer() {
+    if (!__isTracerRunning) return;
+    __isTracerRunning = false;
+
+    // wait for the writer to drain the remaining records
+    isWriterDone.store(true, std::memory_order_release);
+    writerThread.join();
+
+    // a dropped call or ret leaves its span unbalanced, so the count lets viewers of the trace know not to trust them
+    outHandle << "\n],\"otherData\":{\"droppedRecords\":" << numDropped << "}}\n";
+    outHandle.close();
+
+    delete pRingBuffer;
+    pRingBuffer = nullptr;
+}
+
+bool isTailCallTarget(u16 addr) {
+    return addr < isFuncEntry.size() && isFuncEntry[addr];
+}
+
+void traceRecord(TraceRecordType type, u64 cycle, u16 a, u16 b, u16 c, u8 code) {
+    if (!__isTracerRunning) return;
+
+    const trace_record_t record = { cycle, a, b, c, (u8)type, code };
+
+    // drop the record rather than stall the emulator until the writer catches up
+    if (!pRingBuffer->push(record))
+        ++numDropped;
+}
@@ -0,0 +1,67 @@
+#ifndef __TRACER_HPP
+#define __TRACER_HPP
+
+#include <atomic>
+#include <string>
+
+#include "util/globals.hpp"
+#include "asm_loader.hpp"
+
+/**
+ * Opt-in execution tracer that emits Chrome trace_event JSON (viewable in Perfetto or chrome://tracing).
+ *
+ * The emulator thread pushes fixed-size records into a single-producer/single-consumer ring buffer,
+ * which a background writer thread drains and formats, so the cost on the emulated clock is just a
+ * couple of atomic loads/stores per record. If the writer falls behind and the buffer fills up, records
+ * are dropped instead of stalling the emulator, and the number dropped is written to the trace's otherData.
+ *
+ * Timestamps are in virtual time (the TPU's elapsed clock cycles converted to microseconds at the
+ * configured clock frequency), so traces are independent of how fast the host actually ran.
+ */
+
+// the types of records that can be traced
+enum TraceRecordType : u8 {
+    TRACE_CALL,         // a guest function was entered (a = destination addr, b = return addr)
+    TRACE_RET,          // a guest function was returned from (a = return addr)
+    TRACE_TAIL_CALL,    // a guest function jumped to another in place of returning (a = destination addr)
+    TRACE_SYSCALL,      // a syscall was made (code = syscall code, a/b/c = syscall-specific args)
+    TRACE_COUNTER_SP,   // the stack depth has changed (a = bytes in use on the stack)
+    TRACE_COUNTER_HEAP  // the heap usage has changed (a = bytes allocated on the heap)
+};
+
+typedef struct trace_record_t {
+    u64 cycle;      // the virtual timestamp of the record
+    u16 a, b, c;    // record-specific arguments
+    u8 type;        // the TraceRecordType
+    u8 code;        // record-specific code (ex. syscall code)
+} trace_record_t;
+
+// the number of records the ring buffer can hold (must be a power of two)
+#define TRACE_BUFFER_SIZE (1u << 16)
+
+// lock-free single-producer/single-consumer ring buffer
+class TraceRingBuffer {
+    public:
+        bool push(const trace_record_t& record);
+        bool pop(trace_record_t& record);
+    private:
+        trace_record_t records[TRACE_BUFFER_SIZE];
+        alignas(64) std::atomic<size_t> head{0}; // next slot to write to (only written by producer)
+        alignas(64) std::atomic<size_t> tail{0}; // next slot to read from (only written by consumer)
+};
+
+// used to start & stop the tracer (throws std::runtime_error if the output can't be opened)
+void startTracer(const std::string& outPath, const symbol_map_t& symbols, int clockFreq);
+void stopTracer();
+
+// true if the tracer is currently recording
+extern bool __isTracerRunning;
+inline bool isTracing() { return __isTracerRunning; }
+
+// true if the address is the entry of a function compiled by TCC, so jumping to it is a tail call
+bool isTailCallTarget(u16 addr);
+
+// record an event (no-ops if the tracer isn't running)
+void traceRecord(TraceRecordType type, u64 cycle, u16 a, u16 b = 0, u16 c = 0, u8 code = 0);
+
+#endif
@@ -60,7 +60,7 @@
 #define HEAP_SIZE HEAP_UPPER_ADDR - HEAP_LOWER_ADDR + 1
 
 // clock frequency for TPU
-#define CLOCK_FREQ_HZ 5'000
+#define CLOCK_FREQ_HZ 50'000
 
 #define T_NULL 0
 
@@ -70,6 +70,7 @@
 
 #define TAB "    "
 
+typedef uint64_t  u64;
 typedef uint32_t  u32;
 typedef int32_t   s32;
 typedef uint16_t  u16;